@@ -5,8 +5,54 @@
 
 namespace vk
 {
+    enum class input_event_type_t : uint32_t
+    {
+        key,
+        character,
+        mouse_button,
+        cursor,
+        scroll,
+        resize,
+    };
+
+    /// a window event as seen by the render thread
+    /// key and mouse_button fill code, action and mods, character the code point in code,
+    /// cursor and scroll the position or offset in x and y, resize the framebuffer size in width and height
+    struct input_event_t
+    {
+        input_event_type_t      type = input_event_type_t::key;
+        int                     code = 0;
+        int                     action = 0;
+        int                     mods = 0;
+        double                  x = 0.0;
+        double                  y = 0.0;
+        uint32_t                width = 0;
+        uint32_t                height = 0;
+    };
+
+    struct run_config_t
+    {
+        uint32_t                frame_rate = 60;                            // render thread target, 0 is uncapped
+        std::chrono::milliseconds event_timeout{ 100 };                     // longest the main thread sleeps in glfwWaitEventsTimeout
+    };
+
     class application_t
     {
+        inline static constexpr size_t input_queue_size = 1024;
+        using input_queue_t = spsc_queue<input_event_t, input_queue_size>;
+
+        // reached from the glfw callbacks through the window user pointer
+        // events are dropped while the queue is full, the render thread drains it every frame
+        struct input_channel_t
+        {
+            input_queue_t               queue;
+
+            void push(input_event_t const& event) noexcept
+            {
+                queue.try_push(event);
+            }
+        };
+
     protected:
         application_t()
         {
@@ -52,6 +98,72 @@ namespace vk
             }
         }
 
+        /// the main thread sleeps in glfwWaitEventsTimeout and forwards the input through a lock-free queue
+        /// to a render thread, which calls frame(events) at the configured rate until the window closes
+        /// or frame returns false. an exception thrown by frame is rethrown here once the thread has joined.
+        template <typename Window, typename Frame>
+        void run(Window const& window, Frame&& frame, run_config_t const& config = {})
+        {
+            auto glfw_window = window.get_window();
+            auto channel = std::make_unique<input_channel_t>();
+            install_input_callbacks(glfw_window, channel.get());
+
+            std::atomic<bool> running = true;
+            std::exception_ptr error;
+
+            std::thread render_thread{ [&]()
+            {
+                using clock_t = std::chrono::steady_clock;
+                auto const period = 0 != config.frame_rate ?
+                    std::chrono::duration_cast<clock_t::duration>(std::chrono::duration<double>{ 1.0 / config.frame_rate }) :
+                    clock_t::duration::zero();
+
+                std::vector<input_event_t> events;
+                events.reserve(input_queue_size);
+                auto deadline = clock_t::now();
+
+                try
+                {
+                    while (running.load(std::memory_order_acquire))
+                    {
+                        events.clear();
+                        for (input_event_t event; channel->queue.try_pop(event);)
+                            events.push_back(event);
+
+                        if (!frame(static_cast<std::vector<input_event_t> const&>(events)))
+                            break;
+
+                        // a frame which overran its slot restarts the cadence instead of bursting to catch up
+                        deadline += period;
+                        auto const now = clock_t::now();
+                        if (deadline < now)
+                            deadline = now;
+                        else
+                            std::this_thread::sleep_until(deadline);
+                    }
+                }
+                catch (...)
+                {
+                    error = std::current_exception();
+                }
+
+                running.store(false, std::memory_order_release);
+                glfwPostEmptyEvent();
+            } };
+
+            while (running.load(std::memory_order_acquire) && !glfwWindowShouldClose(glfw_window))
+            {
+                glfwWaitEventsTimeout(std::chrono::duration<double>{ config.event_timeout }.count());
+            }
+
+            running.store(false, std::memory_order_release);
+            render_thread.join();
+            install_input_callbacks(glfw_window, nullptr);
+
+            if (error)
+                std::rethrow_exception(error);
+        }
+
     private:
         GLFWwindow* create_window_impl(size_t width, size_t height, std::string const& name) const
         {
@@ -65,5 +177,80 @@ namespace vk
 
             return window;
         }
+
+        static void install_input_callbacks(GLFWwindow* window, input_channel_t* channel)
+        {
+            glfwSetWindowUserPointer(window, channel);
+            if (nullptr == channel)
+            {
+                glfwSetKeyCallback(window, nullptr);
+                glfwSetCharCallback(window, nullptr);
+                glfwSetMouseButtonCallback(window, nullptr);
+                glfwSetCursorPosCallback(window, nullptr);
+                glfwSetScrollCallback(window, nullptr);
+                glfwSetFramebufferSizeCallback(window, nullptr);
+                return;
+            }
+
+            glfwSetKeyCallback(window, [](GLFWwindow* window, int key, int, int action, int mods)
+            {
+                input_event_t event;
+                event.type = input_event_type_t::key;
+                event.code = key;
+                event.action = action;
+                event.mods = mods;
+                get_input_channel(window)->push(event);
+            });
+
+            glfwSetCharCallback(window, [](GLFWwindow* window, unsigned int code_point)
+            {
+                input_event_t event;
+                event.type = input_event_type_t::character;
+                event.code = static_cast<int>(code_point);
+                get_input_channel(window)->push(event);
+            });
+
+            glfwSetMouseButtonCallback(window, [](GLFWwindow* window, int button, int action, int mods)
+            {
+                input_event_t event;
+                event.type = input_event_type_t::mouse_button;
+                event.code = button;
+                event.action = action;
+                event.mods = mods;
+                get_input_channel(window)->push(event);
+            });
+
+            glfwSetCursorPosCallback(window, [](GLFWwindow* window, double x, double y)
+            {
+                input_event_t event;
+                event.type = input_event_type_t::cursor;
+                event.x = x;
+                event.y = y;
+                get_input_channel(window)->push(event);
+            });
+
+            glfwSetScrollCallback(window, [](GLFWwindow* window, double x, double y)
+            {
+                input_event_t event;
+                event.type = input_event_type_t::scroll;
+                event.x = x;
+                event.y = y;
+                get_input_channel(window)->push(event);
+            });
+
+            glfwSetFramebufferSizeCallback(window, [](GLFWwindow* window, int width, int height)
+            {
+                input_event_t event;
+                event.type = input_event_type_t::resize;
+                event.width = static_cast<uint32_t>(width);
+                event.height = static_cast<uint32_t>(height);
+                get_input_channel(window)->push(event);
+            });
+        }
+
+        static input_channel_t* get_input_channel(GLFWwindow* window) noexcept
+        {
+            return static_cast<input_channel_t*>(glfwGetWindowUserPointer(window));
+        }
     };
 }
\ No newline at end of file
@@ -0,0 +1,229 @@
+#pragma once
+
+namespace vk
+{
+    /// linear scratch memory for transient create-info arrays, pNext chains and write lists
+    /// allocation bumps an offset, reset rewinds it in O(1) and keeps the blocks for the next frame.
+    /// only trivially destructible types live here, nothing is ever destroyed.
+    class frame_arena_t
+    {
+        inline static constexpr size_t default_block_size = 64 * 1024;
+
+        struct block_t
+        {
+            std::unique_ptr<std::byte[]>    memory;
+            size_t                          size = 0;
+        };
+
+    public:
+        /// a position to rewind to, for scratch memory that dies before the frame ends
+        struct marker_t
+        {
+            size_t                          block = 0;
+            size_t                          offset = 0;
+            size_t                          used = 0;
+        };
+
+        explicit frame_arena_t(size_t block_size = default_block_size)
+            : block_size_(block_size)
+        {}
+
+        frame_arena_t(frame_arena_t const&) = delete;
+        frame_arena_t& operator=(frame_arena_t const&) = delete;
+
+        void* allocate(size_t size, size_t alignment)
+        {
+            while (block_ < blocks_.size())
+            {
+                auto& block = blocks_[block_];
+                auto const address = reinterpret_cast<uintptr_t>(block.memory.get()) + offset_;
+                auto const padding = (alignment - address % alignment) % alignment;
+                if (offset_ + padding + size <= block.size)
+                {
+                    offset_ += padding + size;
+                    used_ += padding + size;
+                    return reinterpret_cast<void*>(address + padding);
+                }
+
+                // the tail of a block is wasted until the next reset
+                ++block_;
+                offset_ = 0;
+            }
+
+            blocks_.push_back({ std::make_unique<std::byte[]>(std::max(block_size_, size + alignment)), std::max(block_size_, size + alignment) });
+            return allocate(size, alignment);
+        }
+
+        /// value-initialized storage for count elements
+        template <typename T>
+        span<T> allocate_array(size_t count)
+        {
+            static_assert(std::is_trivially_destructible_v<T>, "The arena never runs destructors!");
+            if (0 == count)
+                return {};
+
+            auto values = static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+            std::uninitialized_value_construct_n(values, count);
+            return { values, count };
+        }
+
+        template <typename T, typename ... Args>
+        T& create(Args&& ... args)
+        {
+            static_assert(std::is_trivially_destructible_v<T>, "The arena never runs destructors!");
+            return *new (allocate(sizeof(T), alignof(T))) T{ std::forward<Args>(args)... };
+        }
+
+        marker_t mark() const noexcept
+        {
+            return { block_, offset_, used_ };
+        }
+
+        void rewind(marker_t marker) noexcept
+        {
+            assert(marker.block < block_ || (marker.block == block_ && marker.offset <= offset_));
+            high_water_ = std::max(high_water_, used_);
+            block_ = marker.block;
+            offset_ = marker.offset;
+            used_ = marker.used;
+        }
+
+        /// call once the frame's create calls are done, every pointer into the arena dangles afterwards
+        void reset() noexcept
+        {
+            high_water_ = std::max(high_water_, used_);
+            block_ = 0;
+            offset_ = 0;
+            used_ = 0;
+        }
+
+        /// bytes handed out since the last reset, and the most handed out in any frame
+        size_t get_used() const noexcept
+        {
+            return used_;
+        }
+
+        size_t get_high_water() const noexcept
+        {
+            return std::max(high_water_, used_);
+        }
+
+    private:
+        std::vector<block_t>            blocks_;
+        size_t                          block_size_;
+        size_t                          block_ = 0;
+        size_t                          offset_ = 0;
+        size_t                          used_ = 0;
+        size_t                          high_water_ = 0;
+    };
+
+    /// the calling thread's arena, the wrapper internals borrow it for the span of a single call
+    inline frame_arena_t& get_frame_arena()
+    {
+        thread_local frame_arena_t arena;
+        return arena;
+    }
+
+    /// rewinds the arena on destruction, for scratch memory which must not outlive the scope
+    class arena_scope_t
+    {
+    public:
+        explicit arena_scope_t(frame_arena_t& arena = get_frame_arena()) noexcept
+            : arena_(&arena)
+            , marker_(arena.mark())
+        {}
+
+        ~arena_scope_t()
+        {
+            arena_->rewind(marker_);
+        }
+
+        arena_scope_t(arena_scope_t const&) = delete;
+        arena_scope_t& operator=(arena_scope_t const&) = delete;
+
+        frame_arena_t& get_arena() const noexcept
+        {
+            return *arena_;
+        }
+
+    private:
+        frame_arena_t*                  arena_;
+        frame_arena_t::marker_t         marker_;
+    };
+
+    /// a fixed capacity array in the arena, filled with push_back
+    template <typename T>
+    class arena_array
+    {
+    public:
+        arena_array(frame_arena_t& arena, size_t capacity)
+            : storage_(arena.allocate_array<T>(capacity))
+        {}
+
+        T& push_back(T const& value) noexcept
+        {
+            assert(size_ < storage_.size());
+            return storage_[size_++] = value;
+        }
+
+        T* data() const noexcept { return storage_.data(); }
+        size_t size() const noexcept { return size_; }
+        bool empty() const noexcept { return 0 == size_; }
+        T* begin() const noexcept { return storage_.data(); }
+        T* end() const noexcept { return storage_.data() + size_; }
+
+        operator span<T>() const noexcept
+        {
+            return storage_.first(size_);
+        }
+
+        operator span<T const>() const noexcept
+        {
+            return { storage_.data(), size_ };
+        }
+
+    private:
+        span<T>                         storage_;
+        size_t                          size_ = 0;
+    };
+
+    /// builds a pNext chain out of copies in the arena, in the order the structures are added
+    class pnext_chain_t
+    {
+        struct base_t
+        {
+            VkStructureType             sType;
+            void*                       pNext;
+        };
+
+    public:
+        explicit pnext_chain_t(frame_arena_t& arena = get_frame_arena()) noexcept
+            : arena_(&arena)
+        {}
+
+        template <typename T>
+        T& add(T const& structure)
+        {
+            auto& copy = arena_->create<T>(structure);
+            auto link = reinterpret_cast<base_t*>(&copy);
+            link->pNext = nullptr;
+            if (nullptr == tail_)
+                head_ = link;
+            else
+                tail_->pNext = link;
+            tail_ = link;
+            return copy;
+        }
+
+        /// the value of the root structure's pNext
+        void* get() const noexcept
+        {
+            return head_;
+        }
+
+    private:
+        frame_arena_t*                  arena_;
+        base_t*                         head_ = nullptr;
+        base_t*                         tail_ = nullptr;
+    };
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+namespace vk
+{
+    inline void hash_combine(size_t& seed, size_t value) noexcept
+    {
+        seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    }
+
+    template <typename T>
+    inline void hash_value(size_t& seed, T const& value) noexcept
+    {
+        if constexpr (std::is_enum_v<T>)
+            hash_combine(seed, std::hash<std::underlying_type_t<T>>{}(static_cast<std::underlying_type_t<T>>(value)));
+        else
+            hash_combine(seed, std::hash<T>{}(value));
+    }
+
+    template <typename ... Ts>
+    inline size_t hash_values(Ts const& ... values) noexcept
+    {
+        size_t seed = 0;
+        swallow_t{ (hash_value(seed, values), 0)... };
+        return seed;
+    }
+
+    template <typename Rng, typename F>
+    inline void hash_range(size_t& seed, Rng const& rng, F&& f) noexcept
+    {
+        hash_combine(seed, std::size(rng));
+        for (auto const& value : rng)
+            hash_combine(seed, f(value));
+    }
+}
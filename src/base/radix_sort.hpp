@@ -0,0 +1,101 @@
+#pragma once
+
+namespace vk
+{
+    struct sort_item_t
+    {
+        uint64_t                key;
+        uint32_t                value;
+    };
+
+    namespace detail
+    {
+        // stable lsd radix sort on the bits below `bits`, digits shared by every key are skipped
+        inline void lsd_radix_sort(sort_item_t* items, sort_item_t* scratch, size_t count, uint32_t bits)
+        {
+            auto src = items;
+            auto dst = scratch;
+            for (uint32_t shift = 0; shift < bits; shift += 8)
+            {
+                std::array<size_t, 256> histogram = {};
+                for (size_t i = 0; i < count; ++i)
+                    ++histogram[(src[i].key >> shift) & 0xff];
+
+                if (std::any_of(histogram.cbegin(), histogram.cend(), [count](auto n) { return n == count; }))
+                    continue;
+
+                size_t offset = 0;
+                for (auto& n : histogram)
+                    offset += std::exchange(n, offset);
+
+                for (size_t i = 0; i < count; ++i)
+                    dst[histogram[(src[i].key >> shift) & 0xff]++] = src[i];
+
+                std::swap(src, dst);
+            }
+
+            if (src != items)
+                std::copy(src, src + count, items);
+        }
+    }
+
+    /// stable radix sort of 64-bit keys
+    /// one msd pass on the highest byte in which the keys differ, then the buckets are sorted
+    /// independently by lsd passes spread over the threads of the pool. the pool outlives the
+    /// call, so sorting every frame starts no threads. without a pool the sort runs inline.
+    inline void parallel_radix_sort(std::vector<sort_item_t>& items, std::vector<sort_item_t>& scratch,
+        worker_pool_t* pool = nullptr)
+    {
+        constexpr size_t parallel_threshold = 4096;
+
+        auto const count = items.size();
+        scratch.resize(count);
+        if (count < 2)
+            return;
+
+        if (count < parallel_threshold || nullptr == pool || pool->get_thread_count() < 2)
+        {
+            detail::lsd_radix_sort(items.data(), scratch.data(), count, 64);
+            return;
+        }
+
+        uint64_t differing = 0;
+        for (auto const& item : items)
+            differing |= item.key ^ items.front().key;
+
+        if (0 == differing)
+            return;
+
+        uint32_t high_bit = 63;
+        while (0 == (differing >> high_bit))
+            --high_bit;
+
+        auto const shift = high_bit >= 7 ? high_bit - 7 : 0;
+
+        std::array<size_t, 257> offsets = {};
+        for (auto const& item : items)
+            ++offsets[((item.key >> shift) & 0xff) + 1];
+        for (size_t i = 1; i < offsets.size(); ++i)
+            offsets[i] += offsets[i - 1];
+
+        auto cursor = offsets;
+        for (auto const& item : items)
+            scratch[cursor[(item.key >> shift) & 0xff]++] = item;
+        items.swap(scratch);
+
+        if (0 == shift)
+            return;
+
+        std::atomic<uint32_t> next_bucket{ 0 };
+        pool->run([&]()
+        {
+            for (auto bucket = next_bucket++; bucket < 256; bucket = next_bucket++)
+            {
+                auto const first = offsets[bucket];
+                auto const size = offsets[bucket + 1] - first;
+                if (size > 1)
+                    detail::lsd_radix_sort(items.data() + first, scratch.data() + first, size, shift);
+            }
+        });
+    }
+}
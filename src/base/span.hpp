@@ -0,0 +1,76 @@
+#pragma once
+
+namespace vk
+{
+    /// a non-owning view over contiguous caller-provided storage
+    template <typename T>
+    class span
+    {
+    public:
+        using element_type = T;
+        using value_type = std::remove_cv_t<T>;
+        using iterator = T*;
+
+        constexpr span() noexcept = default;
+
+        constexpr span(T* data, size_t size) noexcept
+            : data_(data)
+            , size_(size)
+        {}
+
+        template <size_t N>
+        constexpr span(T (&values)[N]) noexcept
+            : span(values, N)
+        {}
+
+        template <size_t N>
+        constexpr span(std::array<value_type, N>& values) noexcept
+            : span(values.data(), N)
+        {}
+
+        template <size_t N, typename U = T, typename = std::enable_if_t<std::is_const_v<U>>>
+        constexpr span(std::array<value_type, N> const& values) noexcept
+            : span(values.data(), N)
+        {}
+
+        span(std::vector<value_type>& values) noexcept
+            : span(values.data(), values.size())
+        {}
+
+        template <typename U = T, typename = std::enable_if_t<std::is_const_v<U>>>
+        span(std::vector<value_type> const& values) noexcept
+            : span(values.data(), values.size())
+        {}
+
+        constexpr T* data() const noexcept { return data_; }
+        constexpr size_t size() const noexcept { return size_; }
+        constexpr bool empty() const noexcept { return 0 == size_; }
+        constexpr T* begin() const noexcept { return data_; }
+        constexpr T* end() const noexcept { return data_ + size_; }
+
+        constexpr T& operator[](size_t index) const noexcept
+        {
+            assert(index < size_);
+            return data_[index];
+        }
+
+        constexpr span first(size_t count) const noexcept
+        {
+            assert(count <= size_);
+            return { data_, count };
+        }
+
+    private:
+        T*                  data_ = nullptr;
+        size_t              size_ = 0;
+    };
+
+    /// the part of caller-provided storage a query filled, complete is false when the storage
+    /// was too small and the query had more to write (VK_INCOMPLETE)
+    template <typename T>
+    struct fill_result
+    {
+        span<T>             values;
+        bool                complete = true;
+    };
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+namespace vk
+{
+    /// bounded lock-free queue for one producer thread and one consumer thread
+    /// the indices grow without wrapping, Capacity must be a power of two
+    template <typename T, size_t Capacity>
+    class spsc_queue
+    {
+        static_assert(Capacity > 0 && 0 == (Capacity & (Capacity - 1)), "Capacity must be a power of two!");
+
+        inline static constexpr size_t cache_line_size = 64;
+
+    public:
+        spsc_queue() = default;
+        spsc_queue(spsc_queue const&) = delete;
+        spsc_queue& operator=(spsc_queue const&) = delete;
+
+        /// producer side, false when the queue is full
+        bool try_push(T const& value) noexcept(std::is_nothrow_copy_assignable_v<T>)
+        {
+            auto const tail = tail_.load(std::memory_order_relaxed);
+            if (tail - head_cache_ == Capacity)
+            {
+                head_cache_ = head_.load(std::memory_order_acquire);
+                if (tail - head_cache_ == Capacity)
+                    return false;
+            }
+
+            items_[tail & (Capacity - 1)] = value;
+            tail_.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        /// consumer side, false when the queue is empty
+        bool try_pop(T& value) noexcept(std::is_nothrow_copy_assignable_v<T>)
+        {
+            auto const head = head_.load(std::memory_order_relaxed);
+            if (head == tail_cache_)
+            {
+                tail_cache_ = tail_.load(std::memory_order_acquire);
+                if (head == tail_cache_)
+                    return false;
+            }
+
+            value = items_[head & (Capacity - 1)];
+            head_.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        /// approximate when called while the other side is running
+        size_t size() const noexcept
+        {
+            return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+        }
+
+        bool empty() const noexcept
+        {
+            return 0 == size();
+        }
+
+        static constexpr size_t capacity() noexcept
+        {
+            return Capacity;
+        }
+
+    private:
+        // producer and consumer state live on separate cache lines
+        alignas(cache_line_size) std::atomic<size_t>    tail_ = 0;
+        size_t                                          head_cache_ = 0;
+        alignas(cache_line_size) std::atomic<size_t>    head_ = 0;
+        size_t                                          tail_cache_ = 0;
+        alignas(cache_line_size) std::array<T, Capacity> items_ = {};
+    };
+}
@@ -0,0 +1,225 @@
+#pragma once
+
+#ifdef VULKANCPP_ENABLE_TRACE
+
+namespace vk { namespace trace
+{
+    struct call_statistics_t
+    {
+        std::string             name;
+        uint64_t                calls = 0;
+        uint64_t                total_ns = 0;
+    };
+
+    namespace detail
+    {
+        inline constexpr uint32_t max_functions = 1024;
+        inline constexpr size_t max_events = 1 << 16;
+
+        using clock_t = std::chrono::steady_clock;
+
+        struct event_t
+        {
+            uint32_t                function;
+            uint64_t                begin_ns;
+            uint64_t                duration_ns;
+        };
+
+        // written by its own thread only, published to the exporter through the atomic counters
+        struct thread_buffer_t
+        {
+            uint32_t                                        thread_id = 0;
+            std::array<std::atomic<uint64_t>, max_functions> calls = {};
+            std::array<std::atomic<uint64_t>, max_functions> total_ns = {};
+            std::unique_ptr<event_t[]>                      events = std::make_unique<event_t[]>(max_events);
+            std::atomic<size_t>                             event_count = 0;
+        };
+
+        struct registry_t
+        {
+            std::mutex                                      mutex;
+            std::vector<std::string>                        functions;
+            std::vector<std::shared_ptr<thread_buffer_t>>   threads;
+            clock_t::time_point                             epoch = clock_t::now();
+        };
+
+        inline registry_t& get_registry()
+        {
+            static registry_t registry;
+            return registry;
+        }
+
+        inline uint32_t register_function(char const* name)
+        {
+            auto& registry = get_registry();
+            std::lock_guard<std::mutex> lock{ registry.mutex };
+            auto itr = std::find(registry.functions.cbegin(), registry.functions.cend(), name);
+            if (itr != registry.functions.cend())
+                return static_cast<uint32_t>(std::distance(registry.functions.cbegin(), itr));
+
+            if (registry.functions.size() >= max_functions)
+                throw std::runtime_error{ "Too many traced functions!" };
+
+            registry.functions.emplace_back(name);
+            return static_cast<uint32_t>(registry.functions.size() - 1);
+        }
+
+        // the registry keeps the buffer alive after its thread exits so that its calls can still be exported
+        inline thread_buffer_t& get_thread_buffer()
+        {
+            thread_local thread_buffer_t* buffer = []()
+            {
+                auto& registry = get_registry();
+                std::lock_guard<std::mutex> lock{ registry.mutex };
+                auto owned = std::make_shared<thread_buffer_t>();
+                owned->thread_id = static_cast<uint32_t>(registry.threads.size());
+                registry.threads.push_back(owned);
+                return owned.get();
+            }();
+            return *buffer;
+        }
+
+        inline uint64_t now_ns() noexcept
+        {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                clock_t::now() - get_registry().epoch).count());
+        }
+
+        class call_scope_t
+        {
+        public:
+            explicit call_scope_t(uint32_t function) noexcept
+                : function_(function)
+                , begin_ns_(now_ns())
+            {}
+
+            ~call_scope_t()
+            {
+                auto const duration = now_ns() - begin_ns_;
+                auto& buffer = get_thread_buffer();
+                buffer.calls[function_].store(buffer.calls[function_].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                buffer.total_ns[function_].store(buffer.total_ns[function_].load(std::memory_order_relaxed) + duration, std::memory_order_relaxed);
+
+                // the timeline stops when the buffer is full, the counters keep going
+                auto const count = buffer.event_count.load(std::memory_order_relaxed);
+                if (count < max_events)
+                {
+                    buffer.events[count] = { function_, begin_ns_, duration };
+                    buffer.event_count.store(count + 1, std::memory_order_release);
+                }
+            }
+
+            call_scope_t(call_scope_t const&) = delete;
+            call_scope_t& operator=(call_scope_t const&) = delete;
+
+        private:
+            uint32_t                function_;
+            uint64_t                begin_ns_;
+        };
+
+        // one instantiation per loaded entry point, Tag makes it unique even when two PFN types match
+        template <typename Tag, typename PFN_type>
+        struct trampoline;
+
+        template <typename Tag, typename R, typename ... Args>
+        struct trampoline<Tag, R (VKAPI_PTR*)(Args...)>
+        {
+            inline static R (VKAPI_PTR* target)(Args...) = nullptr;
+            inline static uint32_t function = 0;
+
+            static R VKAPI_PTR call(Args... args)
+            {
+                call_scope_t scope{ function };
+                return target(args...);
+            }
+        };
+    }
+
+    /// route a loaded entry point through its trampoline
+    /// a load site has one trampoline, so every instance or device it loads for has to get the same
+    /// entry point. throws when a second one resolves to a different address, which would be lost.
+    template <typename PFN_type, typename Tag>
+    void instrument(PFN_type& function, char const* name, Tag)
+    {
+        using trampoline_t = detail::trampoline<Tag, PFN_type>;
+        if (nullptr == function || &trampoline_t::call == function)
+            return;
+
+        if (nullptr != trampoline_t::target && function != trampoline_t::target)
+            throw std::runtime_error{ "A traced entry point was loaded with two different addresses!" };
+
+        trampoline_t::target = function;
+        trampoline_t::function = detail::register_function(name);
+        function = &trampoline_t::call;
+    }
+
+    /// calls and time per entry point, summed over every thread
+    inline std::vector<call_statistics_t> get_statistics()
+    {
+        auto& registry = detail::get_registry();
+        std::lock_guard<std::mutex> lock{ registry.mutex };
+
+        std::vector<call_statistics_t> statistics(registry.functions.size());
+        for (size_t i = 0; i < statistics.size(); ++i)
+        {
+            statistics[i].name = registry.functions[i];
+            for (auto const& thread : registry.threads)
+            {
+                statistics[i].calls += thread->calls[i].load(std::memory_order_relaxed);
+                statistics[i].total_ns += thread->total_ns[i].load(std::memory_order_relaxed);
+            }
+        }
+        return statistics;
+    }
+
+    /// the recorded calls as a chrome://tracing / Perfetto JSON document
+    inline std::string export_chrome_trace()
+    {
+        auto& registry = detail::get_registry();
+        std::lock_guard<std::mutex> lock{ registry.mutex };
+
+        std::string json = "{\"traceEvents\":[";
+        bool first = true;
+        for (auto const& thread : registry.threads)
+        {
+            auto const count = thread->event_count.load(std::memory_order_acquire);
+            for (size_t i = 0; i < count; ++i)
+            {
+                auto const& event = thread->events[i];
+                json += first ? "\n" : ",\n";
+                json += "{\"name\":\"" + registry.functions[event.function] + "\",\"cat\":\"vulkan\",\"ph\":\"X\",\"pid\":0,\"tid\":";
+                json += std::to_string(thread->thread_id);
+                json += ",\"ts\":" + std::to_string(event.begin_ns / 1000) + "." + std::to_string(1000 + event.begin_ns % 1000).substr(1);
+                json += ",\"dur\":" + std::to_string(event.duration_ns / 1000) + "." + std::to_string(1000 + event.duration_ns % 1000).substr(1);
+                json += "}";
+                first = false;
+            }
+        }
+        json += "\n]}\n";
+        return json;
+    }
+
+    /// drop the timelines and counters, only while no traced call is in progress
+    inline void clear()
+    {
+        auto& registry = detail::get_registry();
+        std::lock_guard<std::mutex> lock{ registry.mutex };
+        for (auto const& thread : registry.threads)
+        {
+            thread->event_count.store(0, std::memory_order_release);
+            for (uint32_t i = 0; i < detail::max_functions; ++i)
+            {
+                thread->calls[i].store(0, std::memory_order_relaxed);
+                thread->total_ns[i].store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+} }
+
+#define VULKAN_TRACE_FUNCTION(name) ::vk::trace::instrument(name, VULKAN_STR2(name), [] {})
+
+#else
+
+#define VULKAN_TRACE_FUNCTION(name) static_cast<void>(0)
+
+#endif
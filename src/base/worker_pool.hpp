@@ -0,0 +1,95 @@
+#pragma once
+
+namespace vk
+{
+    /// persistent worker threads for the per frame parallel work, e.g. parallel_radix_sort
+    /// run() hands one job to every worker and to the calling thread and returns once all of them
+    /// returned. the job splits the work itself, e.g. with an atomic counter, and must not throw.
+    class worker_pool_t
+    {
+    public:
+        /// thread_count includes the calling thread, one thread runs every job inline
+        explicit worker_pool_t(uint32_t thread_count = std::thread::hardware_concurrency())
+        {
+            auto const workers = std::max(thread_count, 1u) - 1;
+            threads_.reserve(workers);
+            for (uint32_t i = 0; i < workers; ++i)
+                threads_.emplace_back([this]() { work(); });
+        }
+
+        ~worker_pool_t()
+        {
+            {
+                std::lock_guard<std::mutex> lock{ mutex_ };
+                stop_ = true;
+            }
+            start_.notify_all();
+            for (auto& thread : threads_)
+                thread.join();
+        }
+
+        worker_pool_t(worker_pool_t const&) = delete;
+        worker_pool_t& operator=(worker_pool_t const&) = delete;
+
+        uint32_t get_thread_count() const noexcept
+        {
+            return static_cast<uint32_t>(threads_.size()) + 1;
+        }
+
+        /// one caller at a time
+        void run(std::function<void()> const& job)
+        {
+            if (threads_.empty())
+                return job();
+
+            {
+                std::lock_guard<std::mutex> lock{ mutex_ };
+                job_ = &job;
+                running_ = static_cast<uint32_t>(threads_.size());
+                ++generation_;
+            }
+            start_.notify_all();
+
+            job();
+
+            std::unique_lock<std::mutex> lock{ mutex_ };
+            done_.wait(lock, [this]() { return 0 == running_; });
+            job_ = nullptr;
+        }
+
+    private:
+        void work()
+        {
+            uint64_t generation = 0;
+            for (;;)
+            {
+                std::function<void()> const* job = nullptr;
+                {
+                    std::unique_lock<std::mutex> lock{ mutex_ };
+                    start_.wait(lock, [this, generation]() { return stop_ || generation != generation_; });
+                    if (stop_)
+                        return;
+
+                    generation = generation_;
+                    job = job_;
+                }
+
+                (*job)();
+
+                std::lock_guard<std::mutex> lock{ mutex_ };
+                if (0 == --running_)
+                    done_.notify_one();
+            }
+        }
+
+    private:
+        std::vector<std::thread>        threads_;
+        std::mutex                      mutex_;
+        std::condition_variable         start_;
+        std::condition_variable         done_;
+        std::function<void()> const*    job_ = nullptr;
+        uint64_t                        generation_ = 0;
+        uint32_t                        running_ = 0;
+        bool                            stop_ = false;
+    };
+}
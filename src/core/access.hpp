@@ -0,0 +1,207 @@
+#pragma once
+
+namespace vk
+{
+    /// the ways a pass or a command may use a buffer or an image
+    enum class access_t : uint32_t
+    {
+        none,
+        vertex_buffer,
+        index_buffer,
+        indirect_buffer,
+        uniform_buffer,
+        vertex_shader_read,
+        fragment_shader_read,
+        compute_shader_read,
+        compute_shader_write,
+        color_attachment_write,
+        depth_attachment_write,
+        depth_attachment_read,
+        transfer_read,
+        transfer_write,
+        host_read,
+        host_write,
+        present,
+    };
+
+    struct access_info_t
+    {
+        VkPipelineStageFlags        stages;
+        VkAccessFlags               access;
+        VkImageLayout               layout;
+        bool                        write;
+        VkImageUsageFlags           image_usage;
+        VkBufferUsageFlags          buffer_usage;
+    };
+
+    inline access_info_t const& get_access_info(access_t access) noexcept
+    {
+        static access_info_t const infos[] =
+        {
+            // none
+            { VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, 0, VK_IMAGE_LAYOUT_UNDEFINED, false, 0, 0 },
+            // vertex_buffer
+            { VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT, VK_IMAGE_LAYOUT_UNDEFINED, false,
+                0, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT },
+            // index_buffer
+            { VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_INDEX_READ_BIT, VK_IMAGE_LAYOUT_UNDEFINED, false,
+                0, VK_BUFFER_USAGE_INDEX_BUFFER_BIT },
+            // indirect_buffer
+            { VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT, VK_IMAGE_LAYOUT_UNDEFINED, false,
+                0, VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT },
+            // uniform_buffer
+            { VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                VK_ACCESS_UNIFORM_READ_BIT, VK_IMAGE_LAYOUT_UNDEFINED, false, 0, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT },
+            // vertex_shader_read
+            { VK_PIPELINE_STAGE_VERTEX_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, false,
+                VK_IMAGE_USAGE_SAMPLED_BIT, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT },
+            // fragment_shader_read
+            { VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, false,
+                VK_IMAGE_USAGE_SAMPLED_BIT, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT },
+            // compute_shader_read
+            { VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, false,
+                VK_IMAGE_USAGE_SAMPLED_BIT, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT },
+            // compute_shader_write
+            { VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL, true,
+                VK_IMAGE_USAGE_STORAGE_BIT, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT },
+            // color_attachment_write
+            { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, true, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, 0 },
+            // depth_attachment_write
+            { VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, true, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, 0 },
+            // depth_attachment_read
+            { VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, false,
+                VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, 0 },
+            // transfer_read
+            { VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, false,
+                VK_IMAGE_USAGE_TRANSFER_SRC_BIT, VK_BUFFER_USAGE_TRANSFER_SRC_BIT },
+            // transfer_write
+            { VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, true,
+                VK_IMAGE_USAGE_TRANSFER_DST_BIT, VK_BUFFER_USAGE_TRANSFER_DST_BIT },
+            // host_read
+            { VK_PIPELINE_STAGE_HOST_BIT, VK_ACCESS_HOST_READ_BIT, VK_IMAGE_LAYOUT_GENERAL, false, 0, 0 },
+            // host_write
+            { VK_PIPELINE_STAGE_HOST_BIT, VK_ACCESS_HOST_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL, true, 0, 0 },
+            // present
+            { VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, false, 0, 0 },
+        };
+
+        return infos[static_cast<uint32_t>(access)];
+    }
+
+    inline constexpr VkAccessFlags write_access_mask =
+        VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT |
+        VK_ACCESS_HOST_WRITE_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+
+    /// synchronization state of a buffer or an image subresource
+    struct access_state_t
+    {
+        VkPipelineStageFlags        write_stages = 0;
+        VkAccessFlags               write_access = 0;
+        VkPipelineStageFlags        read_stages = 0;
+        VkPipelineStageFlags        visible_stages = 0;     // read stages which already waited for the last write
+        VkImageLayout               layout = VK_IMAGE_LAYOUT_UNDEFINED;
+    };
+
+    struct access_dependency_t
+    {
+        bool                        needed = false;
+        bool                        layout_change = false;
+        VkPipelineStageFlags        src_stages = 0;
+        VkAccessFlags               src_access = 0;
+        VkImageLayout               old_layout = VK_IMAGE_LAYOUT_UNDEFINED;
+    };
+
+    inline access_state_t make_access_state(access_t access) noexcept
+    {
+        auto const& info = get_access_info(access);
+        access_state_t state;
+        state.layout = info.layout;
+        if (info.write)
+        {
+            state.write_stages = info.stages;
+            state.write_access = info.access & write_access_mask;
+        }
+        else if (access_t::none != access)
+        {
+            state.read_stages = info.stages;
+        }
+        return state;
+    }
+
+    /// move the state to the required access and return the dependency the move needs
+    inline access_dependency_t update_access_state(access_state_t& state, access_info_t const& required, bool is_image) noexcept
+    {
+        access_dependency_t dependency;
+        dependency.old_layout = state.layout;
+        dependency.layout_change = is_image && state.layout != required.layout;
+        dependency.src_access = state.write_access;
+
+        if (required.write)
+        {
+            // write after write and write after read
+            dependency.needed = dependency.layout_change || 0 != state.write_stages || 0 != state.read_stages;
+            dependency.src_stages = state.write_stages | state.read_stages;
+
+            state.write_stages = required.stages;
+            state.write_access = required.access & write_access_mask;
+            state.read_stages = 0;
+            state.visible_stages = 0;
+        }
+        else
+        {
+            // read after write, unless the stages already waited for the write
+            bool const hazard = 0 != state.write_stages && 0 != (required.stages & ~state.visible_stages);
+            dependency.needed = dependency.layout_change || hazard;
+            dependency.src_stages = state.write_stages | (dependency.layout_change ? state.read_stages : 0);
+
+            if (dependency.needed)
+                state.visible_stages |= required.stages;
+            state.read_stages |= required.stages;
+        }
+
+        if (is_image)
+            state.layout = required.layout;
+
+        if (0 == dependency.src_stages)
+            dependency.src_stages = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+        return dependency;
+    }
+
+    inline bool is_depth_format(VkFormat format) noexcept
+    {
+        switch (format)
+        {
+        case VK_FORMAT_D16_UNORM:
+        case VK_FORMAT_X8_D24_UNORM_PACK32:
+        case VK_FORMAT_D32_SFLOAT:
+        case VK_FORMAT_D16_UNORM_S8_UINT:
+        case VK_FORMAT_D24_UNORM_S8_UINT:
+        case VK_FORMAT_D32_SFLOAT_S8_UINT:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    inline bool has_stencil_component(VkFormat format) noexcept
+    {
+        return format == VK_FORMAT_S8_UINT ||
+            format == VK_FORMAT_D16_UNORM_S8_UINT ||
+            format == VK_FORMAT_D24_UNORM_S8_UINT ||
+            format == VK_FORMAT_D32_SFLOAT_S8_UINT;
+    }
+
+    inline VkImageAspectFlags get_image_aspect(VkFormat format) noexcept
+    {
+        if (!is_depth_format(format))
+            return format == VK_FORMAT_S8_UINT ? VK_IMAGE_ASPECT_STENCIL_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
+
+        return has_stencil_component(format) ?
+            VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT : VK_IMAGE_ASPECT_DEPTH_BIT;
+    }
+}
@@ -0,0 +1,246 @@
+#pragma once
+
+namespace vk
+{
+    enum class layout_rule_t
+    {
+        std140,     // uniform buffers
+        std430,     // storage buffers and push constants
+    };
+
+    /// field types of a shader block, the values written to it use the same types
+    namespace glsl
+    {
+        template <typename T, uint32_t N>
+        struct vec
+        {
+            T                           data[N];
+        };
+
+        /// column major like GLSL, data[column][row]
+        template <typename T, uint32_t Columns, uint32_t Rows>
+        struct mat
+        {
+            T                           data[Columns][Rows];
+        };
+
+        template <typename T, uint32_t N>
+        struct array;
+
+        /// a nested struct, laid out with the rule of the enclosing block
+        template <typename ... Fields>
+        struct block;
+
+        using vec2 = vec<float, 2>;
+        using vec3 = vec<float, 3>;
+        using vec4 = vec<float, 4>;
+        using ivec2 = vec<int32_t, 2>;
+        using ivec3 = vec<int32_t, 3>;
+        using ivec4 = vec<int32_t, 4>;
+        using uvec2 = vec<uint32_t, 2>;
+        using uvec3 = vec<uint32_t, 3>;
+        using uvec4 = vec<uint32_t, 4>;
+        using mat2 = mat<float, 2, 2>;
+        using mat3 = mat<float, 3, 3>;
+        using mat4 = mat<float, 4, 4>;
+    }
+
+    namespace detail
+    {
+        constexpr uint32_t align_up(uint32_t value, uint32_t alignment) noexcept
+        {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+
+        template <typename T>
+        inline constexpr bool is_layout_scalar_v = std::is_same_v<T, float> || std::is_same_v<T, double> ||
+            std::is_same_v<T, int32_t> || std::is_same_v<T, uint32_t>;
+
+        /// alignment, size and the value written for every field type
+        template <layout_rule_t Rule, typename T>
+        struct field_layout
+        {
+            static_assert(is_layout_scalar_v<T>, "Not a shader block field type!");
+
+            using value_type = T;
+            inline static constexpr uint32_t alignment = sizeof(T);
+            inline static constexpr uint32_t size = sizeof(T);
+
+            static void write(std::byte* destination, value_type const& value) noexcept
+            {
+                std::memcpy(destination, &value, sizeof(T));
+            }
+        };
+
+        template <layout_rule_t Rule, typename T, uint32_t N>
+        struct field_layout<Rule, glsl::vec<T, N>>
+        {
+            static_assert(is_layout_scalar_v<T> && N >= 2 && N <= 4, "Not a shader block field type!");
+
+            using value_type = glsl::vec<T, N>;
+            inline static constexpr uint32_t alignment = (2 == N ? 2 : 4) * sizeof(T);
+            inline static constexpr uint32_t size = N * sizeof(T);
+
+            static void write(std::byte* destination, value_type const& value) noexcept
+            {
+                std::memcpy(destination, value.data, size);
+            }
+        };
+
+        // an array element is padded to its stride, std140 rounds the stride up to a vec4
+        template <layout_rule_t Rule, typename T>
+        inline constexpr uint32_t array_stride_v = Rule == layout_rule_t::std140 ?
+            align_up(align_up(field_layout<Rule, T>::size, field_layout<Rule, T>::alignment), 16) :
+            align_up(field_layout<Rule, T>::size, field_layout<Rule, T>::alignment);
+
+        template <layout_rule_t Rule, typename T>
+        inline constexpr uint32_t array_alignment_v = Rule == layout_rule_t::std140 ?
+            std::max(field_layout<Rule, T>::alignment, 16u) : field_layout<Rule, T>::alignment;
+
+        // a matrix is an array of its column vectors
+        template <layout_rule_t Rule, typename T, uint32_t Columns, uint32_t Rows>
+        struct field_layout<Rule, glsl::mat<T, Columns, Rows>>
+        {
+            using column_t = glsl::vec<T, Rows>;
+            using value_type = glsl::mat<T, Columns, Rows>;
+            inline static constexpr uint32_t stride = array_stride_v<Rule, column_t>;
+            inline static constexpr uint32_t alignment = array_alignment_v<Rule, column_t>;
+            inline static constexpr uint32_t size = stride * Columns;
+
+            static void write(std::byte* destination, value_type const& value) noexcept
+            {
+                for (uint32_t i = 0; i < Columns; ++i)
+                    std::memcpy(destination + i * stride, value.data[i], sizeof(T) * Rows);
+            }
+        };
+
+        template <layout_rule_t Rule, typename T, uint32_t N>
+        struct field_layout<Rule, glsl::array<T, N>>
+        {
+            using value_type = std::array<typename field_layout<Rule, T>::value_type, N>;
+            inline static constexpr uint32_t stride = array_stride_v<Rule, T>;
+            inline static constexpr uint32_t alignment = array_alignment_v<Rule, T>;
+            inline static constexpr uint32_t size = stride * N;
+
+            static void write(std::byte* destination, value_type const& value) noexcept
+            {
+                for (uint32_t i = 0; i < N; ++i)
+                    field_layout<Rule, T>::write(destination + i * stride, value[i]);
+            }
+        };
+
+        template <layout_rule_t Rule, typename ... Fields>
+        struct struct_layout
+        {
+            inline static constexpr size_t field_count = sizeof...(Fields);
+
+            inline static constexpr std::array<uint32_t, field_count> offsets = []()
+            {
+                std::array<uint32_t, field_count> result = {};
+                uint32_t const alignments[] = { field_layout<Rule, Fields>::alignment ... };
+                uint32_t const sizes[] = { field_layout<Rule, Fields>::size ... };
+                uint32_t offset = 0;
+                for (size_t i = 0; i < field_count; ++i)
+                {
+                    result[i] = align_up(offset, alignments[i]);
+                    offset = result[i] + sizes[i];
+                }
+                return result;
+            }();
+
+            inline static constexpr uint32_t alignment = Rule == layout_rule_t::std140 ?
+                std::max({ 16u, field_layout<Rule, Fields>::alignment ... }) :
+                std::max({ 1u, field_layout<Rule, Fields>::alignment ... });
+
+            inline static constexpr uint32_t size = []()
+            {
+                uint32_t const sizes[] = { field_layout<Rule, Fields>::size ... };
+                return align_up(offsets[field_count - 1] + sizes[field_count - 1], alignment);
+            }();
+        };
+
+        template <layout_rule_t Rule, typename ... Fields>
+        struct field_layout<Rule, glsl::block<Fields...>>
+        {
+            using layout_t = struct_layout<Rule, Fields...>;
+            using value_type = std::tuple<typename field_layout<Rule, Fields>::value_type ...>;
+            inline static constexpr uint32_t alignment = layout_t::alignment;
+            inline static constexpr uint32_t size = layout_t::size;
+
+            static void write(std::byte* destination, value_type const& value) noexcept
+            {
+                write(destination, value, std::index_sequence_for<Fields...>{});
+            }
+
+            template <size_t ... I>
+            static void write(std::byte* destination, value_type const& value, std::index_sequence<I...>) noexcept
+            {
+                (field_layout<Rule, Fields>::write(destination + layout_t::offsets[I], std::get<I>(value)), ...);
+            }
+        };
+    }
+
+    /// offsets, padding and size of a shader block derived at compile time from its field types
+    /// the values are packed straight into the destination, typically mapped memory or a push constant range
+    template <layout_rule_t Rule, typename ... Fields>
+    struct block_layout
+    {
+        static_assert(sizeof...(Fields) > 0, "A block needs at least one field!");
+
+        using layout_t = detail::struct_layout<Rule, Fields...>;
+        using value_type = std::tuple<typename detail::field_layout<Rule, Fields>::value_type ...>;
+
+        inline static constexpr layout_rule_t rule = Rule;
+        inline static constexpr auto offsets = layout_t::offsets;
+        inline static constexpr uint32_t alignment = layout_t::alignment;
+        inline static constexpr uint32_t size = layout_t::size;
+
+        template <size_t I>
+        inline static constexpr uint32_t offset = offsets[I];
+
+        template <size_t I>
+        using field_t = std::tuple_element_t<I, std::tuple<Fields...>>;
+
+        /// the destination has to hold size bytes, padding bytes are left untouched
+        static void write(void* destination, typename detail::field_layout<Rule, Fields>::value_type const& ... values) noexcept
+        {
+            write_fields(static_cast<std::byte*>(destination), std::index_sequence_for<Fields...>{}, values...);
+        }
+
+        template <size_t I>
+        static void write_field(void* destination, typename detail::field_layout<Rule, field_t<I>>::value_type const& value) noexcept
+        {
+            detail::field_layout<Rule, field_t<I>>::write(static_cast<std::byte*>(destination) + offset<I>, value);
+        }
+
+    private:
+        template <size_t ... I, typename ... Values>
+        static void write_fields(std::byte* destination, std::index_sequence<I...>, Values const& ... values) noexcept
+        {
+            (detail::field_layout<Rule, Fields>::write(destination + offsets[I], values), ...);
+        }
+    };
+
+    template <typename ... Fields>
+    using std140_block = block_layout<layout_rule_t::std140, Fields...>;
+
+    template <typename ... Fields>
+    using std430_block = block_layout<layout_rule_t::std430, Fields...>;
+
+    /// every device supports at least this many bytes of push constants
+    inline constexpr uint32_t min_max_push_constants_size = 128;
+
+    /// throws when the block does not fit the device's push constant range
+    template <typename Block>
+    void validate_push_constants(physical_device_properties_t const& properties, uint32_t offset = 0)
+    {
+        if (offset + Block::size > properties.limits.maxPushConstantsSize)
+            throw std::runtime_error{ "The push constant block exceeds maxPushConstantsSize!" };
+    }
+
+    template <typename Block, typename Device>
+    void validate_push_constants(Device const& device, uint32_t offset = 0)
+    {
+        validate_push_constants<Block>(device.get_physical_device_properties(), offset);
+    }
+}
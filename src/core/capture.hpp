@@ -0,0 +1,1150 @@
+#pragma once
+
+namespace vk
+{
+    /// the commands of a capture stream, one byte each followed by the arguments
+    enum class capture_op_t : uint8_t
+    {
+        bind_pipeline,
+        bind_descriptor_sets,
+        bind_vertex_buffers,
+        bind_index_buffer,
+        set_viewport,
+        set_scissor,
+        push_constants,
+        draw,
+        draw_indexed,
+        dispatch,
+        copy_buffer,
+        copy_image,
+        copy_buffer_to_image,
+        copy_image_to_buffer,
+        begin_render_pass,
+        end_render_pass,
+        execute_commands,
+        reset_query_pool,
+        write_timestamp,
+        draw_indexed_indirect,
+        fill_buffer,
+        push_descriptor_set,
+        begin_rendering,
+        end_rendering,
+        pipeline_barrier,
+        draw_indexed_indirect_count,
+    };
+
+    inline constexpr uint32_t capture_magic = 0x53434b56;      // "VKCS"
+    inline constexpr uint32_t capture_version = 1;
+
+    /// captured handle value to the live handle the replay should use
+    using capture_handle_map_t = std::unordered_map<uint64_t, uint64_t>;
+
+    namespace detail
+    {
+        template <typename Handle>
+        uint64_t to_capture_handle(Handle handle) noexcept
+        {
+            if constexpr (std::is_pointer_v<Handle>)
+                return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(handle));
+            else
+                return static_cast<uint64_t>(handle);
+        }
+
+        template <typename Handle>
+        Handle from_capture_handle(uint64_t value) noexcept
+        {
+            if constexpr (std::is_pointer_v<Handle>)
+                return reinterpret_cast<Handle>(static_cast<uintptr_t>(value));
+            else
+                return static_cast<Handle>(value);
+        }
+
+        class capture_writer_t
+        {
+        public:
+            explicit capture_writer_t(std::vector<uint8_t>& stream) noexcept
+                : stream_(&stream)
+            {}
+
+            template <typename T>
+            void write(T const& value)
+            {
+                static_assert(std::is_trivially_copyable_v<T>);
+                write_bytes(&value, sizeof(T));
+            }
+
+            template <typename Handle>
+            void write_handle(Handle handle)
+            {
+                write(to_capture_handle(handle));
+            }
+
+            template <typename T>
+            void write_array(T const* values, uint32_t count)
+            {
+                static_assert(std::is_trivially_copyable_v<T>);
+                write(count);
+                write_bytes(values, sizeof(T) * count);
+            }
+
+            template <typename Handle>
+            void write_handles(Handle const* handles, uint32_t count)
+            {
+                write(count);
+                for (uint32_t i = 0; i < count; ++i)
+                    write_handle(handles[i]);
+            }
+
+            void write_bytes(void const* data, size_t size)
+            {
+                if (0 == size)
+                    return;
+
+                auto const offset = stream_->size();
+                stream_->resize(offset + size);
+                std::memcpy(stream_->data() + offset, data, size);
+            }
+
+        private:
+            std::vector<uint8_t>*       stream_;
+        };
+
+        class capture_reader_t
+        {
+        public:
+            /// without a map the handles are read back as they were captured
+            capture_reader_t(uint8_t const* data, size_t size, capture_handle_map_t const* handles) noexcept
+                : data_(data)
+                , size_(size)
+                , handles_(handles)
+            {}
+
+            bool empty() const noexcept
+            {
+                return offset_ >= size_;
+            }
+
+            template <typename T>
+            T read()
+            {
+                static_assert(std::is_trivially_copyable_v<T>);
+                T value;
+                read_bytes(&value, sizeof(T));
+                return value;
+            }
+
+            /// a handle missing from the map would reach the driver as a dangling one
+            template <typename Handle>
+            Handle read_handle()
+            {
+                auto value = read<uint64_t>();
+                if (nullptr == handles_ || 0 == value)
+                    return from_capture_handle<Handle>(value);
+
+                auto itr = handles_->find(value);
+                if (itr == handles_->end())
+                    throw std::runtime_error{ "Unmapped handle in the capture stream!" };
+
+                return from_capture_handle<Handle>(itr->second);
+            }
+
+            /// the arrays are copied out, the stream carries no alignment
+            template <typename T>
+            uint32_t read_array(std::vector<T>& values)
+            {
+                auto count = read<uint32_t>();
+                values.resize(count);
+                read_bytes(values.data(), sizeof(T) * count);
+                return count;
+            }
+
+            template <typename Handle>
+            uint32_t read_handles(std::vector<Handle>& handles)
+            {
+                auto count = read<uint32_t>();
+                handles.resize(count);
+                for (auto& handle : handles)
+                    handle = read_handle<Handle>();
+                return count;
+            }
+
+            void read_bytes(void* data, size_t size)
+            {
+                if (size > size_ - offset_)
+                    throw std::runtime_error{ "Truncated capture stream!" };
+
+                if (0 != size)
+                    std::memcpy(data, data_ + offset_, size);
+                offset_ += size;
+            }
+
+        private:
+            uint8_t const*                  data_;
+            size_t                          size_;
+            size_t                          offset_ = 0;
+            capture_handle_map_t const*     handles_;
+        };
+    }
+
+#ifdef VK_KHR_dynamic_rendering
+    namespace detail
+    {
+        inline void write_rendering_attachment(capture_writer_t& writer, VkRenderingAttachmentInfoKHR const* attachment)
+        {
+            writer.write(static_cast<uint8_t>(nullptr != attachment));
+            if (nullptr == attachment)
+                return;
+
+            writer.write_handle(attachment->imageView);
+            writer.write(attachment->imageLayout);
+            writer.write(attachment->resolveMode);
+            writer.write_handle(attachment->resolveImageView);
+            writer.write(attachment->resolveImageLayout);
+            writer.write(attachment->loadOp);
+            writer.write(attachment->storeOp);
+            writer.write(attachment->clearValue);
+        }
+
+        /// false when the stream holds no attachment
+        inline bool read_rendering_attachment(capture_reader_t& reader, VkRenderingAttachmentInfoKHR& attachment)
+        {
+            if (0 == reader.read<uint8_t>())
+                return false;
+
+            attachment = { VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR };
+            attachment.imageView = reader.read_handle<VkImageView>();
+            attachment.imageLayout = reader.read<VkImageLayout>();
+            attachment.resolveMode = reader.read<VkResolveModeFlagBitsKHR>();
+            attachment.resolveImageView = reader.read_handle<VkImageView>();
+            attachment.resolveImageLayout = reader.read<VkImageLayout>();
+            attachment.loadOp = reader.read<VkAttachmentLoadOp>();
+            attachment.storeOp = reader.read<VkAttachmentStoreOp>();
+            attachment.clearValue = reader.read<VkClearValue>();
+            return true;
+        }
+    }
+#endif
+
+    class command_capture_t;
+
+    namespace detail
+    {
+        inline thread_local command_capture_t* active_capture = nullptr;
+    }
+
+    /// serializes the commands recorded through its table, arguments and referenced arrays included
+    /// the capture table forwards every call to the target table after writing it. it is static, so the
+    /// stream is the one of the capture begun on the recording thread; begin() before recording and end()
+    /// after. handles are stored by value and remapped at replay through set_capture_handle(), pNext
+    /// chains are not captured. the barriers of a recorder's state tracker and of render_graph::execute()
+    /// with a recorder go through the table as well.
+    class command_capture_t
+    {
+        friend struct capture_table_t;
+
+    public:
+        explicit command_capture_t(command_table_t const& target);
+
+        command_capture_t(command_capture_t const&) = delete;
+        command_capture_t& operator=(command_capture_t const&) = delete;
+
+        ~command_capture_t()
+        {
+            if (this == detail::active_capture)
+                detail::active_capture = nullptr;
+        }
+
+        /// the table to record through, e.g. with command_recorder::set_command_table()
+        command_table_t const& get_command_table() const noexcept
+        {
+            return capture_table_;
+        }
+
+        void begin() noexcept
+        {
+            detail::active_capture = this;
+        }
+
+        void end() noexcept
+        {
+            if (this == detail::active_capture)
+                detail::active_capture = nullptr;
+        }
+
+        std::vector<uint8_t> const& get_stream() const noexcept
+        {
+            return stream_;
+        }
+
+        uint64_t get_command_count() const noexcept
+        {
+            return command_count_;
+        }
+
+        void clear()
+        {
+            stream_.clear();
+            command_count_ = 0;
+            write_header();
+        }
+
+    private:
+        detail::capture_writer_t begin_command(capture_op_t op)
+        {
+            detail::capture_writer_t writer{ stream_ };
+            writer.write(op);
+            ++command_count_;
+            return writer;
+        }
+
+        void write_header()
+        {
+            detail::capture_writer_t writer{ stream_ };
+            writer.write(capture_magic);
+            writer.write(capture_version);
+        }
+
+    private:
+        command_table_t                 target_;
+        command_table_t                 capture_table_;
+        std::vector<uint8_t>            stream_;
+        uint64_t                        command_count_ = 0;
+    };
+
+    // the entry points of the capture table
+    struct capture_table_t
+    {
+        static command_capture_t& active() noexcept
+        {
+            assert(nullptr != detail::active_capture);
+            return *detail::active_capture;
+        }
+
+        static VKAPI_ATTR void VKAPI_CALL bind_pipeline(VkCommandBuffer command_buffer, VkPipelineBindPoint bind_point, VkPipeline pipeline)
+        {
+            auto& capture = active();
+            auto writer = capture.begin_command(capture_op_t::bind_pipeline);
+            writer.write(bind_point);
+            writer.write_handle(pipeline);
+            capture.target_.vkCmdBindPipeline(command_buffer, bind_point, pipeline);
+        }
+
+        static VKAPI_ATTR void VKAPI_CALL bind_descriptor_sets(VkCommandBuffer command_buffer, VkPipelineBindPoint bind_point,
+            VkPipelineLayout layout, uint32_t first_set, uint32_t set_count, VkDescriptorSet const* sets,
+            uint32_t dynamic_offset_count, uint32_t const* dynamic_offsets)
+        {
+            auto& capture = active();
+            auto writer = capture.begin_command(capture_op_t::bind_descriptor_sets);
+            writer.write(bind_point);
+            writer.write_handle(layout);
+            writer.write(first_set);
+            writer.write_handles(sets, set_count);
+            writer.write_array(dynamic_offsets, dynamic_offset_count);
+            capture.target_.vkCmdBindDescriptorSets(command_buffer, bind_point, layout, first_set, set_count, sets,
+                dynamic_offset_count, dynamic_offsets);
+        }
+
+        static VKAPI_ATTR void VKAPI_CALL bind_vertex_buffers(VkCommandBuffer command_buffer, uint32_t first_binding,
+            uint32_t binding_count, VkBuffer const* buffers, VkDeviceSize const* offsets)
+        {
+            auto& capture = active();
+            auto writer = capture.begin_command(capture_op_t::bind_vertex_buffers);
+            writer.write(first_binding);
+            writer.write_handles(buffers, binding_count);
+            writer.write_array(offsets, binding_count);
+            capture.target_.vkCmdBindVertexBuffers(command_buffer, first_binding, binding_count, buffers, offsets);
+        }
+
+        static VKAPI_ATTR void VKAPI_CALL bind_index_buffer(VkCommandBuffer command_buffer, VkBuffer buffer,
+            VkDeviceSize offset, VkIndexType index_type)
+        {
+            auto& capture = active();
+            auto writer = capture.begin_command(capture_op_t::bind_index_buffer);
+            writer.write_handle(buffer);
+            writer.write(offset);
+            writer.write(index_type);
+            capture.target_.vkCmdBindIndexBuffer(command_buffer, buffer, offset, index_type);
+        }
+
+        static VKAPI_ATTR void VKAPI_CALL set_viewport(VkCommandBuffer command_buffer, uint32_t first_viewport,
+            uint32_t viewport_count, VkViewport const* viewports)
+        {
+            auto& capture = active();
+            auto writer = capture.begin_command(capture_op_t::set_viewport);
+            writer.write(first_viewport);
+            writer.write_array(viewports, viewport_count);
+            capture.target_.vkCmdSetViewport(command_buffer, first_viewport, viewport_count, viewports);
+        }
+
+        static VKAPI_ATTR void VKAPI_CALL set_scissor(VkCommandBuffer command_buffer, uint32_t first_scissor,
+            uint32_t scissor_count, VkRect2D const* scissors)
+        {
+            auto& capture = active();
+            auto writer = capture.begin_command(capture_op_t::set_scissor);
+            writer.write(first_scissor);
+            writer.write_array(scissors, scissor_count);
+            capture.target_.vkCmdSetScissor(command_buffer, first_scissor, scissor_count, scissors);
+        }
+
+        static VKAPI_ATTR void VKAPI_CALL push_constants(VkCommandBuffer command_buffer, VkPipelineLayout layout,
+            VkShaderStageFlags stages, uint32_t offset, uint32_t size, void const* data)
+        {
+            auto& capture = active();
+            auto writer = capture.begin_command(capture_op_t::push_constants);
+            writer.write_handle(layout);
+            writer.write(stages);
+            writer.write(offset);
+            writer.write_array(static_cast<uint8_t const*>(data), size);
+            capture.target_.vkCmdPushConstants(command_buffer, layout, stages, offset, size, data);
+        }
+
+        static VKAPI_ATTR void VKAPI_CALL draw(VkCommandBuffer command_buffer, uint32_t vertex_count,
+            uint32_t instance_count, uint32_t first_vertex, uint32_t first_instance)
+        {
+            auto& capture = active();
+            auto writer = capture.begin_command(capture_op_t::draw);
+            writer.write(vertex_count);
+            writer.write(instance_count);
+            writer.write(first_vertex);
+            writer.write(first_instance);
+            capture.target_.vkCmdDraw(command_buffer, vertex_count, instance_count, first_vertex, first_instance);
+        }
+
+        static VKAPI_ATTR void VKAPI_CALL draw_indexed(VkCommandBuffer command_buffer, uint32_t index_count,
+            uint32_t instance_count, uint32_t first_index, int32_t vertex_offset, uint32_t first_instance)
+        {
+            auto& capture = active();
+            auto writer = capture.begin_command(capture_op_t::draw_indexed);
+            writer.write(index_count);
+            writer.write(instance_count);
+            writer.write(first_index);
+            writer.write(vertex_offset);
+            writer.write(first_instance);
+            capture.target_.vkCmdDrawIndexed(command_buffer, index_count, instance_count, first_index, vertex_offset, first_instance);
+        }
+
+        static VKAPI_ATTR void VKAPI_CALL draw_indexed_indirect(VkCommandBuffer command_buffer, VkBuffer buffer,
+            VkDeviceSize offset, uint32_t draw_count, uint32_t stride)
+        {
+            auto& capture = active();
+            auto writer = capture.begin_command(capture_op_t::draw_indexed_indirect);
+            writer.write_handle(buffer);
+            writer.write(offset);
+            writer.write(draw_count);
+            writer.write(stride);
+            capture.target_.vkCmdDrawIndexedIndirect(command_buffer, buffer, offset, draw_count, stride);
+        }
+
+        static VKAPI_ATTR void VKAPI_CALL dispatch(VkCommandBuffer command_buffer, uint32_t x, uint32_t y, uint32_t z)
+        {
+            auto& capture = active();
+            auto writer = capture.begin_command(capture_op_t::dispatch);
+            writer.write(x);
+            writer.write(y);
+            writer.write(z);
+            capture.target_.vkCmdDispatch(command_buffer, x, y, z);
+        }
+
+        static VKAPI_ATTR void VKAPI_CALL copy_buffer(VkCommandBuffer command_buffer, VkBuffer src, VkBuffer dst,
+            uint32_t region_count, VkBufferCopy const* regions)
+        {
+            auto& capture = active();
+            auto writer = capture.begin_command(capture_op_t::copy_buffer);
+            writer.write_handle(src);
+            writer.write_handle(dst);
+            writer.write_array(regions, region_count);
+            capture.target_.vkCmdCopyBuffer(command_buffer, src, dst, region_count, regions);
+        }
+
+        static VKAPI_ATTR void VKAPI_CALL fill_buffer(VkCommandBuffer command_buffer, VkBuffer buffer,
+            VkDeviceSize offset, VkDeviceSize size, uint32_t data)
+        {
+            auto& capture = active();
+            auto writer = capture.begin_command(capture_op_t::fill_buffer);
+            writer.write_handle(buffer);
+            writer.write(offset);
+            writer.write(size);
+            writer.write(data);
+            capture.target_.vkCmdFillBuffer(command_buffer, buffer, offset, size, data);
+        }
+
+        static VKAPI_ATTR void VKAPI_CALL copy_image(VkCommandBuffer command_buffer, VkImage src, VkImageLayout src_layout,
+            VkImage dst, VkImageLayout dst_layout, uint32_t region_count, VkImageCopy const* regions)
+        {
+            auto& capture = active();
+            auto writer = capture.begin_command(capture_op_t::copy_image);
+            writer.write_handle(src);
+            writer.write(src_layout);
+            writer.write_handle(dst);
+            writer.write(dst_layout);
+            writer.write_array(regions, region_count);
+            capture.target_.vkCmdCopyImage(command_buffer, src, src_layout, dst, dst_layout, region_count, regions);
+        }
+
+        static VKAPI_ATTR void VKAPI_CALL copy_buffer_to_image(VkCommandBuffer command_buffer, VkBuffer src, VkImage dst,
+            VkImageLayout dst_layout, uint32_t region_count, VkBufferImageCopy const* regions)
+        {
+            auto& capture = active();
+            auto writer = capture.begin_command(capture_op_t::copy_buffer_to_image);
+            writer.write_handle(src);
+            writer.write_handle(dst);
+            writer.write(dst_layout);
+            writer.write_array(regions, region_count);
+            capture.target_.vkCmdCopyBufferToImage(command_buffer, src, dst, dst_layout, region_count, regions);
+        }
+
+        static VKAPI_ATTR void VKAPI_CALL copy_image_to_buffer(VkCommandBuffer command_buffer, VkImage src,
+            VkImageLayout src_layout, VkBuffer dst, uint32_t region_count, VkBufferImageCopy const* regions)
+        {
+            auto& capture = active();
+            auto writer = capture.begin_command(capture_op_t::copy_image_to_buffer);
+            writer.write_handle(src);
+            writer.write(src_layout);
+            writer.write_handle(dst);
+            writer.write_array(regions, region_count);
+            capture.target_.vkCmdCopyImageToBuffer(command_buffer, src, src_layout, dst, region_count, regions);
+        }
+
+        static VKAPI_ATTR void VKAPI_CALL begin_render_pass(VkCommandBuffer command_buffer,
+            VkRenderPassBeginInfo const* begin_info, VkSubpassContents contents)
+        {
+            auto& capture = active();
+            auto writer = capture.begin_command(capture_op_t::begin_render_pass);
+            writer.write_handle(begin_info->renderPass);
+            writer.write_handle(begin_info->framebuffer);
+            writer.write(begin_info->renderArea);
+            writer.write_array(begin_info->pClearValues, begin_info->clearValueCount);
+            writer.write(contents);
+            capture.target_.vkCmdBeginRenderPass(command_buffer, begin_info, contents);
+        }
+
+        static VKAPI_ATTR void VKAPI_CALL end_render_pass(VkCommandBuffer command_buffer)
+        {
+            auto& capture = active();
+            capture.begin_command(capture_op_t::end_render_pass);
+            capture.target_.vkCmdEndRenderPass(command_buffer);
+        }
+
+        static VKAPI_ATTR void VKAPI_CALL execute_commands(VkCommandBuffer command_buffer, uint32_t count,
+            VkCommandBuffer const* command_buffers)
+        {
+            auto& capture = active();
+            auto writer = capture.begin_command(capture_op_t::execute_commands);
+            writer.write_handles(command_buffers, count);
+            capture.target_.vkCmdExecuteCommands(command_buffer, count, command_buffers);
+        }
+
+        static VKAPI_ATTR void VKAPI_CALL reset_query_pool(VkCommandBuffer command_buffer, VkQueryPool pool,
+            uint32_t first_query, uint32_t query_count)
+        {
+            auto& capture = active();
+            auto writer = capture.begin_command(capture_op_t::reset_query_pool);
+            writer.write_handle(pool);
+            writer.write(first_query);
+            writer.write(query_count);
+            capture.target_.vkCmdResetQueryPool(command_buffer, pool, first_query, query_count);
+        }
+
+        static VKAPI_ATTR void VKAPI_CALL write_timestamp(VkCommandBuffer command_buffer, VkPipelineStageFlagBits stage,
+            VkQueryPool pool, uint32_t query)
+        {
+            auto& capture = active();
+            auto writer = capture.begin_command(capture_op_t::write_timestamp);
+            writer.write(stage);
+            writer.write_handle(pool);
+            writer.write(query);
+            capture.target_.vkCmdWriteTimestamp(command_buffer, stage, pool, query);
+        }
+
+        static VKAPI_ATTR void VKAPI_CALL pipeline_barrier(VkCommandBuffer command_buffer, VkPipelineStageFlags src_stages,
+            VkPipelineStageFlags dst_stages, VkDependencyFlags dependency_flags,
+            uint32_t memory_barrier_count, VkMemoryBarrier const* memory_barriers,
+            uint32_t buffer_barrier_count, VkBufferMemoryBarrier const* buffer_barriers,
+            uint32_t image_barrier_count, VkImageMemoryBarrier const* image_barriers)
+        {
+            auto& capture = active();
+            auto writer = capture.begin_command(capture_op_t::pipeline_barrier);
+            writer.write(src_stages);
+            writer.write(dst_stages);
+            writer.write(dependency_flags);
+            writer.write(memory_barrier_count);
+            for (uint32_t i = 0; i < memory_barrier_count; ++i)
+            {
+                writer.write(memory_barriers[i].srcAccessMask);
+                writer.write(memory_barriers[i].dstAccessMask);
+            }
+            writer.write(buffer_barrier_count);
+            for (uint32_t i = 0; i < buffer_barrier_count; ++i)
+            {
+                auto const& barrier = buffer_barriers[i];
+                writer.write(barrier.srcAccessMask);
+                writer.write(barrier.dstAccessMask);
+                writer.write(barrier.srcQueueFamilyIndex);
+                writer.write(barrier.dstQueueFamilyIndex);
+                writer.write_handle(barrier.buffer);
+                writer.write(barrier.offset);
+                writer.write(barrier.size);
+            }
+            writer.write(image_barrier_count);
+            for (uint32_t i = 0; i < image_barrier_count; ++i)
+            {
+                auto const& barrier = image_barriers[i];
+                writer.write(barrier.srcAccessMask);
+                writer.write(barrier.dstAccessMask);
+                writer.write(barrier.oldLayout);
+                writer.write(barrier.newLayout);
+                writer.write(barrier.srcQueueFamilyIndex);
+                writer.write(barrier.dstQueueFamilyIndex);
+                writer.write_handle(barrier.image);
+                writer.write(barrier.subresourceRange);
+            }
+            capture.target_.vkCmdPipelineBarrier(command_buffer, src_stages, dst_stages, dependency_flags,
+                memory_barrier_count, memory_barriers, buffer_barrier_count, buffer_barriers, image_barrier_count, image_barriers);
+        }
+
+        static VKAPI_ATTR void VKAPI_CALL draw_indexed_indirect_count(VkCommandBuffer command_buffer, VkBuffer buffer,
+            VkDeviceSize offset, VkBuffer count_buffer, VkDeviceSize count_offset, uint32_t max_draw_count, uint32_t stride)
+        {
+            auto& capture = active();
+            auto writer = capture.begin_command(capture_op_t::draw_indexed_indirect_count);
+            writer.write_handle(buffer);
+            writer.write(offset);
+            writer.write_handle(count_buffer);
+            writer.write(count_offset);
+            writer.write(max_draw_count);
+            writer.write(stride);
+            capture.target_.vkCmdDrawIndexedIndirectCountKHR(command_buffer, buffer, offset, count_buffer, count_offset, max_draw_count, stride);
+        }
+
+        static VKAPI_ATTR void VKAPI_CALL push_descriptor_set(VkCommandBuffer command_buffer, VkPipelineBindPoint bind_point,
+            VkPipelineLayout layout, uint32_t set, uint32_t write_count, VkWriteDescriptorSet const* writes)
+        {
+            auto& capture = active();
+            auto writer = capture.begin_command(capture_op_t::push_descriptor_set);
+            writer.write(bind_point);
+            writer.write_handle(layout);
+            writer.write(set);
+            writer.write(write_count);
+            for (uint32_t i = 0; i < write_count; ++i)
+            {
+                auto const& write = writes[i];
+                writer.write(write.dstBinding);
+                writer.write(write.dstArrayElement);
+                writer.write(write.descriptorCount);
+                writer.write(write.descriptorType);
+                for (uint32_t j = 0; j < write.descriptorCount; ++j)
+                {
+                    if (detail::is_image_descriptor(write.descriptorType))
+                    {
+                        writer.write_handle(write.pImageInfo[j].sampler);
+                        writer.write_handle(write.pImageInfo[j].imageView);
+                        writer.write(write.pImageInfo[j].imageLayout);
+                    }
+                    else if (detail::is_texel_buffer_descriptor(write.descriptorType))
+                    {
+                        writer.write_handle(write.pTexelBufferView[j]);
+                    }
+                    else
+                    {
+                        writer.write_handle(write.pBufferInfo[j].buffer);
+                        writer.write(write.pBufferInfo[j].offset);
+                        writer.write(write.pBufferInfo[j].range);
+                    }
+                }
+            }
+            capture.target_.vkCmdPushDescriptorSetKHR(command_buffer, bind_point, layout, set, write_count, writes);
+        }
+
+#ifdef VK_KHR_dynamic_rendering
+        static VKAPI_ATTR void VKAPI_CALL begin_rendering(VkCommandBuffer command_buffer, VkRenderingInfoKHR const* rendering_info)
+        {
+            auto& capture = active();
+            auto writer = capture.begin_command(capture_op_t::begin_rendering);
+            writer.write(rendering_info->flags);
+            writer.write(rendering_info->renderArea);
+            writer.write(rendering_info->layerCount);
+            writer.write(rendering_info->viewMask);
+            writer.write(rendering_info->colorAttachmentCount);
+            for (uint32_t i = 0; i < rendering_info->colorAttachmentCount; ++i)
+                detail::write_rendering_attachment(writer, rendering_info->pColorAttachments + i);
+            detail::write_rendering_attachment(writer, rendering_info->pDepthAttachment);
+            detail::write_rendering_attachment(writer, rendering_info->pStencilAttachment);
+            capture.target_.vkCmdBeginRenderingKHR(command_buffer, rendering_info);
+        }
+
+        static VKAPI_ATTR void VKAPI_CALL end_rendering(VkCommandBuffer command_buffer)
+        {
+            auto& capture = active();
+            capture.begin_command(capture_op_t::end_rendering);
+            capture.target_.vkCmdEndRenderingKHR(command_buffer);
+        }
+#endif
+    };
+
+    inline command_capture_t::command_capture_t(command_table_t const& target)
+        : target_(target)
+    {
+        capture_table_.vkCmdBindPipeline = &capture_table_t::bind_pipeline;
+        capture_table_.vkCmdBindDescriptorSets = &capture_table_t::bind_descriptor_sets;
+        capture_table_.vkCmdBindVertexBuffers = &capture_table_t::bind_vertex_buffers;
+        capture_table_.vkCmdBindIndexBuffer = &capture_table_t::bind_index_buffer;
+        capture_table_.vkCmdSetViewport = &capture_table_t::set_viewport;
+        capture_table_.vkCmdSetScissor = &capture_table_t::set_scissor;
+        capture_table_.vkCmdPushConstants = &capture_table_t::push_constants;
+        capture_table_.vkCmdDraw = &capture_table_t::draw;
+        capture_table_.vkCmdDrawIndexed = &capture_table_t::draw_indexed;
+        capture_table_.vkCmdDrawIndexedIndirect = &capture_table_t::draw_indexed_indirect;
+        capture_table_.vkCmdDispatch = &capture_table_t::dispatch;
+        capture_table_.vkCmdCopyBuffer = &capture_table_t::copy_buffer;
+        capture_table_.vkCmdFillBuffer = &capture_table_t::fill_buffer;
+        capture_table_.vkCmdCopyImage = &capture_table_t::copy_image;
+        capture_table_.vkCmdCopyBufferToImage = &capture_table_t::copy_buffer_to_image;
+        capture_table_.vkCmdCopyImageToBuffer = &capture_table_t::copy_image_to_buffer;
+        capture_table_.vkCmdBeginRenderPass = &capture_table_t::begin_render_pass;
+        capture_table_.vkCmdEndRenderPass = &capture_table_t::end_render_pass;
+        capture_table_.vkCmdExecuteCommands = &capture_table_t::execute_commands;
+        capture_table_.vkCmdResetQueryPool = &capture_table_t::reset_query_pool;
+        capture_table_.vkCmdWriteTimestamp = &capture_table_t::write_timestamp;
+        capture_table_.vkCmdPipelineBarrier = &capture_table_t::pipeline_barrier;
+
+        // the extension entry points stay null where the target has none
+        if (nullptr != target.vkCmdPushDescriptorSetKHR)
+            capture_table_.vkCmdPushDescriptorSetKHR = &capture_table_t::push_descriptor_set;
+        if (nullptr != target.vkCmdDrawIndexedIndirectCountKHR)
+            capture_table_.vkCmdDrawIndexedIndirectCountKHR = &capture_table_t::draw_indexed_indirect_count;
+#ifdef VK_KHR_dynamic_rendering
+        if (nullptr != target.vkCmdBeginRenderingKHR)
+        {
+            capture_table_.vkCmdBeginRenderingKHR = &capture_table_t::begin_rendering;
+            capture_table_.vkCmdEndRenderingKHR = &capture_table_t::end_rendering;
+        }
+#endif
+        write_header();
+    }
+
+    /// resolve a captured handle to the live object the replay should use instead
+    template <typename Handle>
+    void set_capture_handle(capture_handle_map_t& handles, Handle captured, Handle live)
+    {
+        handles[detail::to_capture_handle(captured)] = detail::to_capture_handle(live);
+    }
+
+    namespace detail
+    {
+        inline uint64_t replay_capture(std::vector<uint8_t> const& stream, command_table_t const& table,
+            VkCommandBuffer command_buffer, capture_handle_map_t const* handles)
+        {
+            capture_reader_t reader{ stream.data(), stream.size(), handles };
+            if (capture_magic != reader.read<uint32_t>() || capture_version != reader.read<uint32_t>())
+                throw std::runtime_error{ "Unknown capture stream!" };
+
+            // scratch arrays are reused across the commands
+            thread_local std::vector<uint32_t> u32s;
+            thread_local std::vector<uint8_t> bytes;
+            thread_local std::vector<VkDeviceSize> sizes;
+            thread_local std::vector<VkDescriptorSet> sets;
+            thread_local std::vector<VkBuffer> buffers;
+            thread_local std::vector<VkCommandBuffer> command_buffers;
+            thread_local std::vector<VkViewport> viewports;
+            thread_local std::vector<VkRect2D> rects;
+            thread_local std::vector<VkBufferCopy> buffer_copies;
+            thread_local std::vector<VkImageCopy> image_copies;
+            thread_local std::vector<VkBufferImageCopy> buffer_image_copies;
+            thread_local std::vector<VkClearValue> clear_values;
+            thread_local std::vector<VkWriteDescriptorSet> descriptor_writes;
+            thread_local std::vector<size_t> info_offsets;
+            thread_local std::vector<VkDescriptorImageInfo> image_infos;
+            thread_local std::vector<VkDescriptorBufferInfo> buffer_infos;
+            thread_local std::vector<VkBufferView> texel_buffer_views;
+            thread_local std::vector<VkMemoryBarrier> memory_barriers;
+            thread_local std::vector<VkBufferMemoryBarrier> buffer_barriers;
+            thread_local std::vector<VkImageMemoryBarrier> image_barriers;
+#ifdef VK_KHR_dynamic_rendering
+            thread_local std::vector<VkRenderingAttachmentInfoKHR> rendering_attachments;
+#endif
+
+            uint64_t count = 0;
+            for (; !reader.empty(); ++count)
+            {
+                switch (reader.read<capture_op_t>())
+                {
+                case capture_op_t::bind_pipeline:
+                {
+                    auto bind_point = reader.read<VkPipelineBindPoint>();
+                    auto pipeline = reader.read_handle<VkPipeline>();
+                    table.vkCmdBindPipeline(command_buffer, bind_point, pipeline);
+                    break;
+                }
+                case capture_op_t::bind_descriptor_sets:
+                {
+                    auto bind_point = reader.read<VkPipelineBindPoint>();
+                    auto layout = reader.read_handle<VkPipelineLayout>();
+                    auto first_set = reader.read<uint32_t>();
+                    auto set_count = reader.read_handles(sets);
+                    auto offset_count = reader.read_array(u32s);
+                    table.vkCmdBindDescriptorSets(command_buffer, bind_point, layout, first_set, set_count, sets.data(),
+                        offset_count, u32s.data());
+                    break;
+                }
+                case capture_op_t::bind_vertex_buffers:
+                {
+                    auto first_binding = reader.read<uint32_t>();
+                    auto binding_count = reader.read_handles(buffers);
+                    reader.read_array(sizes);
+                    table.vkCmdBindVertexBuffers(command_buffer, first_binding, binding_count, buffers.data(), sizes.data());
+                    break;
+                }
+                case capture_op_t::bind_index_buffer:
+                {
+                    auto buffer = reader.read_handle<VkBuffer>();
+                    auto offset = reader.read<VkDeviceSize>();
+                    auto index_type = reader.read<VkIndexType>();
+                    table.vkCmdBindIndexBuffer(command_buffer, buffer, offset, index_type);
+                    break;
+                }
+                case capture_op_t::set_viewport:
+                {
+                    auto first = reader.read<uint32_t>();
+                    auto viewport_count = reader.read_array(viewports);
+                    table.vkCmdSetViewport(command_buffer, first, viewport_count, viewports.data());
+                    break;
+                }
+                case capture_op_t::set_scissor:
+                {
+                    auto first = reader.read<uint32_t>();
+                    auto scissor_count = reader.read_array(rects);
+                    table.vkCmdSetScissor(command_buffer, first, scissor_count, rects.data());
+                    break;
+                }
+                case capture_op_t::push_constants:
+                {
+                    auto layout = reader.read_handle<VkPipelineLayout>();
+                    auto stages = reader.read<VkShaderStageFlags>();
+                    auto offset = reader.read<uint32_t>();
+                    auto size = reader.read_array(bytes);
+                    table.vkCmdPushConstants(command_buffer, layout, stages, offset, size, bytes.data());
+                    break;
+                }
+                case capture_op_t::draw:
+                {
+                    auto vertex_count = reader.read<uint32_t>();
+                    auto instance_count = reader.read<uint32_t>();
+                    auto first_vertex = reader.read<uint32_t>();
+                    auto first_instance = reader.read<uint32_t>();
+                    table.vkCmdDraw(command_buffer, vertex_count, instance_count, first_vertex, first_instance);
+                    break;
+                }
+                case capture_op_t::draw_indexed:
+                {
+                    auto index_count = reader.read<uint32_t>();
+                    auto instance_count = reader.read<uint32_t>();
+                    auto first_index = reader.read<uint32_t>();
+                    auto vertex_offset = reader.read<int32_t>();
+                    auto first_instance = reader.read<uint32_t>();
+                    table.vkCmdDrawIndexed(command_buffer, index_count, instance_count, first_index, vertex_offset, first_instance);
+                    break;
+                }
+                case capture_op_t::draw_indexed_indirect:
+                {
+                    auto buffer = reader.read_handle<VkBuffer>();
+                    auto offset = reader.read<VkDeviceSize>();
+                    auto draw_count = reader.read<uint32_t>();
+                    auto stride = reader.read<uint32_t>();
+                    table.vkCmdDrawIndexedIndirect(command_buffer, buffer, offset, draw_count, stride);
+                    break;
+                }
+                case capture_op_t::dispatch:
+                {
+                    auto x = reader.read<uint32_t>();
+                    auto y = reader.read<uint32_t>();
+                    auto z = reader.read<uint32_t>();
+                    table.vkCmdDispatch(command_buffer, x, y, z);
+                    break;
+                }
+                case capture_op_t::copy_buffer:
+                {
+                    auto src = reader.read_handle<VkBuffer>();
+                    auto dst = reader.read_handle<VkBuffer>();
+                    auto region_count = reader.read_array(buffer_copies);
+                    table.vkCmdCopyBuffer(command_buffer, src, dst, region_count, buffer_copies.data());
+                    break;
+                }
+                case capture_op_t::fill_buffer:
+                {
+                    auto buffer = reader.read_handle<VkBuffer>();
+                    auto offset = reader.read<VkDeviceSize>();
+                    auto size = reader.read<VkDeviceSize>();
+                    auto data = reader.read<uint32_t>();
+                    table.vkCmdFillBuffer(command_buffer, buffer, offset, size, data);
+                    break;
+                }
+                case capture_op_t::copy_image:
+                {
+                    auto src = reader.read_handle<VkImage>();
+                    auto src_layout = reader.read<VkImageLayout>();
+                    auto dst = reader.read_handle<VkImage>();
+                    auto dst_layout = reader.read<VkImageLayout>();
+                    auto region_count = reader.read_array(image_copies);
+                    table.vkCmdCopyImage(command_buffer, src, src_layout, dst, dst_layout, region_count, image_copies.data());
+                    break;
+                }
+                case capture_op_t::copy_buffer_to_image:
+                {
+                    auto src = reader.read_handle<VkBuffer>();
+                    auto dst = reader.read_handle<VkImage>();
+                    auto dst_layout = reader.read<VkImageLayout>();
+                    auto region_count = reader.read_array(buffer_image_copies);
+                    table.vkCmdCopyBufferToImage(command_buffer, src, dst, dst_layout, region_count, buffer_image_copies.data());
+                    break;
+                }
+                case capture_op_t::copy_image_to_buffer:
+                {
+                    auto src = reader.read_handle<VkImage>();
+                    auto src_layout = reader.read<VkImageLayout>();
+                    auto dst = reader.read_handle<VkBuffer>();
+                    auto region_count = reader.read_array(buffer_image_copies);
+                    table.vkCmdCopyImageToBuffer(command_buffer, src, src_layout, dst, region_count, buffer_image_copies.data());
+                    break;
+                }
+                case capture_op_t::begin_render_pass:
+                {
+                    auto render_pass = reader.read_handle<VkRenderPass>();
+                    auto framebuffer = reader.read_handle<VkFramebuffer>();
+                    auto render_area = reader.read<VkRect2D>();
+                    auto clear_value_count = reader.read_array(clear_values);
+                    auto contents = reader.read<VkSubpassContents>();
+
+                    VkRenderPassBeginInfo begin_info =
+                    {
+                        VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,   // VkStructureType      sType
+                        nullptr,                                    // const void*          pNext
+                        render_pass,                                // VkRenderPass         renderPass
+                        framebuffer,                                // VkFramebuffer        framebuffer
+                        render_area,                                // VkRect2D             renderArea
+                        clear_value_count,                          // uint32_t             clearValueCount
+                        clear_values.data()                         // const VkClearValue*  pClearValues
+                    };
+                    table.vkCmdBeginRenderPass(command_buffer, &begin_info, contents);
+                    break;
+                }
+                case capture_op_t::end_render_pass:
+                    table.vkCmdEndRenderPass(command_buffer);
+                    break;
+                case capture_op_t::execute_commands:
+                {
+                    auto buffer_count = reader.read_handles(command_buffers);
+                    table.vkCmdExecuteCommands(command_buffer, buffer_count, command_buffers.data());
+                    break;
+                }
+                case capture_op_t::reset_query_pool:
+                {
+                    auto pool = reader.read_handle<VkQueryPool>();
+                    auto first_query = reader.read<uint32_t>();
+                    auto query_count = reader.read<uint32_t>();
+                    table.vkCmdResetQueryPool(command_buffer, pool, first_query, query_count);
+                    break;
+                }
+                case capture_op_t::write_timestamp:
+                {
+                    auto stage = reader.read<VkPipelineStageFlagBits>();
+                    auto pool = reader.read_handle<VkQueryPool>();
+                    auto query = reader.read<uint32_t>();
+                    table.vkCmdWriteTimestamp(command_buffer, stage, pool, query);
+                    break;
+                }
+                case capture_op_t::draw_indexed_indirect_count:
+                {
+                    auto buffer = reader.read_handle<VkBuffer>();
+                    auto offset = reader.read<VkDeviceSize>();
+                    auto count_buffer = reader.read_handle<VkBuffer>();
+                    auto count_offset = reader.read<VkDeviceSize>();
+                    auto max_draw_count = reader.read<uint32_t>();
+                    auto stride = reader.read<uint32_t>();
+                    table.vkCmdDrawIndexedIndirectCountKHR(command_buffer, buffer, offset, count_buffer, count_offset, max_draw_count, stride);
+                    break;
+                }
+                case capture_op_t::pipeline_barrier:
+                {
+                    auto src_stages = reader.read<VkPipelineStageFlags>();
+                    auto dst_stages = reader.read<VkPipelineStageFlags>();
+                    auto dependency_flags = reader.read<VkDependencyFlags>();
+
+                    memory_barriers.resize(reader.read<uint32_t>());
+                    for (auto& barrier : memory_barriers)
+                    {
+                        barrier = { VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+                        barrier.srcAccessMask = reader.read<VkAccessFlags>();
+                        barrier.dstAccessMask = reader.read<VkAccessFlags>();
+                    }
+
+                    buffer_barriers.resize(reader.read<uint32_t>());
+                    for (auto& barrier : buffer_barriers)
+                    {
+                        barrier = { VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER };
+                        barrier.srcAccessMask = reader.read<VkAccessFlags>();
+                        barrier.dstAccessMask = reader.read<VkAccessFlags>();
+                        barrier.srcQueueFamilyIndex = reader.read<uint32_t>();
+                        barrier.dstQueueFamilyIndex = reader.read<uint32_t>();
+                        barrier.buffer = reader.read_handle<VkBuffer>();
+                        barrier.offset = reader.read<VkDeviceSize>();
+                        barrier.size = reader.read<VkDeviceSize>();
+                    }
+
+                    image_barriers.resize(reader.read<uint32_t>());
+                    for (auto& barrier : image_barriers)
+                    {
+                        barrier = { VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER };
+                        barrier.srcAccessMask = reader.read<VkAccessFlags>();
+                        barrier.dstAccessMask = reader.read<VkAccessFlags>();
+                        barrier.oldLayout = reader.read<VkImageLayout>();
+                        barrier.newLayout = reader.read<VkImageLayout>();
+                        barrier.srcQueueFamilyIndex = reader.read<uint32_t>();
+                        barrier.dstQueueFamilyIndex = reader.read<uint32_t>();
+                        barrier.image = reader.read_handle<VkImage>();
+                        barrier.subresourceRange = reader.read<VkImageSubresourceRange>();
+                    }
+
+                    table.vkCmdPipelineBarrier(command_buffer, src_stages, dst_stages, dependency_flags,
+                        static_cast<uint32_t>(memory_barriers.size()), memory_barriers.data(),
+                        static_cast<uint32_t>(buffer_barriers.size()), buffer_barriers.data(),
+                        static_cast<uint32_t>(image_barriers.size()), image_barriers.data());
+                    break;
+                }
+                case capture_op_t::push_descriptor_set:
+                {
+                    auto bind_point = reader.read<VkPipelineBindPoint>();
+                    auto layout = reader.read_handle<VkPipelineLayout>();
+                    auto set = reader.read<uint32_t>();
+                    auto write_count = reader.read<uint32_t>();
+                    descriptor_writes.clear();
+                    info_offsets.clear();
+                    image_infos.clear();
+                    buffer_infos.clear();
+                    texel_buffer_views.clear();
+
+                    // the info arrays may still grow, the pointers are resolved once every write is read
+                    for (uint32_t i = 0; i < write_count; ++i)
+                    {
+                        VkWriteDescriptorSet write = { VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+                        write.dstBinding = reader.read<uint32_t>();
+                        write.dstArrayElement = reader.read<uint32_t>();
+                        write.descriptorCount = reader.read<uint32_t>();
+                        write.descriptorType = reader.read<VkDescriptorType>();
+                        if (detail::is_image_descriptor(write.descriptorType))
+                        {
+                            info_offsets.push_back(image_infos.size());
+                            for (uint32_t j = 0; j < write.descriptorCount; ++j)
+                            {
+                                auto sampler = reader.read_handle<VkSampler>();
+                                auto view = reader.read_handle<VkImageView>();
+                                image_infos.push_back({ sampler, view, reader.read<VkImageLayout>() });
+                            }
+                        }
+                        else if (detail::is_texel_buffer_descriptor(write.descriptorType))
+                        {
+                            info_offsets.push_back(texel_buffer_views.size());
+                            for (uint32_t j = 0; j < write.descriptorCount; ++j)
+                                texel_buffer_views.push_back(reader.read_handle<VkBufferView>());
+                        }
+                        else
+                        {
+                            info_offsets.push_back(buffer_infos.size());
+                            for (uint32_t j = 0; j < write.descriptorCount; ++j)
+                            {
+                                auto buffer = reader.read_handle<VkBuffer>();
+                                auto offset = reader.read<VkDeviceSize>();
+                                buffer_infos.push_back({ buffer, offset, reader.read<VkDeviceSize>() });
+                            }
+                        }
+                        descriptor_writes.push_back(write);
+                    }
+
+                    for (size_t i = 0; i < descriptor_writes.size(); ++i)
+                    {
+                        auto& write = descriptor_writes[i];
+                        if (detail::is_image_descriptor(write.descriptorType))
+                            write.pImageInfo = image_infos.data() + info_offsets[i];
+                        else if (detail::is_texel_buffer_descriptor(write.descriptorType))
+                            write.pTexelBufferView = texel_buffer_views.data() + info_offsets[i];
+                        else
+                            write.pBufferInfo = buffer_infos.data() + info_offsets[i];
+                    }
+                    table.vkCmdPushDescriptorSetKHR(command_buffer, bind_point, layout, set, write_count, descriptor_writes.data());
+                    break;
+                }
+#ifdef VK_KHR_dynamic_rendering
+                case capture_op_t::begin_rendering:
+                {
+                    VkRenderingInfoKHR rendering_info = { VK_STRUCTURE_TYPE_RENDERING_INFO_KHR };
+                    rendering_info.flags = reader.read<VkRenderingFlagsKHR>();
+                    rendering_info.renderArea = reader.read<VkRect2D>();
+                    rendering_info.layerCount = reader.read<uint32_t>();
+                    rendering_info.viewMask = reader.read<uint32_t>();
+                    rendering_info.colorAttachmentCount = reader.read<uint32_t>();
+
+                    // the color attachments, then the depth and the stencil one
+                    rendering_attachments.resize(rendering_info.colorAttachmentCount + 2);
+                    for (uint32_t i = 0; i < rendering_info.colorAttachmentCount; ++i)
+                        read_rendering_attachment(reader, rendering_attachments[i]);
+                    auto depth_attachment = rendering_attachments.data() + rendering_info.colorAttachmentCount;
+                    auto stencil_attachment = depth_attachment + 1;
+
+                    rendering_info.pColorAttachments = rendering_attachments.data();
+                    rendering_info.pDepthAttachment = read_rendering_attachment(reader, *depth_attachment) ? depth_attachment : nullptr;
+                    rendering_info.pStencilAttachment = read_rendering_attachment(reader, *stencil_attachment) ? stencil_attachment : nullptr;
+                    table.vkCmdBeginRenderingKHR(command_buffer, &rendering_info);
+                    break;
+                }
+                case capture_op_t::end_rendering:
+                    table.vkCmdEndRenderingKHR(command_buffer);
+                    break;
+#endif
+                default:
+                    throw std::runtime_error{ "Unknown command in the capture stream!" };
+                }
+            }
+
+            return count;
+        }
+    }
+
+    /// re-issue a capture stream into a command buffer through any command table
+    /// every non-null handle in the stream has to be in the map, returns the number of commands replayed
+    inline uint64_t replay_capture(std::vector<uint8_t> const& stream, command_table_t const& table,
+        VkCommandBuffer command_buffer, capture_handle_map_t const& handles)
+    {
+        return detail::replay_capture(stream, table, command_buffer, &handles);
+    }
+
+    /// replay into a command buffer of a live device, the map resolves the captured handles to its objects
+    template <typename Device>
+    uint64_t replay_capture(std::vector<uint8_t> const& stream, Device const& device,
+        VkCommandBuffer command_buffer, capture_handle_map_t const& handles)
+    {
+        return detail::replay_capture(stream, device.get_command_table(), command_buffer, &handles);
+    }
+
+    /// replay with the handles as they were captured, only for tables which never reach a driver,
+    /// e.g. to time the decoding
+    inline uint64_t replay_capture_unmapped(std::vector<uint8_t> const& stream, command_table_t const& table,
+        VkCommandBuffer command_buffer)
+    {
+        return detail::replay_capture(stream, table, command_buffer, nullptr);
+    }
+
+    inline void save_capture(std::string const& path, std::vector<uint8_t> const& stream)
+    {
+        std::ofstream file{ path, std::ios::binary };
+        if (!file.write(reinterpret_cast<char const*>(stream.data()), static_cast<std::streamsize>(stream.size())))
+            throw std::runtime_error{ "Failed to write " + path + "!" };
+    }
+
+    inline std::vector<uint8_t> load_capture(std::string const& path)
+    {
+        std::ifstream file{ path, std::ios::binary };
+        if (!file)
+            throw std::runtime_error{ "Failed to open " + path + "!" };
+
+        return { std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{} };
+    }
+}
@@ -0,0 +1,545 @@
+#pragma once
+
+namespace vk
+{
+    template <typename Device>
+    class state_tracker;
+
+    /// the recording entry points of a device, shared by the command buffer helpers
+    struct command_table_t
+    {
+        VULKAN_DECLARE_FUNCTION(vkCmdBindPipeline);
+        VULKAN_DECLARE_FUNCTION(vkCmdBindDescriptorSets);
+        VULKAN_DECLARE_FUNCTION(vkCmdBindVertexBuffers);
+        VULKAN_DECLARE_FUNCTION(vkCmdBindIndexBuffer);
+        VULKAN_DECLARE_FUNCTION(vkCmdSetViewport);
+        VULKAN_DECLARE_FUNCTION(vkCmdSetScissor);
+        VULKAN_DECLARE_FUNCTION(vkCmdPushConstants);
+        VULKAN_DECLARE_FUNCTION(vkCmdDraw);
+        VULKAN_DECLARE_FUNCTION(vkCmdDrawIndexed);
+        VULKAN_DECLARE_FUNCTION(vkCmdDrawIndexedIndirect);
+        VULKAN_DECLARE_FUNCTION(vkCmdDispatch);
+        VULKAN_DECLARE_FUNCTION(vkCmdCopyBuffer);
+        VULKAN_DECLARE_FUNCTION(vkCmdFillBuffer);
+        VULKAN_DECLARE_FUNCTION(vkCmdCopyImage);
+        VULKAN_DECLARE_FUNCTION(vkCmdCopyBufferToImage);
+        VULKAN_DECLARE_FUNCTION(vkCmdCopyImageToBuffer);
+        VULKAN_DECLARE_FUNCTION(vkCmdBeginRenderPass);
+        VULKAN_DECLARE_FUNCTION(vkCmdEndRenderPass);
+        VULKAN_DECLARE_FUNCTION(vkCmdExecuteCommands);
+        VULKAN_DECLARE_FUNCTION(vkCmdResetQueryPool);
+        VULKAN_DECLARE_FUNCTION(vkCmdWriteTimestamp);
+        VULKAN_DECLARE_FUNCTION(vkCmdPipelineBarrier);
+
+        // extension entry points, null unless the device enables the extension
+        PFN_vkCmdPushDescriptorSetKHR               vkCmdPushDescriptorSetKHR = nullptr;
+        PFN_vkCmdDrawIndexedIndirectCountKHR        vkCmdDrawIndexedIndirectCountKHR = nullptr;
+#ifdef VK_KHR_dynamic_rendering
+        PFN_vkCmdBeginRenderingKHR                  vkCmdBeginRenderingKHR = nullptr;
+        PFN_vkCmdEndRenderingKHR                    vkCmdEndRenderingKHR = nullptr;
+#endif
+    };
+
+    struct command_statistics_t
+    {
+        uint64_t                issued = 0;
+        uint64_t                elided = 0;
+    };
+
+    /// command buffer recording wrapper
+    /// shadows the bound state and drops the calls which would not change it. graphics pipelines are
+    /// expected to use dynamic viewport and scissor, call invalidate_dynamic_state() otherwise.
+    /// when a state tracker is attached its pending barriers are flushed before every draw, dispatch,
+    /// copy and render pass. nothing is flushed inside a render pass or a dynamic rendering scope,
+    /// require the resources of its draws before begin_render_pass() or begin_rendering().
+    template <typename Device>
+    class command_recorder
+    {
+        inline static constexpr uint32_t max_bind_points = 2;           // graphics and compute
+        inline static constexpr uint32_t max_descriptor_sets = 8;
+        inline static constexpr uint32_t max_vertex_bindings = 16;
+        inline static constexpr uint32_t max_push_constant_size = 256;
+
+        struct bound_set_t
+        {
+            VkPipelineLayout            layout = nullptr;
+            VkDescriptorSet             set = nullptr;
+        };
+
+        struct bind_point_state_t
+        {
+            VkPipeline                                          pipeline = nullptr;
+            std::array<bound_set_t, max_descriptor_sets>        sets = {};
+        };
+
+        struct vertex_binding_t
+        {
+            VkBuffer                    buffer = nullptr;
+            VkDeviceSize                offset = 0;
+        };
+
+    public:
+        command_recorder(Device const& device, VkCommandBuffer command_buffer, state_tracker<Device>* tracker = nullptr)
+            : commands_(&device.get_command_table())
+            , tracker_(tracker)
+        {
+            reset(command_buffer);
+        }
+
+        command_recorder(command_recorder const&) = delete;
+        command_recorder& operator=(command_recorder const&) = delete;
+
+        /// record into another command buffer, nothing is bound there yet
+        void reset(VkCommandBuffer command_buffer)
+        {
+            command_buffer_ = command_buffer;
+            in_render_pass_ = false;
+            if (nullptr != tracker_)
+                tracker_->begin(command_buffer, commands_);
+            invalidate();
+        }
+
+        /// forget the shadowed state, e.g. after commands recorded behind the wrapper's back
+        void invalidate()
+        {
+            bind_points_ = {};
+            vertex_bindings_ = {};
+            index_buffer_ = nullptr;
+            index_offset_ = 0;
+            index_type_ = VK_INDEX_TYPE_MAX_ENUM;
+            push_constant_layout_ = nullptr;
+            push_constant_valid_.reset();
+            invalidate_dynamic_state();
+        }
+
+        void invalidate_dynamic_state()
+        {
+            viewport_valid_ = false;
+            scissor_valid_ = false;
+        }
+
+        operator VkCommandBuffer() const noexcept
+        {
+            return command_buffer_;
+        }
+
+        /// record through another table, e.g. the one of a command_capture_t
+        void set_command_table(command_table_t const& commands) noexcept
+        {
+            commands_ = &commands;
+            if (nullptr != tracker_)
+                tracker_->set_command_table(&commands);
+        }
+
+        state_tracker<Device>* get_tracker() const noexcept
+        {
+            return tracker_;
+        }
+
+        command_statistics_t const& get_statistics() const noexcept
+        {
+            return statistics_;
+        }
+
+        /// true inside a render pass and inside a dynamic rendering scope
+        bool in_render_pass() const noexcept
+        {
+            return in_render_pass_;
+        }
+
+        void bind_pipeline(VkPipelineBindPoint bind_point, VkPipeline pipeline)
+        {
+            auto& state = get_bind_point(bind_point);
+            if (state.pipeline == pipeline)
+                return elide();
+
+            state.pipeline = pipeline;
+            issue();
+            commands_->vkCmdBindPipeline(command_buffer_, bind_point, pipeline);
+        }
+
+        /// only the range of sets that actually changes is rebound
+        void bind_descriptor_sets(VkPipelineBindPoint bind_point, VkPipelineLayout layout,
+            uint32_t first_set, uint32_t set_count, VkDescriptorSet const* sets,
+            uint32_t dynamic_offset_count = 0, uint32_t const* dynamic_offsets = nullptr)
+        {
+            assert(first_set + set_count <= max_descriptor_sets);
+            auto& state = get_bind_point(bind_point);
+
+            uint32_t begin = set_count;
+            uint32_t end = 0;
+            for (uint32_t i = 0; i < set_count; ++i)
+            {
+                auto const& bound = state.sets[first_set + i];
+                if (0 != dynamic_offset_count || bound.layout != layout || bound.set != sets[i])
+                {
+                    begin = std::min(begin, i);
+                    end = i + 1;
+                }
+            }
+
+            if (begin >= end)
+                return elide();
+
+            // dynamic offsets are consumed in set order, so those calls are issued as they are
+            if (0 != dynamic_offset_count)
+            {
+                begin = 0;
+                end = set_count;
+            }
+
+            invalidate_descriptor_sets(state, layout, max_descriptor_sets);
+            for (uint32_t i = 0; i < set_count; ++i)
+                state.sets[first_set + i] = { layout, sets[i] };
+
+            issue();
+            commands_->vkCmdBindDescriptorSets(command_buffer_, bind_point, layout, first_set + begin, end - begin,
+                sets + begin, dynamic_offset_count, dynamic_offsets);
+        }
+
+        void bind_descriptor_set(VkPipelineBindPoint bind_point, VkPipelineLayout layout, uint32_t set_index, VkDescriptorSet set)
+        {
+            bind_descriptor_sets(bind_point, layout, set_index, 1, &set);
+        }
+
+        /// the set was replaced behind the recorder's back, e.g. by push descriptors
+        void invalidate_descriptor_set(VkPipelineBindPoint bind_point, uint32_t set_index)
+        {
+            assert(set_index < max_descriptor_sets);
+            get_bind_point(bind_point).sets[set_index] = {};
+        }
+
+        /// needs khr::push_descriptor_ext, the pushed set and every set above it are no longer shadowed
+        void push_descriptor_set(VkPipelineBindPoint bind_point, VkPipelineLayout layout, uint32_t set_index,
+            uint32_t write_count, VkWriteDescriptorSet const* writes)
+        {
+            assert(set_index < max_descriptor_sets && nullptr != commands_->vkCmdPushDescriptorSetKHR);
+            invalidate_descriptor_sets(get_bind_point(bind_point), layout, set_index);
+            issue();
+            commands_->vkCmdPushDescriptorSetKHR(command_buffer_, bind_point, layout, set_index, write_count, writes);
+        }
+
+        void bind_vertex_buffers(uint32_t first_binding, uint32_t binding_count, VkBuffer const* buffers, VkDeviceSize const* offsets)
+        {
+            assert(first_binding + binding_count <= max_vertex_bindings);
+
+            uint32_t begin = binding_count;
+            uint32_t end = 0;
+            for (uint32_t i = 0; i < binding_count; ++i)
+            {
+                auto& bound = vertex_bindings_[first_binding + i];
+                if (bound.buffer != buffers[i] || bound.offset != offsets[i])
+                {
+                    bound = { buffers[i], offsets[i] };
+                    begin = std::min(begin, i);
+                    end = i + 1;
+                }
+            }
+
+            if (begin >= end)
+                return elide();
+
+            issue();
+            commands_->vkCmdBindVertexBuffers(command_buffer_, first_binding + begin, end - begin, buffers + begin, offsets + begin);
+        }
+
+        void bind_vertex_buffer(uint32_t binding, VkBuffer buffer, VkDeviceSize offset = 0)
+        {
+            bind_vertex_buffers(binding, 1, &buffer, &offset);
+        }
+
+        void bind_index_buffer(VkBuffer buffer, VkDeviceSize offset, VkIndexType index_type)
+        {
+            if (index_buffer_ == buffer && index_offset_ == offset && index_type_ == index_type)
+                return elide();
+
+            index_buffer_ = buffer;
+            index_offset_ = offset;
+            index_type_ = index_type;
+            issue();
+            commands_->vkCmdBindIndexBuffer(command_buffer_, buffer, offset, index_type);
+        }
+
+        void set_viewport(VkViewport const& viewport)
+        {
+            if (viewport_valid_ && 0 == std::memcmp(&viewport_, &viewport, sizeof(VkViewport)))
+                return elide();
+
+            viewport_ = viewport;
+            viewport_valid_ = true;
+            issue();
+            commands_->vkCmdSetViewport(command_buffer_, 0, 1, &viewport);
+        }
+
+        void set_scissor(VkRect2D const& scissor)
+        {
+            if (scissor_valid_ && 0 == std::memcmp(&scissor_, &scissor, sizeof(VkRect2D)))
+                return elide();
+
+            scissor_ = scissor;
+            scissor_valid_ = true;
+            issue();
+            commands_->vkCmdSetScissor(command_buffer_, 0, 1, &scissor);
+        }
+
+        void push_constants(VkPipelineLayout layout, VkShaderStageFlags stages, uint32_t offset, uint32_t size, void const* data)
+        {
+            bool const shadowed = offset + size <= max_push_constant_size;
+            if (shadowed && push_constant_layout_ == layout && is_push_constant_range_equal(stages, offset, size, data))
+                return elide();
+
+            if (push_constant_layout_ != layout)
+            {
+                push_constant_layout_ = layout;
+                push_constant_valid_.reset();
+            }
+
+            if (shadowed)
+            {
+                std::memcpy(push_constants_.data() + offset, data, size);
+                for (uint32_t i = offset; i < offset + size; ++i)
+                {
+                    push_constant_valid_.set(i);
+                    push_constant_stages_[i] = stages;
+                }
+            }
+
+            issue();
+            commands_->vkCmdPushConstants(command_buffer_, layout, stages, offset, size, data);
+        }
+
+        template <typename T>
+        void push_constants(VkPipelineLayout layout, VkShaderStageFlags stages, T const& data, uint32_t offset = 0)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            push_constants(layout, stages, offset, static_cast<uint32_t>(sizeof(T)), &data);
+        }
+
+        /// pack a std430 block_layout into the push constant range, check it once with validate_push_constants
+        template <typename Block, typename ... Values>
+        void push_block(VkPipelineLayout layout, VkShaderStageFlags stages, uint32_t offset, Values const& ... values)
+        {
+            static_assert(Block::rule == layout_rule_t::std430, "Push constants use the std430 layout!");
+            std::array<std::byte, Block::size> packed = {};
+            Block::write(packed.data(), values...);
+            push_constants(layout, stages, offset, Block::size, packed.data());
+        }
+
+        void begin_render_pass(VkRenderPassBeginInfo const& begin_info, VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE)
+        {
+            assert(!in_render_pass_);
+            flush_barriers();
+            issue();
+            commands_->vkCmdBeginRenderPass(command_buffer_, &begin_info, contents);
+            in_render_pass_ = true;
+        }
+
+        void end_render_pass()
+        {
+            assert(in_render_pass_);
+            issue();
+            commands_->vkCmdEndRenderPass(command_buffer_);
+            in_render_pass_ = false;
+        }
+
+#ifdef VK_KHR_dynamic_rendering
+        /// needs khr::dynamic_rendering_ext, the scope is tracked like a render pass
+        void begin_rendering(VkRenderingInfoKHR const& rendering_info)
+        {
+            assert(!in_render_pass_ && nullptr != commands_->vkCmdBeginRenderingKHR);
+            flush_barriers();
+            issue();
+            commands_->vkCmdBeginRenderingKHR(command_buffer_, &rendering_info);
+            in_render_pass_ = true;
+        }
+
+        void end_rendering()
+        {
+            assert(in_render_pass_);
+            issue();
+            commands_->vkCmdEndRenderingKHR(command_buffer_);
+            in_render_pass_ = false;
+        }
+#endif
+
+        void draw(uint32_t vertex_count, uint32_t instance_count = 1, uint32_t first_vertex = 0, uint32_t first_instance = 0)
+        {
+            flush_barriers();
+            issue();
+            commands_->vkCmdDraw(command_buffer_, vertex_count, instance_count, first_vertex, first_instance);
+        }
+
+        void draw_indexed(uint32_t index_count, uint32_t instance_count = 1, uint32_t first_index = 0,
+            int32_t vertex_offset = 0, uint32_t first_instance = 0)
+        {
+            flush_barriers();
+            issue();
+            commands_->vkCmdDrawIndexed(command_buffer_, index_count, instance_count, first_index, vertex_offset, first_instance);
+        }
+
+        /// draw_count above one needs the multiDrawIndirect feature
+        void draw_indexed_indirect(VkBuffer buffer, VkDeviceSize offset, uint32_t draw_count,
+            uint32_t stride = sizeof(VkDrawIndexedIndirectCommand))
+        {
+            flush_barriers();
+            issue();
+            commands_->vkCmdDrawIndexedIndirect(command_buffer_, buffer, offset, draw_count, stride);
+        }
+
+        /// draws min(count, max_draw_count) commands, the count is a uint32_t at count_offset
+        /// needs a device with khr::draw_indirect_count_ext
+        void draw_indexed_indirect_count(VkBuffer buffer, VkDeviceSize offset, VkBuffer count_buffer, VkDeviceSize count_offset,
+            uint32_t max_draw_count, uint32_t stride = sizeof(VkDrawIndexedIndirectCommand))
+        {
+            assert(nullptr != commands_->vkCmdDrawIndexedIndirectCountKHR);
+            flush_barriers();
+            issue();
+            commands_->vkCmdDrawIndexedIndirectCountKHR(command_buffer_, buffer, offset, count_buffer, count_offset, max_draw_count, stride);
+        }
+
+        void dispatch(uint32_t group_count_x, uint32_t group_count_y = 1, uint32_t group_count_z = 1)
+        {
+            flush_barriers();
+            issue();
+            commands_->vkCmdDispatch(command_buffer_, group_count_x, group_count_y, group_count_z);
+        }
+
+        void copy_buffer(VkBuffer src, VkBuffer dst, uint32_t region_count, VkBufferCopy const* regions)
+        {
+            flush_barriers();
+            issue();
+            commands_->vkCmdCopyBuffer(command_buffer_, src, dst, region_count, regions);
+        }
+
+        /// offset and size are multiples of 4, size may be VK_WHOLE_SIZE
+        void fill_buffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size, uint32_t data)
+        {
+            flush_barriers();
+            issue();
+            commands_->vkCmdFillBuffer(command_buffer_, buffer, offset, size, data);
+        }
+
+        void copy_image(VkImage src, VkImageLayout src_layout, VkImage dst, VkImageLayout dst_layout,
+            uint32_t region_count, VkImageCopy const* regions)
+        {
+            flush_barriers();
+            issue();
+            commands_->vkCmdCopyImage(command_buffer_, src, src_layout, dst, dst_layout, region_count, regions);
+        }
+
+        void copy_buffer_to_image(VkBuffer src, VkImage dst, VkImageLayout dst_layout,
+            uint32_t region_count, VkBufferImageCopy const* regions)
+        {
+            flush_barriers();
+            issue();
+            commands_->vkCmdCopyBufferToImage(command_buffer_, src, dst, dst_layout, region_count, regions);
+        }
+
+        void copy_image_to_buffer(VkImage src, VkImageLayout src_layout, VkBuffer dst,
+            uint32_t region_count, VkBufferImageCopy const* regions)
+        {
+            flush_barriers();
+            issue();
+            commands_->vkCmdCopyImageToBuffer(command_buffer_, src, src_layout, dst, region_count, regions);
+        }
+
+        /// a barrier on resources the state tracker does not know, its pending barriers go first
+        void pipeline_barrier(VkPipelineStageFlags src_stages, VkPipelineStageFlags dst_stages,
+            uint32_t memory_barrier_count, VkMemoryBarrier const* memory_barriers,
+            uint32_t buffer_barrier_count, VkBufferMemoryBarrier const* buffer_barriers,
+            uint32_t image_barrier_count, VkImageMemoryBarrier const* image_barriers)
+        {
+            assert(!in_render_pass_);
+            flush_barriers();
+            issue();
+            commands_->vkCmdPipelineBarrier(command_buffer_, src_stages, dst_stages, 0,
+                memory_barrier_count, memory_barriers,
+                buffer_barrier_count, buffer_barriers,
+                image_barrier_count, image_barriers);
+        }
+
+        /// secondary command buffers leave the bound state undefined
+        void execute_commands(uint32_t count, VkCommandBuffer const* command_buffers)
+        {
+            flush_barriers();
+            issue();
+            commands_->vkCmdExecuteCommands(command_buffer_, count, command_buffers);
+            invalidate();
+        }
+
+    private:
+        bind_point_state_t& get_bind_point(VkPipelineBindPoint bind_point) noexcept
+        {
+            assert(static_cast<uint32_t>(bind_point) < max_bind_points);
+            return bind_points_[static_cast<uint32_t>(bind_point)];
+        }
+
+        // a different layout may disturb the sets from the first one bound with it, below first_set too
+        void invalidate_descriptor_sets(bind_point_state_t& state, VkPipelineLayout layout, uint32_t first_set) noexcept
+        {
+            for (uint32_t i = 0; i < first_set; ++i)
+            {
+                if (nullptr != state.sets[i].layout && state.sets[i].layout != layout)
+                {
+                    first_set = i;
+                    break;
+                }
+            }
+
+            for (uint32_t i = first_set; i < max_descriptor_sets; ++i)
+                state.sets[i] = {};
+        }
+
+        bool is_push_constant_range_equal(VkShaderStageFlags stages, uint32_t offset, uint32_t size, void const* data) const noexcept
+        {
+            for (uint32_t i = offset; i < offset + size; ++i)
+            {
+                if (!push_constant_valid_.test(i) || push_constant_stages_[i] != stages)
+                    return false;
+            }
+            return 0 == std::memcmp(push_constants_.data() + offset, data, size);
+        }
+
+        // a barrier inside a render pass needs a subpass self-dependency, so the transitions wait
+        // for the next command outside of it, the same holds for dynamic rendering
+        void flush_barriers()
+        {
+            if (nullptr == tracker_)
+                return;
+
+            assert(!in_render_pass_ || !tracker_->has_pending());
+            if (!in_render_pass_)
+                tracker_->flush();
+        }
+
+        void issue() noexcept
+        {
+            ++statistics_.issued;
+        }
+
+        void elide() noexcept
+        {
+            ++statistics_.elided;
+        }
+
+    private:
+        command_table_t const*                                  commands_;
+        state_tracker<Device>*                                  tracker_;
+        VkCommandBuffer                                         command_buffer_ = nullptr;
+        std::array<bind_point_state_t, max_bind_points>         bind_points_ = {};
+        std::array<vertex_binding_t, max_vertex_bindings>       vertex_bindings_ = {};
+        VkBuffer                                                index_buffer_ = nullptr;
+        VkDeviceSize                                            index_offset_ = 0;
+        VkIndexType                                             index_type_ = VK_INDEX_TYPE_MAX_ENUM;
+        VkViewport                                              viewport_ = {};
+        VkRect2D                                                scissor_ = {};
+        bool                                                    viewport_valid_ = false;
+        bool                                                    scissor_valid_ = false;
+        bool                                                    in_render_pass_ = false;
+        VkPipelineLayout                                        push_constant_layout_ = nullptr;
+        std::array<uint8_t, max_push_constant_size>             push_constants_ = {};
+        std::array<VkShaderStageFlags, max_push_constant_size>  push_constant_stages_ = {};
+        std::bitset<max_push_constant_size>                     push_constant_valid_;
+        command_statistics_t                                    statistics_;
+    };
+}
@@ -0,0 +1,601 @@
+#pragma once
+
+namespace vk
+{
+    // descriptors of one type reserved per descriptor set in a pool
+    struct descriptor_pool_ratio_t
+    {
+        VkDescriptorType            type;
+        float                       ratio;
+    };
+
+    struct descriptor_allocator_config_t
+    {
+        uint32_t                                frames_in_flight = 2;
+        uint32_t                                initial_pool_sets = 64;
+        uint32_t                                max_pool_sets = 4096;
+        std::vector<descriptor_pool_ratio_t>    pool_ratios = {
+            { VK_DESCRIPTOR_TYPE_SAMPLER,                   0.5f },
+            { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,    4.0f },
+            { VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,             4.0f },
+            { VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,             1.0f },
+            { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,            2.0f },
+            { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,            2.0f },
+            { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,    1.0f },
+            { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC,    1.0f },
+            { VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT,          0.5f },
+        };
+    };
+
+    /// transient descriptor set allocator
+    /// sets are never freed one by one, every pool used by a frame is reset in bulk
+    /// once the fence of that frame has retired. one allocator per recording thread.
+    template <typename Device>
+    class descriptor_allocator
+    {
+        struct pool_t
+        {
+            VkDescriptorPool        handle = nullptr;
+            uint32_t                max_sets = 0;
+        };
+
+        struct frame_t
+        {
+            std::vector<pool_t>     used_pools;
+            uint32_t                allocated_sets = 0;
+        };
+
+    public:
+        descriptor_allocator(Device const& device, descriptor_allocator_config_t config = {})
+            : device_(&device)
+            , config_(std::move(config))
+            , frames_(std::max(config_.frames_in_flight, 1u))
+        {
+            // the pools grow by doubling, which never leaves an empty size
+            config_.max_pool_sets = std::max(config_.max_pool_sets, 1u);
+            pool_sets_ = std::clamp(config_.initial_pool_sets, 1u, config_.max_pool_sets);
+        }
+
+        ~descriptor_allocator()
+        {
+            for (auto& frame : frames_)
+            {
+                for (auto const& pool : frame.used_pools)
+                    device_->destroy_descriptor_pool(pool.handle);
+            }
+
+            for (auto const& pool : free_pools_)
+                device_->destroy_descriptor_pool(pool.handle);
+        }
+
+        descriptor_allocator(descriptor_allocator const&) = delete;
+        descriptor_allocator& operator=(descriptor_allocator const&) = delete;
+        descriptor_allocator(descriptor_allocator&&) = default;
+        descriptor_allocator& operator=(descriptor_allocator&&) = default;
+
+        /// recycle the pools of the frame, the fence of that frame must have retired
+        void begin_frame(uint32_t frame_index)
+        {
+            frame_index_ = frame_index % static_cast<uint32_t>(frames_.size());
+            auto& frame = frames_[frame_index_];
+
+            // grow the pool size towards the observed peak usage of a frame
+            peak_sets_ = std::max(peak_sets_, frame.allocated_sets);
+            while (pool_sets_ < peak_sets_ && pool_sets_ < config_.max_pool_sets)
+                pool_sets_ = std::min(pool_sets_ * 2, config_.max_pool_sets);
+
+            for (auto const& pool : frame.used_pools)
+            {
+                // pools smaller than the current size are dropped, so the frames converge to one pool each
+                if (pool.max_sets < pool_sets_)
+                {
+                    device_->destroy_descriptor_pool(pool.handle);
+                    continue;
+                }
+
+                device_->reset_descriptor_pool(pool.handle);
+                free_pools_.push_back(pool);
+            }
+
+            frame.used_pools.clear();
+            frame.allocated_sets = 0;
+        }
+
+        /// wait for the fence of the frame before recycling its pools
+        void begin_frame(uint32_t frame_index, VkFence fence)
+        {
+            if (!device_->wait_for_fence(fence))
+                throw std::runtime_error{ "Failed to wait for the frame fence!" };
+
+            begin_frame(frame_index);
+        }
+
+        VkDescriptorSet allocate(VkDescriptorSetLayout layout)
+        {
+            auto& frame = frames_[frame_index_];
+            VkDescriptorSet set = nullptr;
+
+            // fast path: allocate from the current pool of the frame
+            if (!frame.used_pools.empty())
+            {
+                auto result = device_->allocate_descriptor_sets(frame.used_pools.back().handle, 1, &layout, &set);
+                if (VK_SUCCESS == result)
+                {
+                    ++frame.allocated_sets;
+                    return set;
+                }
+
+                if (!is_pool_exhausted(result))
+                    throw std::runtime_error{ "Failed to call vkAllocateDescriptorSets!" };
+
+                // slow path: the current pool is exhausted or fragmented, move on to a larger one
+                pool_sets_ = std::min(pool_sets_ * 2, config_.max_pool_sets);
+            }
+
+            frame.used_pools.push_back(acquire_pool());
+            if (VK_SUCCESS != device_->allocate_descriptor_sets(frame.used_pools.back().handle, 1, &layout, &set))
+                throw std::runtime_error{ "Failed to call vkAllocateDescriptorSets!" };
+
+            ++frame.allocated_sets;
+            return set;
+        }
+
+        uint32_t pool_count() const noexcept
+        {
+            auto count = free_pools_.size();
+            for (auto const& frame : frames_)
+                count += frame.used_pools.size();
+            return static_cast<uint32_t>(count);
+        }
+
+        uint32_t peak_sets_per_frame() const noexcept
+        {
+            return peak_sets_;
+        }
+
+    private:
+        static bool is_pool_exhausted(VkResult result) noexcept
+        {
+            return VK_ERROR_OUT_OF_POOL_MEMORY == result || VK_ERROR_FRAGMENTED_POOL == result;
+        }
+
+        /// the pool ratios are fixed, so a pool's size profile is its set count
+        /// free pools of a smaller profile than the current one would run out early and are dropped
+        pool_t acquire_pool()
+        {
+            while (!free_pools_.empty())
+            {
+                auto pool = free_pools_.back();
+                free_pools_.pop_back();
+                if (pool.max_sets == pool_sets_)
+                    return pool;
+
+                device_->destroy_descriptor_pool(pool.handle);
+            }
+
+            arena_scope_t scope;
+            pool_t pool;
+            pool.max_sets = pool_sets_;
+            pool.handle = device_->create_descriptor_pool_handle(pool.max_sets, make_pool_sizes(scope.get_arena(), pool.max_sets));
+            return pool;
+        }
+
+        // pools grow while a frame is recorded, keep that path off the heap
+        arena_array<VkDescriptorPoolSize> make_pool_sizes(frame_arena_t& arena, uint32_t max_sets) const
+        {
+            arena_array<VkDescriptorPoolSize> pool_sizes{ arena, config_.pool_ratios.size() };
+            for (auto const& pool_ratio : config_.pool_ratios)
+                pool_sizes.push_back({ pool_ratio.type, std::max(1u, static_cast<uint32_t>(pool_ratio.ratio * max_sets)) });
+            return pool_sizes;
+        }
+
+    private:
+        Device const*                   device_;
+        descriptor_allocator_config_t   config_;
+        std::vector<frame_t>            frames_;
+        std::vector<pool_t>             free_pools_;
+        uint32_t                        frame_index_ = 0;
+        uint32_t                        pool_sets_ = 0;
+        uint32_t                        peak_sets_ = 0;
+    };
+
+    // one descriptor in the data blob of an update template
+    union descriptor_info_t
+    {
+        VkDescriptorImageInfo       image;
+        VkDescriptorBufferInfo      buffer;
+        VkBufferView                texel_buffer;
+    };
+
+    namespace detail
+    {
+        template <typename T, typename = void>
+        struct has_descriptor_update_template : std::false_type {};
+        template <typename T>
+        struct has_descriptor_update_template<T, std::void_t<decltype(std::declval<T const&>().update_descriptor_set_with_template(
+            std::declval<VkDescriptorSet>(), std::declval<VkDescriptorUpdateTemplateKHR>(), nullptr))>> : std::true_type {};
+        template <typename T>
+        inline constexpr bool has_descriptor_update_template_v = has_descriptor_update_template<T>::value;
+    }
+
+    /// precompiled update of every binding of a fixed descriptor set layout
+    /// uses vkUpdateDescriptorSetWithTemplateKHR when the device enables the extension
+    template <typename Device>
+    class descriptor_update_template
+    {
+        template <typename>
+        friend class descriptor_writer;
+
+    public:
+        descriptor_update_template(Device const& device, VkDescriptorSetLayout layout,
+            std::vector<VkDescriptorSetLayoutBinding> const& bindings)
+            : device_(&device)
+            , bindings_(bindings)
+        {
+            std::sort(bindings_.begin(), bindings_.end(), [](auto const& lhs, auto const& rhs)
+            {
+                return lhs.binding < rhs.binding;
+            });
+
+            arena_scope_t scope;
+            arena_array<VkDescriptorUpdateTemplateEntryKHR> entries{ scope.get_arena(), bindings_.size() };
+            for (auto const& binding : bindings_)
+            {
+                slots_.push_back(record_size_);
+                entries.push_back({
+                    binding.binding,                                        // uint32_t             dstBinding
+                    0,                                                      // uint32_t             dstArrayElement
+                    binding.descriptorCount,                                // uint32_t             descriptorCount
+                    binding.descriptorType,                                 // VkDescriptorType     descriptorType
+                    record_size_ * sizeof(descriptor_info_t),               // size_t               offset
+                    sizeof(descriptor_info_t)                               // size_t               stride
+                });
+                record_size_ += binding.descriptorCount;
+            }
+
+            if constexpr (detail::has_descriptor_update_template_v<Device>)
+                handle_ = device_->create_descriptor_update_template_handle(layout, entries);
+        }
+
+        ~descriptor_update_template()
+        {
+            if constexpr (detail::has_descriptor_update_template_v<Device>)
+                device_->destroy_descriptor_update_template(handle_);
+        }
+
+        descriptor_update_template(descriptor_update_template const&) = delete;
+        descriptor_update_template& operator=(descriptor_update_template const&) = delete;
+
+        std::vector<descriptor_info_t> make_record() const
+        {
+            return std::vector<descriptor_info_t>(record_size_, descriptor_info_t{});
+        }
+
+        /// index of a descriptor in the record
+        uint32_t slot(uint32_t binding, uint32_t array_element = 0) const
+        {
+            auto itr = std::lower_bound(bindings_.cbegin(), bindings_.cend(), binding, [](auto const& layout_binding, uint32_t value)
+            {
+                return layout_binding.binding < value;
+            });
+            assert(itr != bindings_.cend() && itr->binding == binding && array_element < itr->descriptorCount);
+            return slots_[std::distance(bindings_.cbegin(), itr)] + array_element;
+        }
+
+        bool is_native() const noexcept
+        {
+            return nullptr != handle_;
+        }
+
+    private:
+        Device const*                               device_;
+        std::vector<VkDescriptorSetLayoutBinding>   bindings_;
+        std::vector<uint32_t>                       slots_;
+        uint32_t                                    record_size_ = 0;
+        VkDescriptorUpdateTemplateKHR               handle_ = nullptr;
+    };
+
+    /// accumulates descriptor writes and submits them with one vkUpdateDescriptorSets per batch
+    /// contiguous array elements of one binding are coalesced into a single VkWriteDescriptorSet.
+    /// the storage is kept between batches, use one writer per thread.
+    template <typename Device>
+    class descriptor_writer
+    {
+    public:
+        explicit descriptor_writer(Device const& device, size_t batch_size = 1024)
+            : device_(&device)
+            , batch_size_(batch_size)
+        {
+            writes_.reserve(batch_size_);
+            info_offsets_.reserve(batch_size_);
+        }
+
+        ~descriptor_writer()
+        {
+            flush();
+        }
+
+        descriptor_writer(descriptor_writer const&) = delete;
+        descriptor_writer& operator=(descriptor_writer const&) = delete;
+        descriptor_writer(descriptor_writer&&) = default;
+        descriptor_writer& operator=(descriptor_writer&&) = default;
+
+        descriptor_writer& write_images(VkDescriptorSet set, uint32_t binding, VkDescriptorType type,
+            VkDescriptorImageInfo const* infos, uint32_t count, uint32_t array_element = 0)
+        {
+            assert(detail::is_image_descriptor(type));
+            append(image_infos_, set, binding, type, infos, count, array_element);
+            return *this;
+        }
+
+        descriptor_writer& write_image(VkDescriptorSet set, uint32_t binding, VkDescriptorType type,
+            VkDescriptorImageInfo const& info, uint32_t array_element = 0)
+        {
+            return write_images(set, binding, type, &info, 1, array_element);
+        }
+
+        descriptor_writer& write_buffers(VkDescriptorSet set, uint32_t binding, VkDescriptorType type,
+            VkDescriptorBufferInfo const* infos, uint32_t count, uint32_t array_element = 0)
+        {
+            assert(!detail::is_image_descriptor(type) && !detail::is_texel_buffer_descriptor(type));
+            append(buffer_infos_, set, binding, type, infos, count, array_element);
+            return *this;
+        }
+
+        descriptor_writer& write_buffer(VkDescriptorSet set, uint32_t binding, VkDescriptorType type,
+            VkDescriptorBufferInfo const& info, uint32_t array_element = 0)
+        {
+            return write_buffers(set, binding, type, &info, 1, array_element);
+        }
+
+        descriptor_writer& write_texel_buffers(VkDescriptorSet set, uint32_t binding, VkDescriptorType type,
+            VkBufferView const* views, uint32_t count, uint32_t array_element = 0)
+        {
+            assert(detail::is_texel_buffer_descriptor(type));
+            append(texel_buffer_views_, set, binding, type, views, count, array_element);
+            return *this;
+        }
+
+        /// update every binding of the set from a record made by the template
+        descriptor_writer& write(VkDescriptorSet set, descriptor_update_template<Device> const& update_template,
+            std::vector<descriptor_info_t> const& record)
+        {
+            assert(record.size() == update_template.record_size_);
+            if constexpr (detail::has_descriptor_update_template_v<Device>)
+            {
+                if (update_template.is_native())
+                {
+                    // the queued writes come first, as they do on the fallback path
+                    flush();
+                    device_->update_descriptor_set_with_template(set, update_template.handle_, record.data());
+                    return *this;
+                }
+            }
+
+            // fallback to the batch of plain writes
+            auto slot = record.data();
+            for (auto const& binding : update_template.bindings_)
+            {
+                for (uint32_t i = 0; i < binding.descriptorCount; ++i, ++slot)
+                {
+                    if (detail::is_image_descriptor(binding.descriptorType))
+                        write_image(set, binding.binding, binding.descriptorType, slot->image, i);
+                    else if (detail::is_texel_buffer_descriptor(binding.descriptorType))
+                        write_texel_buffers(set, binding.binding, binding.descriptorType, &slot->texel_buffer, 1, i);
+                    else
+                        write_buffer(set, binding.binding, binding.descriptorType, slot->buffer, i);
+                }
+            }
+            return *this;
+        }
+
+        void flush()
+        {
+            if (writes_.empty())
+                return;
+
+            // the info arrays may have been reallocated while recording, resolve the pointers now
+            for (size_t i = 0; i < writes_.size(); ++i)
+            {
+                auto& write = writes_[i];
+                if (detail::is_image_descriptor(write.descriptorType))
+                    write.pImageInfo = image_infos_.data() + info_offsets_[i];
+                else if (detail::is_texel_buffer_descriptor(write.descriptorType))
+                    write.pTexelBufferView = texel_buffer_views_.data() + info_offsets_[i];
+                else
+                    write.pBufferInfo = buffer_infos_.data() + info_offsets_[i];
+            }
+
+            device_->update_descriptor_sets(static_cast<uint32_t>(writes_.size()), writes_.data());
+
+            writes_.clear();
+            info_offsets_.clear();
+            image_infos_.clear();
+            buffer_infos_.clear();
+            texel_buffer_views_.clear();
+        }
+
+        size_t pending() const noexcept
+        {
+            return writes_.size();
+        }
+
+    private:
+        template <typename Info>
+        void append(std::vector<Info>& infos, VkDescriptorSet set, uint32_t binding, VkDescriptorType type,
+            Info const* src, uint32_t count, uint32_t array_element)
+        {
+            auto const offset = infos.size();
+            infos.insert(infos.end(), src, src + count);
+
+            // extend the previous write when this one continues its array
+            if (!writes_.empty())
+            {
+                auto& last = writes_.back();
+                if (last.dstSet == set && last.dstBinding == binding && last.descriptorType == type &&
+                    last.dstArrayElement + last.descriptorCount == array_element &&
+                    info_offsets_.back() + last.descriptorCount == offset)
+                {
+                    last.descriptorCount += count;
+                    return;
+                }
+            }
+
+            writes_.push_back({
+                VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,             // VkStructureType                  sType
+                nullptr,                                            // const void*                      pNext
+                set,                                                // VkDescriptorSet                  dstSet
+                binding,                                            // uint32_t                         dstBinding
+                array_element,                                      // uint32_t                         dstArrayElement
+                count,                                              // uint32_t                         descriptorCount
+                type,                                               // VkDescriptorType                 descriptorType
+                nullptr,                                            // const VkDescriptorImageInfo*     pImageInfo
+                nullptr,                                            // const VkDescriptorBufferInfo*    pBufferInfo
+                nullptr                                             // const VkBufferView*              pTexelBufferView
+            });
+            info_offsets_.push_back(offset);
+
+            if (writes_.size() >= batch_size_)
+                flush();
+        }
+
+    private:
+        Device const*                           device_;
+        size_t                                  batch_size_;
+        std::vector<VkWriteDescriptorSet>       writes_;
+        std::vector<size_t>                     info_offsets_;
+        std::vector<VkDescriptorImageInfo>      image_infos_;
+        std::vector<VkDescriptorBufferInfo>     buffer_infos_;
+        std::vector<VkBufferView>               texel_buffer_views_;
+    };
+
+    /// small per-draw bindings without descriptor set management
+    /// uses vkCmdPushDescriptorSetKHR when the device's command table has it, i.e. the device was created
+    /// with khr::push_descriptor_ext, otherwise every push allocates a transient set from the fallback
+    /// allocator, writes and binds it. the choice is made once, at construction.
+    template <typename Device>
+    class push_descriptor_binder
+    {
+    public:
+        push_descriptor_binder(Device const& device, std::vector<VkDescriptorSetLayoutBinding> const& bindings,
+            descriptor_allocator<Device>& fallback)
+            : device_(&device)
+            , fallback_(&fallback)
+            , native_(nullptr != device.get_command_table().vkCmdPushDescriptorSetKHR)
+        {
+            VkDescriptorSetLayoutCreateFlags flags = 0;
+            if (native_)
+                flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR;
+
+            layout_ = device.create_descriptor_set_layout(bindings, flags);
+        }
+
+        push_descriptor_binder(push_descriptor_binder const&) = delete;
+        push_descriptor_binder& operator=(push_descriptor_binder const&) = delete;
+
+        /// the set layout to create the pipeline layout with, owned by the device's layout cache
+        VkDescriptorSetLayout get_layout() const noexcept
+        {
+            return layout_;
+        }
+
+        bool is_native() const noexcept
+        {
+            return native_;
+        }
+
+        push_descriptor_binder& image(uint32_t binding, VkDescriptorType type, VkDescriptorImageInfo const& info, uint32_t array_element = 0)
+        {
+            assert(detail::is_image_descriptor(type));
+            add_write(binding, type, array_element, image_infos_.size());
+            image_infos_.push_back(info);
+            return *this;
+        }
+
+        push_descriptor_binder& buffer(uint32_t binding, VkDescriptorType type, VkDescriptorBufferInfo const& info, uint32_t array_element = 0)
+        {
+            assert(!detail::is_image_descriptor(type) && !detail::is_texel_buffer_descriptor(type));
+            add_write(binding, type, array_element, buffer_infos_.size());
+            buffer_infos_.push_back(info);
+            return *this;
+        }
+
+        push_descriptor_binder& texel_buffer(uint32_t binding, VkDescriptorType type, VkBufferView view, uint32_t array_element = 0)
+        {
+            assert(detail::is_texel_buffer_descriptor(type));
+            add_write(binding, type, array_element, texel_buffer_views_.size());
+            texel_buffer_views_.push_back(view);
+            return *this;
+        }
+
+        /// push the collected writes as the set at set_index of the pipeline layout and start over
+        void push(command_recorder<Device>& recorder, VkPipelineBindPoint bind_point, VkPipelineLayout pipeline_layout, uint32_t set_index)
+        {
+            resolve_writes();
+            if (native_)
+            {
+                recorder.push_descriptor_set(bind_point, pipeline_layout, set_index,
+                    static_cast<uint32_t>(writes_.size()), writes_.data());
+            }
+            else
+            {
+                auto set = fallback_->allocate(layout_);
+                for (auto& write : writes_)
+                    write.dstSet = set;
+
+                device_->update_descriptor_sets(static_cast<uint32_t>(writes_.size()), writes_.data());
+                recorder.bind_descriptor_set(bind_point, pipeline_layout, set_index, set);
+            }
+
+            writes_.clear();
+            info_offsets_.clear();
+            image_infos_.clear();
+            buffer_infos_.clear();
+            texel_buffer_views_.clear();
+        }
+
+    private:
+        void add_write(uint32_t binding, VkDescriptorType type, uint32_t array_element, size_t info_offset)
+        {
+            writes_.push_back({
+                VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,             // VkStructureType                  sType
+                nullptr,                                            // const void*                      pNext
+                nullptr,                                            // VkDescriptorSet                  dstSet
+                binding,                                            // uint32_t                         dstBinding
+                array_element,                                      // uint32_t                         dstArrayElement
+                1,                                                  // uint32_t                         descriptorCount
+                type,                                               // VkDescriptorType                 descriptorType
+                nullptr,                                            // const VkDescriptorImageInfo*     pImageInfo
+                nullptr,                                            // const VkDescriptorBufferInfo*    pBufferInfo
+                nullptr                                             // const VkBufferView*              pTexelBufferView
+            });
+            info_offsets_.push_back(info_offset);
+        }
+
+        // the info arrays may have been reallocated while collecting, resolve the pointers now
+        void resolve_writes()
+        {
+            for (size_t i = 0; i < writes_.size(); ++i)
+            {
+                auto& write = writes_[i];
+                if (detail::is_image_descriptor(write.descriptorType))
+                    write.pImageInfo = image_infos_.data() + info_offsets_[i];
+                else if (detail::is_texel_buffer_descriptor(write.descriptorType))
+                    write.pTexelBufferView = texel_buffer_views_.data() + info_offsets_[i];
+                else
+                    write.pBufferInfo = buffer_infos_.data() + info_offsets_[i];
+            }
+        }
+
+    private:
+        Device const*                           device_;
+        descriptor_allocator<Device>*           fallback_;
+        bool                                    native_;
+        VkDescriptorSetLayout                   layout_ = nullptr;
+        std::vector<VkWriteDescriptorSet>       writes_;
+        std::vector<size_t>                     info_offsets_;
+        std::vector<VkDescriptorImageInfo>      image_infos_;
+        std::vector<VkDescriptorBufferInfo>     buffer_infos_;
+        std::vector<VkBufferView>               texel_buffer_views_;
+    };
+}
\ No newline at end of file
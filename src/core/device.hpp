@@ -76,9 +76,12 @@ namespace vk
 
         //device
         template <typename Instance>
-        device(Instance const& instance, VkDevice device)
-            : device_with_extension(instance, device)
-        {}
+        device(Instance const& instance, physical_device_t physical_device, VkDevice device,
+            physical_device_features_t const& enabled_features = {})
+            : device_with_extension(instance, physical_device, device)
+        {
+            this->set_enabled_features(enabled_features);
+        }
 
     private:
         std::vector<queue_t>        queues_;
@@ -91,8 +94,14 @@ namespace vk
 
     protected:
         template <typename Instance>
-        device_extension(Instance const& instance, VkDevice device)
+        device_extension(Instance const& instance, physical_device_t physical_device, VkDevice device)
             : device_(device)
+            , physical_device_(physical_device)
+            , device_properties_(instance.get_physical_device_properties(physical_device))
+            , memory_properties_(instance.get_physical_device_memory_properties(physical_device))
+            , layout_cache_(std::make_unique<layout_cache_t>())
+            , sampler_cache_(std::make_unique<sampler_cache_t>())
+            , render_pass_cache_(std::make_unique<render_pass_cache_t>())
         {
             VULKAN_LOAD_DEVICE_FUNCTION(vkGetDeviceQueue);
             VULKAN_LOAD_DEVICE_FUNCTION(vkDeviceWaitIdle);
@@ -110,6 +119,7 @@ namespace vk
             VULKAN_LOAD_DEVICE_FUNCTION(vkFlushMappedMemoryRanges);
             VULKAN_LOAD_DEVICE_FUNCTION(vkUnmapMemory);
             VULKAN_LOAD_DEVICE_FUNCTION(vkCmdCopyBuffer);
+            VULKAN_LOAD_DEVICE_FUNCTION(vkCmdFillBuffer);
             VULKAN_LOAD_DEVICE_FUNCTION(vkCmdCopyBufferToImage);
             VULKAN_LOAD_DEVICE_FUNCTION(vkCmdCopyImageToBuffer);
             VULKAN_LOAD_DEVICE_FUNCTION(vkBeginCommandBuffer);
@@ -124,6 +134,7 @@ namespace vk
             VULKAN_LOAD_DEVICE_FUNCTION(vkCreateSemaphore);
             VULKAN_LOAD_DEVICE_FUNCTION(vkCreateFence);
             VULKAN_LOAD_DEVICE_FUNCTION(vkWaitForFences);
+            VULKAN_LOAD_DEVICE_FUNCTION(vkGetFenceStatus);
             VULKAN_LOAD_DEVICE_FUNCTION(vkResetFences);
             VULKAN_LOAD_DEVICE_FUNCTION(vkDestroyFence);
             VULKAN_LOAD_DEVICE_FUNCTION(vkDestroySemaphore);
@@ -160,6 +171,8 @@ namespace vk
             VULKAN_LOAD_DEVICE_FUNCTION(vkCreateComputePipelines);
             VULKAN_LOAD_DEVICE_FUNCTION(vkDestroyPipeline);
             VULKAN_LOAD_DEVICE_FUNCTION(vkDestroyEvent);
+            VULKAN_LOAD_DEVICE_FUNCTION(vkCreateQueryPool);
+            VULKAN_LOAD_DEVICE_FUNCTION(vkGetQueryPoolResults);
             VULKAN_LOAD_DEVICE_FUNCTION(vkDestroyQueryPool);
             VULKAN_LOAD_DEVICE_FUNCTION(vkCreateShaderModule);
             VULKAN_LOAD_DEVICE_FUNCTION(vkDestroyShaderModule);
@@ -171,6 +184,7 @@ namespace vk
             VULKAN_LOAD_DEVICE_FUNCTION(vkCmdBindVertexBuffers);
             VULKAN_LOAD_DEVICE_FUNCTION(vkCmdDraw);
             VULKAN_LOAD_DEVICE_FUNCTION(vkCmdDrawIndexed);
+            VULKAN_LOAD_DEVICE_FUNCTION(vkCmdDrawIndexedIndirect);
             VULKAN_LOAD_DEVICE_FUNCTION(vkCmdDispatch);
             VULKAN_LOAD_DEVICE_FUNCTION(vkCmdCopyImage);
             VULKAN_LOAD_DEVICE_FUNCTION(vkCmdPushConstants);
@@ -182,12 +196,56 @@ namespace vk
             VULKAN_LOAD_DEVICE_FUNCTION(vkCmdSetBlendConstants);
             VULKAN_LOAD_DEVICE_FUNCTION(vkCmdExecuteCommands);
             VULKAN_LOAD_DEVICE_FUNCTION(vkCmdClearAttachments);
+            VULKAN_LOAD_DEVICE_FUNCTION(vkCmdResetQueryPool);
+            VULKAN_LOAD_DEVICE_FUNCTION(vkCmdWriteTimestamp);
+
+            command_table_.vkCmdBindPipeline = vkCmdBindPipeline;
+            command_table_.vkCmdBindDescriptorSets = vkCmdBindDescriptorSets;
+            command_table_.vkCmdBindVertexBuffers = vkCmdBindVertexBuffers;
+            command_table_.vkCmdBindIndexBuffer = vkCmdBindIndexBuffer;
+            command_table_.vkCmdSetViewport = vkCmdSetViewport;
+            command_table_.vkCmdSetScissor = vkCmdSetScissor;
+            command_table_.vkCmdPushConstants = vkCmdPushConstants;
+            command_table_.vkCmdDraw = vkCmdDraw;
+            command_table_.vkCmdDrawIndexed = vkCmdDrawIndexed;
+            command_table_.vkCmdDrawIndexedIndirect = vkCmdDrawIndexedIndirect;
+            command_table_.vkCmdDispatch = vkCmdDispatch;
+            command_table_.vkCmdCopyBuffer = vkCmdCopyBuffer;
+            command_table_.vkCmdFillBuffer = vkCmdFillBuffer;
+            command_table_.vkCmdCopyImage = vkCmdCopyImage;
+            command_table_.vkCmdCopyBufferToImage = vkCmdCopyBufferToImage;
+            command_table_.vkCmdCopyImageToBuffer = vkCmdCopyImageToBuffer;
+            command_table_.vkCmdBeginRenderPass = vkCmdBeginRenderPass;
+            command_table_.vkCmdEndRenderPass = vkCmdEndRenderPass;
+            command_table_.vkCmdExecuteCommands = vkCmdExecuteCommands;
+            command_table_.vkCmdResetQueryPool = vkCmdResetQueryPool;
+            command_table_.vkCmdWriteTimestamp = vkCmdWriteTimestamp;
+            command_table_.vkCmdPipelineBarrier = vkCmdPipelineBarrier;
         }
 
         ~device_extension()
         {
-            if (nullptr != device_)
-                vkDestroyDevice(device_, nullptr);
+            if (nullptr == device_)
+                return;
+
+            if (nullptr != layout_cache_)
+            {
+                layout_cache_->clear(
+                    [this](VkPipelineLayout layout) { vkDestroyPipelineLayout(device_, layout, nullptr); },
+                    [this](VkDescriptorSetLayout layout) { vkDestroyDescriptorSetLayout(device_, layout, nullptr); });
+            }
+
+            if (nullptr != render_pass_cache_)
+            {
+                render_pass_cache_->clear(
+                    [this](VkFramebuffer framebuffer) { vkDestroyFramebuffer(device_, framebuffer, nullptr); },
+                    [this](VkRenderPass render_pass) { vkDestroyRenderPass(device_, render_pass, nullptr); });
+            }
+
+            if (nullptr != sampler_cache_)
+                sampler_cache_->clear([this](VkSampler sampler) { vkDestroySampler(device_, sampler, nullptr); });
+
+            vkDestroyDevice(device_, nullptr);
         }
 
         this_type& get() noexcept
@@ -200,6 +258,17 @@ namespace vk
             return *static_cast<this_type const*>(this);
         }
 
+        /// extensions add their recording entry points to the table the recorders use
+        command_table_t& get_extension_command_table() noexcept
+        {
+            return command_table_;
+        }
+
+        void set_enabled_features(physical_device_features_t const& features) noexcept
+        {
+            enabled_features_ = features;
+        }
+
         device_extension(device_extension const&) = delete;
         device_extension& operator=(device_extension const&) = delete;
         device_extension(device_extension&&) = default;
@@ -210,8 +279,699 @@ namespace vk
             return device_;
         }
 
+        physical_device_t get_physical_device() const noexcept
+        {
+            return physical_device_;
+        }
+
+    public:
+        command_table_t const& get_command_table() const noexcept
+        {
+            return command_table_;
+        }
+
+        physical_device_properties_t const& get_physical_device_properties() const noexcept
+        {
+            return device_properties_;
+        }
+
+        /// the core features create_logical_device enabled
+        physical_device_features_t const& get_enabled_features() const noexcept
+        {
+            return enabled_features_;
+        }
+
+        /// the draws one indirect call may take, 1 unless multiDrawIndirect is enabled
+        uint32_t get_max_draw_indirect_count() const noexcept
+        {
+            return VK_FALSE != enabled_features_.multiDrawIndirect ? device_properties_.limits.maxDrawIndirectCount : 1;
+        }
+
+        bool wait_for_fence(VkFence fence, uint64_t timeout = UINT64_MAX) const
+        {
+            return VK_SUCCESS == vkWaitForFences(device_, 1, &fence, VK_TRUE, timeout);
+        }
+
+        bool is_fence_signaled(VkFence fence) const
+        {
+            return VK_SUCCESS == vkGetFenceStatus(device_, fence);
+        }
+
+        void wait_idle() const
+        {
+            vkDeviceWaitIdle(device_);
+        }
+
+        VkQueue get_device_queue(uint32_t family_index, uint32_t queue_index = 0) const
+        {
+            VkQueue queue = nullptr;
+            vkGetDeviceQueue(device_, family_index, queue_index, &queue);
+            return queue;
+        }
+
+        VkFence create_fence_handle(bool signaled = false) const
+        {
+            VkFenceCreateInfo create_info =
+            {
+                VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,                        // VkStructureType                  sType
+                nullptr,                                                    // const void*                      pNext
+                signaled ? VK_FENCE_CREATE_SIGNALED_BIT : 0u                // VkFenceCreateFlags               flags
+            };
+
+            VkFence fence = nullptr;
+            if (VK_SUCCESS != vkCreateFence(device_, &create_info, nullptr, &fence))
+                throw std::runtime_error{ "Failed to call vkCreateFence!" };
+
+            return fence;
+        }
+
+        void destroy_fence(VkFence fence) const
+        {
+            if (nullptr != fence)
+                vkDestroyFence(device_, fence, nullptr);
+        }
+
+        void reset_fence(VkFence fence) const
+        {
+            vkResetFences(device_, 1, &fence);
+        }
+
+        VkSemaphore create_semaphore_handle() const
+        {
+            VkSemaphoreCreateInfo create_info =
+            {
+                VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,                    // VkStructureType                  sType
+                nullptr,                                                    // const void*                      pNext
+                0                                                           // VkSemaphoreCreateFlags           flags
+            };
+
+            VkSemaphore semaphore = nullptr;
+            if (VK_SUCCESS != vkCreateSemaphore(device_, &create_info, nullptr, &semaphore))
+                throw std::runtime_error{ "Failed to call vkCreateSemaphore!" };
+
+            return semaphore;
+        }
+
+        void destroy_semaphore(VkSemaphore semaphore) const
+        {
+            if (nullptr != semaphore)
+                vkDestroySemaphore(device_, semaphore, nullptr);
+        }
+
+        VkCommandPool create_command_pool_handle(uint32_t family_index, VkCommandPoolCreateFlags flags = 0) const
+        {
+            VkCommandPoolCreateInfo create_info =
+            {
+                VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,                 // VkStructureType                  sType
+                nullptr,                                                    // const void*                      pNext
+                flags,                                                      // VkCommandPoolCreateFlags         flags
+                family_index                                                // uint32_t                         queueFamilyIndex
+            };
+
+            VkCommandPool pool = nullptr;
+            if (VK_SUCCESS != vkCreateCommandPool(device_, &create_info, nullptr, &pool))
+                throw std::runtime_error{ "Failed to call vkCreateCommandPool!" };
+
+            return pool;
+        }
+
+        void destroy_command_pool(VkCommandPool pool) const
+        {
+            if (nullptr != pool)
+                vkDestroyCommandPool(device_, pool, nullptr);
+        }
+
+        void reset_command_pool(VkCommandPool pool) const
+        {
+            vkResetCommandPool(device_, pool, 0);
+        }
+
+        VkQueryPool create_query_pool_handle(VkQueryType type, uint32_t query_count) const
+        {
+            VkQueryPoolCreateInfo create_info =
+            {
+                VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,                   // VkStructureType                  sType
+                nullptr,                                                    // const void*                      pNext
+                0,                                                          // VkQueryPoolCreateFlags           flags
+                type,                                                       // VkQueryType                      queryType
+                query_count,                                                // uint32_t                         queryCount
+                0                                                           // VkQueryPipelineStatisticFlags    pipelineStatistics
+            };
+
+            VkQueryPool pool = nullptr;
+            if (VK_SUCCESS != vkCreateQueryPool(device_, &create_info, nullptr, &pool))
+                throw std::runtime_error{ "Failed to call vkCreateQueryPool!" };
+
+            return pool;
+        }
+
+        void destroy_query_pool(VkQueryPool pool) const
+        {
+            if (nullptr != pool)
+                vkDestroyQueryPool(device_, pool, nullptr);
+        }
+
+        /// 64 bit results without waiting, false while any of the queries is unavailable
+        bool get_query_pool_results(VkQueryPool pool, uint32_t first_query, uint32_t query_count, uint64_t* results) const
+        {
+            auto result = vkGetQueryPoolResults(device_, pool, first_query, query_count,
+                query_count * sizeof(uint64_t), results, sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+            if (VK_NOT_READY == result)
+                return false;
+
+            if (VK_SUCCESS != result)
+                throw std::runtime_error{ "Failed to call vkGetQueryPoolResults!" };
+
+            return true;
+        }
+
+        VkCommandBuffer allocate_command_buffer(VkCommandPool pool, VkCommandBufferLevel level = VK_COMMAND_BUFFER_LEVEL_PRIMARY) const
+        {
+            VkCommandBufferAllocateInfo allocate_info =
+            {
+                VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,             // VkStructureType                  sType
+                nullptr,                                                    // const void*                      pNext
+                pool,                                                       // VkCommandPool                    commandPool
+                level,                                                      // VkCommandBufferLevel             level
+                1                                                           // uint32_t                         commandBufferCount
+            };
+
+            VkCommandBuffer command_buffer = nullptr;
+            if (VK_SUCCESS != vkAllocateCommandBuffers(device_, &allocate_info, &command_buffer))
+                throw std::runtime_error{ "Failed to call vkAllocateCommandBuffers!" };
+
+            return command_buffer;
+        }
+
+        void begin_command_buffer(VkCommandBuffer command_buffer,
+            VkCommandBufferUsageFlags flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT) const
+        {
+            VkCommandBufferBeginInfo begin_info =
+            {
+                VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,                // VkStructureType                  sType
+                nullptr,                                                    // const void*                      pNext
+                flags,                                                      // VkCommandBufferUsageFlags        flags
+                nullptr                                                     // const VkCommandBufferInheritanceInfo* pInheritanceInfo
+            };
+
+            if (VK_SUCCESS != vkBeginCommandBuffer(command_buffer, &begin_info))
+                throw std::runtime_error{ "Failed to call vkBeginCommandBuffer!" };
+        }
+
+        void end_command_buffer(VkCommandBuffer command_buffer) const
+        {
+            if (VK_SUCCESS != vkEndCommandBuffer(command_buffer))
+                throw std::runtime_error{ "Failed to call vkEndCommandBuffer!" };
+        }
+
+        void queue_submit(VkQueue queue, uint32_t submit_count, VkSubmitInfo const* submits, VkFence fence = nullptr) const
+        {
+            if (VK_SUCCESS != vkQueueSubmit(queue, submit_count, submits, fence))
+                throw std::runtime_error{ "Failed to call vkQueueSubmit!" };
+        }
+
+        uint32_t find_memory_type(uint32_t type_bits, VkMemoryPropertyFlags properties) const noexcept
+        {
+            for (uint32_t i = 0; i < memory_properties_.memoryTypeCount; ++i)
+            {
+                if ((type_bits & (1u << i)) != 0 &&
+                    (memory_properties_.memoryTypes[i].propertyFlags & properties) == properties)
+                    return i;
+            }
+            return invalid_index;
+        }
+
+        VkDeviceMemory allocate_memory_handle(VkDeviceSize size, uint32_t memory_type_index) const
+        {
+            VkMemoryAllocateInfo allocate_info =
+            {
+                VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,             // VkStructureType                  sType
+                nullptr,                                            // const void*                      pNext
+                size,                                               // VkDeviceSize                     allocationSize
+                memory_type_index                                   // uint32_t                         memoryTypeIndex
+            };
+
+            VkDeviceMemory memory = nullptr;
+            if (VK_SUCCESS != vkAllocateMemory(device_, &allocate_info, nullptr, &memory))
+                throw std::runtime_error{ "Failed to call vkAllocateMemory!" };
+
+            return memory;
+        }
+
+        void free_memory(VkDeviceMemory memory) const
+        {
+            if (nullptr != memory)
+                vkFreeMemory(device_, memory, nullptr);
+        }
+
+        void* map_memory(VkDeviceMemory memory, VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE) const
+        {
+            void* data = nullptr;
+            if (VK_SUCCESS != vkMapMemory(device_, memory, offset, size, 0, &data))
+                throw std::runtime_error{ "Failed to call vkMapMemory!" };
+
+            return data;
+        }
+
+        void unmap_memory(VkDeviceMemory memory) const
+        {
+            vkUnmapMemory(device_, memory);
+        }
+
+        VkImage create_image_handle(VkImageCreateInfo const& create_info) const
+        {
+            VkImage image = nullptr;
+            if (VK_SUCCESS != vkCreateImage(device_, &create_info, nullptr, &image))
+                throw std::runtime_error{ "Failed to call vkCreateImage!" };
+
+            return image;
+        }
+
+        void destroy_image(VkImage image) const
+        {
+            if (nullptr != image)
+                vkDestroyImage(device_, image, nullptr);
+        }
+
+        VkMemoryRequirements get_image_memory_requirements(VkImage image) const
+        {
+            VkMemoryRequirements requirements;
+            vkGetImageMemoryRequirements(device_, image, &requirements);
+            return requirements;
+        }
+
+        void bind_image_memory(VkImage image, VkDeviceMemory memory, VkDeviceSize offset = 0) const
+        {
+            if (VK_SUCCESS != vkBindImageMemory(device_, image, memory, offset))
+                throw std::runtime_error{ "Failed to call vkBindImageMemory!" };
+        }
+
+        VkBuffer create_buffer_handle(VkBufferCreateInfo const& create_info) const
+        {
+            VkBuffer buffer = nullptr;
+            if (VK_SUCCESS != vkCreateBuffer(device_, &create_info, nullptr, &buffer))
+                throw std::runtime_error{ "Failed to call vkCreateBuffer!" };
+
+            return buffer;
+        }
+
+        void destroy_buffer(VkBuffer buffer) const
+        {
+            if (nullptr != buffer)
+                vkDestroyBuffer(device_, buffer, nullptr);
+        }
+
+        VkMemoryRequirements get_buffer_memory_requirements(VkBuffer buffer) const
+        {
+            VkMemoryRequirements requirements;
+            vkGetBufferMemoryRequirements(device_, buffer, &requirements);
+            return requirements;
+        }
+
+        void bind_buffer_memory(VkBuffer buffer, VkDeviceMemory memory, VkDeviceSize offset = 0) const
+        {
+            if (VK_SUCCESS != vkBindBufferMemory(device_, buffer, memory, offset))
+                throw std::runtime_error{ "Failed to call vkBindBufferMemory!" };
+        }
+
+        void pipeline_barrier(VkCommandBuffer command_buffer,
+            VkPipelineStageFlags src_stages, VkPipelineStageFlags dst_stages,
+            uint32_t memory_barrier_count, VkMemoryBarrier const* memory_barriers,
+            uint32_t buffer_barrier_count, VkBufferMemoryBarrier const* buffer_barriers,
+            uint32_t image_barrier_count, VkImageMemoryBarrier const* image_barriers) const
+        {
+            vkCmdPipelineBarrier(command_buffer, src_stages, dst_stages, 0,
+                memory_barrier_count, memory_barriers,
+                buffer_barrier_count, buffer_barriers,
+                image_barrier_count, image_barriers);
+        }
+
+        VkDescriptorPool create_descriptor_pool_handle(
+            uint32_t max_sets,
+            span<VkDescriptorPoolSize const> pool_sizes,
+            VkDescriptorPoolCreateFlags flags = 0) const
+        {
+            VkDescriptorPoolCreateInfo create_info =
+            {
+                VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,      // VkStructureType                  sType
+                nullptr,                                            // const void*                      pNext
+                flags,                                              // VkDescriptorPoolCreateFlags      flags
+                max_sets,                                           // uint32_t                         maxSets
+                static_cast<uint32_t>(pool_sizes.size()),           // uint32_t                         poolSizeCount
+                pool_sizes.data()                                   // const VkDescriptorPoolSize*      pPoolSizes
+            };
+
+            VkDescriptorPool pool = nullptr;
+            if (VK_SUCCESS != vkCreateDescriptorPool(device_, &create_info, nullptr, &pool))
+                throw std::runtime_error{ "Failed to call vkCreateDescriptorPool!" };
+
+            return pool;
+        }
+
+        void destroy_descriptor_pool(VkDescriptorPool pool) const
+        {
+            if (nullptr != pool)
+                vkDestroyDescriptorPool(device_, pool, nullptr);
+        }
+
+        VkResult allocate_descriptor_sets(VkDescriptorPool pool, uint32_t count,
+            VkDescriptorSetLayout const* layouts, VkDescriptorSet* sets) const
+        {
+            VkDescriptorSetAllocateInfo allocate_info =
+            {
+                VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,     // VkStructureType                  sType
+                nullptr,                                            // const void*                      pNext
+                pool,                                               // VkDescriptorPool                 descriptorPool
+                count,                                              // uint32_t                         descriptorSetCount
+                layouts                                             // const VkDescriptorSetLayout*     pSetLayouts
+            };
+
+            return vkAllocateDescriptorSets(device_, &allocate_info, sets);
+        }
+
+        void free_descriptor_sets(VkDescriptorPool pool, uint32_t count, VkDescriptorSet const* sets) const
+        {
+            vkFreeDescriptorSets(device_, pool, count, sets);
+        }
+
+        void reset_descriptor_pool(VkDescriptorPool pool) const
+        {
+            vkResetDescriptorPool(device_, pool, 0);
+        }
+
+        void update_descriptor_sets(uint32_t write_count, VkWriteDescriptorSet const* writes,
+            uint32_t copy_count = 0, VkCopyDescriptorSet const* copies = nullptr) const
+        {
+            vkUpdateDescriptorSets(device_, write_count, writes, copy_count, copies);
+        }
+
+        /// structurally identical layouts share one handle, which is owned by the device
+        VkDescriptorSetLayout create_descriptor_set_layout(
+            std::vector<VkDescriptorSetLayoutBinding> const& bindings,
+            VkDescriptorSetLayoutCreateFlags flags = 0) const
+        {
+            return layout_cache_->get_descriptor_set_layout(bindings, flags,
+                [this](auto const& layout_bindings, auto layout_flags)
+            {
+                VkDescriptorSetLayoutCreateInfo create_info =
+                {
+                    VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,    // VkStructureType                      sType
+                    nullptr,                                                // const void*                          pNext
+                    layout_flags,                                           // VkDescriptorSetLayoutCreateFlags     flags
+                    static_cast<uint32_t>(layout_bindings.size()),          // uint32_t                             bindingCount
+                    layout_bindings.data()                                  // const VkDescriptorSetLayoutBinding*  pBindings
+                };
+
+                VkDescriptorSetLayout layout = nullptr;
+                if (VK_SUCCESS != vkCreateDescriptorSetLayout(device_, &create_info, nullptr, &layout))
+                    throw std::runtime_error{ "Failed to call vkCreateDescriptorSetLayout!" };
+
+                return layout;
+            });
+        }
+
+        /// a layout outside the cache, for create infos the cache does not key on like a pNext chain
+        /// it is owned by the caller and destroyed with destroy_descriptor_set_layout
+        VkDescriptorSetLayout create_descriptor_set_layout_handle(VkDescriptorSetLayoutCreateInfo const& create_info) const
+        {
+            VkDescriptorSetLayout layout = nullptr;
+            if (VK_SUCCESS != vkCreateDescriptorSetLayout(device_, &create_info, nullptr, &layout))
+                throw std::runtime_error{ "Failed to call vkCreateDescriptorSetLayout!" };
+
+            return layout;
+        }
+
+        void destroy_descriptor_set_layout(VkDescriptorSetLayout layout) const
+        {
+            if (nullptr != layout)
+                vkDestroyDescriptorSetLayout(device_, layout, nullptr);
+        }
+
+        /// pipeline layouts from the same set layouts and push constant ranges share one handle
+        VkPipelineLayout create_pipeline_layout(
+            std::vector<VkDescriptorSetLayout> const& set_layouts,
+            std::vector<VkPushConstantRange> const& push_constant_ranges = {}) const
+        {
+            return layout_cache_->get_pipeline_layout(set_layouts, push_constant_ranges,
+                [this](auto const& layouts, auto const& ranges)
+            {
+                VkPipelineLayoutCreateInfo create_info =
+                {
+                    VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,          // VkStructureType                      sType
+                    nullptr,                                                // const void*                          pNext
+                    0,                                                      // VkPipelineLayoutCreateFlags          flags
+                    static_cast<uint32_t>(layouts.size()),                  // uint32_t                             setLayoutCount
+                    layouts.data(),                                         // const VkDescriptorSetLayout*         pSetLayouts
+                    static_cast<uint32_t>(ranges.size()),                   // uint32_t                             pushConstantRangeCount
+                    ranges.data()                                           // const VkPushConstantRange*           pPushConstantRanges
+                };
+
+                VkPipelineLayout layout = nullptr;
+                if (VK_SUCCESS != vkCreatePipelineLayout(device_, &create_info, nullptr, &layout))
+                    throw std::runtime_error{ "Failed to call vkCreatePipelineLayout!" };
+
+                return layout;
+            });
+        }
+
+        VkShaderModule create_shader_module_handle(span<uint32_t const> code) const
+        {
+            VkShaderModuleCreateInfo create_info =
+            {
+                VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,            // VkStructureType                      sType
+                nullptr,                                                // const void*                          pNext
+                0,                                                      // VkShaderModuleCreateFlags            flags
+                code.size() * sizeof(uint32_t),                         // size_t                               codeSize
+                code.data()                                             // const uint32_t*                      pCode
+            };
+
+            VkShaderModule module = nullptr;
+            if (VK_SUCCESS != vkCreateShaderModule(device_, &create_info, nullptr, &module))
+                throw std::runtime_error{ "Failed to call vkCreateShaderModule!" };
+
+            return module;
+        }
+
+        void destroy_shader_module(VkShaderModule module) const
+        {
+            if (nullptr != module)
+                vkDestroyShaderModule(device_, module, nullptr);
+        }
+
+        /// the shader module may be destroyed once the pipeline is created
+        VkPipeline create_compute_pipeline_handle(VkShaderModule module, VkPipelineLayout layout,
+            char const* entry_point = "main", VkSpecializationInfo const* specialization = nullptr, VkPipelineCache cache = nullptr) const
+        {
+            VkComputePipelineCreateInfo create_info =
+            {
+                VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,         // VkStructureType                      sType
+                nullptr,                                                // const void*                          pNext
+                0,                                                      // VkPipelineCreateFlags                flags
+                {
+                    VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,// VkStructureType                      sType
+                    nullptr,                                            // const void*                          pNext
+                    0,                                                  // VkPipelineShaderStageCreateFlags     flags
+                    VK_SHADER_STAGE_COMPUTE_BIT,                        // VkShaderStageFlagBits                stage
+                    module,                                             // VkShaderModule                       module
+                    entry_point,                                        // const char*                          pName
+                    specialization                                      // const VkSpecializationInfo*          pSpecializationInfo
+                },                                                      // VkPipelineShaderStageCreateInfo      stage
+                layout,                                                 // VkPipelineLayout                     layout
+                nullptr,                                                // VkPipeline                           basePipelineHandle
+                -1                                                      // int32_t                              basePipelineIndex
+            };
+
+            VkPipeline pipeline = nullptr;
+            if (VK_SUCCESS != vkCreateComputePipelines(device_, cache, 1, &create_info, nullptr, &pipeline))
+                throw std::runtime_error{ "Failed to call vkCreateComputePipelines!" };
+
+            return pipeline;
+        }
+
+        /// next replaces the pNext of the create info, link the create info's own chain behind it
+        VkPipeline create_graphics_pipeline_handle(VkGraphicsPipelineCreateInfo create_info, void const* next,
+            VkPipelineCache cache = nullptr) const
+        {
+            create_info.pNext = next;
+            VkPipeline pipeline = nullptr;
+            if (VK_SUCCESS != vkCreateGraphicsPipelines(device_, cache, 1, &create_info, nullptr, &pipeline))
+                throw std::runtime_error{ "Failed to call vkCreateGraphicsPipelines!" };
+
+            return pipeline;
+        }
+
+        VkPipeline create_graphics_pipeline_handle(VkGraphicsPipelineCreateInfo const& create_info, VkPipelineCache cache = nullptr) const
+        {
+            return create_graphics_pipeline_handle(create_info, create_info.pNext, cache);
+        }
+
+        void destroy_pipeline(VkPipeline pipeline) const
+        {
+            if (nullptr != pipeline)
+                vkDestroyPipeline(device_, pipeline, nullptr);
+        }
+
+        /// samplers with the same state are shared, the reference keeps the sampler alive
+        shared_sampler_t create_sampler(VkSamplerCreateInfo const& create_info) const
+        {
+            return sampler_cache_->get(create_info, [this](auto const& sampler_create_info)
+            {
+                VkSampler sampler = nullptr;
+                if (VK_SUCCESS != vkCreateSampler(device_, &sampler_create_info, nullptr, &sampler))
+                    throw std::runtime_error{ "Failed to call vkCreateSampler!" };
+
+                return sampler;
+            });
+        }
+
+        /// destroy the cached samplers which are no longer referenced
+        size_t trim_samplers() const
+        {
+            return sampler_cache_->trim([this](VkSampler sampler) { vkDestroySampler(device_, sampler, nullptr); });
+        }
+
+        /// image views destroyed through the device evict the cached framebuffers using them
+        object<VkImageView> create_image_view(VkImageViewCreateInfo const& create_info) const
+        {
+            VkImageView view = nullptr;
+            if (VK_SUCCESS != vkCreateImageView(device_, &create_info, nullptr, &view))
+                throw std::runtime_error{ "Failed to call vkCreateImageView!" };
+
+            return object<VkImageView>{ view, [this](VkImageView view) {
+                destroy_image_view(view);
+            } };
+        }
+
+        void destroy_image_view(VkImageView view) const
+        {
+            if (nullptr == view)
+                return;
+
+            render_pass_cache_->evict_image_view(view, [this](VkFramebuffer framebuffer) {
+                vkDestroyFramebuffer(device_, framebuffer, nullptr);
+            });
+            vkDestroyImageView(device_, view, nullptr);
+        }
+
+        /// render passes with the same attachments share one handle, which is owned by the device
+        VkRenderPass create_render_pass(render_pass_key_t const& key) const
+        {
+            return render_pass_cache_->get_render_pass(key, [this](auto const& render_pass_key)
+            {
+                std::array<VkAttachmentDescription, max_color_attachments + 1> attachments;
+                std::array<VkAttachmentReference, max_color_attachments> color_references;
+                VkAttachmentReference depth_reference = { render_pass_key.color_count, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL };
+
+                auto describe = [](attachment_key_t const& attachment) -> VkAttachmentDescription
+                {
+                    return {
+                        0,                                                  // VkAttachmentDescriptionFlags     flags
+                        attachment.format,                                  // VkFormat                         format
+                        attachment.samples,                                 // VkSampleCountFlagBits            samples
+                        attachment.load_op,                                 // VkAttachmentLoadOp               loadOp
+                        attachment.store_op,                                // VkAttachmentStoreOp              storeOp
+                        attachment.stencil_load_op,                         // VkAttachmentLoadOp               stencilLoadOp
+                        attachment.stencil_store_op,                        // VkAttachmentStoreOp              stencilStoreOp
+                        attachment.initial_layout,                          // VkImageLayout                    initialLayout
+                        attachment.final_layout                             // VkImageLayout                    finalLayout
+                    };
+                };
+
+                for (uint32_t i = 0; i < render_pass_key.color_count; ++i)
+                {
+                    attachments[i] = describe(render_pass_key.colors[i]);
+                    color_references[i] = { i, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL };
+                }
+                if (render_pass_key.has_depth)
+                    attachments[render_pass_key.color_count] = describe(render_pass_key.depth);
+
+                VkSubpassDescription subpass =
+                {
+                    0,                                                      // VkSubpassDescriptionFlags        flags
+                    VK_PIPELINE_BIND_POINT_GRAPHICS,                        // VkPipelineBindPoint              pipelineBindPoint
+                    0,                                                      // uint32_t                         inputAttachmentCount
+                    nullptr,                                                // const VkAttachmentReference*     pInputAttachments
+                    render_pass_key.color_count,                            // uint32_t                         colorAttachmentCount
+                    color_references.data(),                                // const VkAttachmentReference*     pColorAttachments
+                    nullptr,                                                // const VkAttachmentReference*     pResolveAttachments
+                    render_pass_key.has_depth ? &depth_reference : nullptr, // const VkAttachmentReference*     pDepthStencilAttachment
+                    0,                                                      // uint32_t                         preserveAttachmentCount
+                    nullptr                                                 // const uint32_t*                  pPreserveAttachments
+                };
+
+                VkRenderPassCreateInfo create_info =
+                {
+                    VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,              // VkStructureType                  sType
+                    nullptr,                                                // const void*                      pNext
+                    0,                                                      // VkRenderPassCreateFlags          flags
+                    render_pass_key.attachment_count(),                     // uint32_t                         attachmentCount
+                    attachments.data(),                                     // const VkAttachmentDescription*   pAttachments
+                    1,                                                      // uint32_t                         subpassCount
+                    &subpass,                                               // const VkSubpassDescription*      pSubpasses
+                    0,                                                      // uint32_t                         dependencyCount
+                    nullptr                                                 // const VkSubpassDependency*       pDependencies
+                };
+
+                VkRenderPass render_pass = nullptr;
+                if (VK_SUCCESS != vkCreateRenderPass(device_, &create_info, nullptr, &render_pass))
+                    throw std::runtime_error{ "Failed to call vkCreateRenderPass!" };
+
+                return render_pass;
+            });
+        }
+
+        /// framebuffers are cached by render pass, views and size, until one of the views is destroyed
+        VkFramebuffer create_framebuffer(VkRenderPass render_pass, std::initializer_list<VkImageView> views,
+            extent_2d_t extent, uint32_t layers = 1) const
+        {
+            return create_framebuffer(render_pass, views.begin(), static_cast<uint32_t>(views.size()), extent, layers);
+        }
+
+        VkFramebuffer create_framebuffer(VkRenderPass render_pass, VkImageView const* views, uint32_t view_count,
+            extent_2d_t extent, uint32_t layers = 1) const
+        {
+            assert(view_count <= max_color_attachments + 1);
+
+            framebuffer_key_t key;
+            key.render_pass = render_pass;
+            key.view_count = view_count;
+            key.extent = extent;
+            key.layers = layers;
+            std::copy(views, views + view_count, key.views.begin());
+
+            return render_pass_cache_->get_framebuffer(key, [this](auto const& framebuffer_key)
+            {
+                VkFramebufferCreateInfo create_info =
+                {
+                    VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,              // VkStructureType                  sType
+                    nullptr,                                                // const void*                      pNext
+                    0,                                                      // VkFramebufferCreateFlags         flags
+                    framebuffer_key.render_pass,                            // VkRenderPass                     renderPass
+                    framebuffer_key.view_count,                             // uint32_t                         attachmentCount
+                    framebuffer_key.views.data(),                           // const VkImageView*               pAttachments
+                    framebuffer_key.extent.width,                           // uint32_t                         width
+                    framebuffer_key.extent.height,                          // uint32_t                         height
+                    framebuffer_key.layers                                  // uint32_t                         layers
+                };
+
+                VkFramebuffer framebuffer = nullptr;
+                if (VK_SUCCESS != vkCreateFramebuffer(device_, &create_info, nullptr, &framebuffer))
+                    throw std::runtime_error{ "Failed to call vkCreateFramebuffer!" };
+
+                return framebuffer;
+            });
+        }
+
     private:
-        VkDevice        device_;
+        VkDevice                                device_;
+        physical_device_t                       physical_device_;
+        physical_device_properties_t            device_properties_;
+        physical_device_features_t              enabled_features_ = {};
+        VkPhysicalDeviceMemoryProperties        memory_properties_;
+        std::unique_ptr<layout_cache_t>         layout_cache_;
+        std::unique_ptr<sampler_cache_t>        sampler_cache_;
+        std::unique_ptr<render_pass_cache_t>    render_pass_cache_;
+        command_table_t                         command_table_;
         VULKAN_DECLARE_FUNCTION(vkGetDeviceQueue);
         VULKAN_DECLARE_FUNCTION(vkDeviceWaitIdle);
         VULKAN_DECLARE_FUNCTION(vkDestroyDevice);
@@ -228,6 +988,7 @@ namespace vk
         VULKAN_DECLARE_FUNCTION(vkFlushMappedMemoryRanges);
         VULKAN_DECLARE_FUNCTION(vkUnmapMemory);
         VULKAN_DECLARE_FUNCTION(vkCmdCopyBuffer);
+        VULKAN_DECLARE_FUNCTION(vkCmdFillBuffer);
         VULKAN_DECLARE_FUNCTION(vkCmdCopyBufferToImage);
         VULKAN_DECLARE_FUNCTION(vkCmdCopyImageToBuffer);
         VULKAN_DECLARE_FUNCTION(vkBeginCommandBuffer);
@@ -242,6 +1003,7 @@ namespace vk
         VULKAN_DECLARE_FUNCTION(vkCreateSemaphore);
         VULKAN_DECLARE_FUNCTION(vkCreateFence);
         VULKAN_DECLARE_FUNCTION(vkWaitForFences);
+        VULKAN_DECLARE_FUNCTION(vkGetFenceStatus);
         VULKAN_DECLARE_FUNCTION(vkResetFences);
         VULKAN_DECLARE_FUNCTION(vkDestroyFence);
         VULKAN_DECLARE_FUNCTION(vkDestroySemaphore);
@@ -278,6 +1040,8 @@ namespace vk
         VULKAN_DECLARE_FUNCTION(vkCreateComputePipelines);
         VULKAN_DECLARE_FUNCTION(vkDestroyPipeline);
         VULKAN_DECLARE_FUNCTION(vkDestroyEvent);
+        VULKAN_DECLARE_FUNCTION(vkCreateQueryPool);
+        VULKAN_DECLARE_FUNCTION(vkGetQueryPoolResults);
         VULKAN_DECLARE_FUNCTION(vkDestroyQueryPool);
         VULKAN_DECLARE_FUNCTION(vkCreateShaderModule);
         VULKAN_DECLARE_FUNCTION(vkDestroyShaderModule);
@@ -289,6 +1053,7 @@ namespace vk
         VULKAN_DECLARE_FUNCTION(vkCmdBindVertexBuffers);
         VULKAN_DECLARE_FUNCTION(vkCmdDraw);
         VULKAN_DECLARE_FUNCTION(vkCmdDrawIndexed);
+        VULKAN_DECLARE_FUNCTION(vkCmdDrawIndexedIndirect);
         VULKAN_DECLARE_FUNCTION(vkCmdDispatch);
         VULKAN_DECLARE_FUNCTION(vkCmdCopyImage);
         VULKAN_DECLARE_FUNCTION(vkCmdPushConstants);
@@ -300,5 +1065,7 @@ namespace vk
         VULKAN_DECLARE_FUNCTION(vkCmdSetBlendConstants);
         VULKAN_DECLARE_FUNCTION(vkCmdExecuteCommands);
         VULKAN_DECLARE_FUNCTION(vkCmdClearAttachments);
+        VULKAN_DECLARE_FUNCTION(vkCmdResetQueryPool);
+        VULKAN_DECLARE_FUNCTION(vkCmdWriteTimestamp);
     };
 }
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+
+namespace vk
+{
+    namespace detail
+    {
+        /// a buffer with a dedicated memory allocation, for the few large buffers which are not worth sub-allocating
+        struct device_buffer_t
+        {
+            VkBuffer                        buffer = nullptr;
+            VkDeviceMemory                  memory = nullptr;
+        };
+
+        template <typename Device>
+        void destroy_device_buffer(Device const& device, device_buffer_t& buffer)
+        {
+            device.destroy_buffer(std::exchange(buffer.buffer, nullptr));
+            device.free_memory(std::exchange(buffer.memory, nullptr));
+        }
+
+        template <typename Device>
+        device_buffer_t create_device_buffer(Device const& device, VkDeviceSize size, VkBufferUsageFlags usage,
+            VkMemoryPropertyFlags memory_properties)
+        {
+            VkBufferCreateInfo create_info =
+            {
+                VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,               // VkStructureType          sType
+                nullptr,                                            // const void*              pNext
+                0,                                                  // VkBufferCreateFlags      flags
+                size,                                               // VkDeviceSize             size
+                usage,                                              // VkBufferUsageFlags       usage
+                VK_SHARING_MODE_EXCLUSIVE,                          // VkSharingMode            sharingMode
+                0,                                                  // uint32_t                 queueFamilyIndexCount
+                nullptr                                             // const uint32_t*          pQueueFamilyIndices
+            };
+
+            device_buffer_t result;
+            result.buffer = device.create_buffer_handle(create_info);
+            try
+            {
+                auto requirements = device.get_buffer_memory_requirements(result.buffer);
+                auto type_index = device.find_memory_type(requirements.memoryTypeBits, memory_properties);
+                if (invalid_index == type_index)
+                    throw std::runtime_error{ "No memory type for the device buffer!" };
+
+                result.memory = device.allocate_memory_handle(requirements.size, type_index);
+                device.bind_buffer_memory(result.buffer, result.memory);
+            }
+            catch (...)
+            {
+                destroy_device_buffer(device, result);
+                throw;
+            }
+            return result;
+        }
+    }
+}
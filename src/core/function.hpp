@@ -21,4 +21,39 @@ namespace vk
     {
         return{ Exts::name()... };
     }
-}
\ No newline at end of file
+
+    namespace detail
+    {
+        template <typename T, typename Instance, typename = void>
+        struct has_device_features : std::false_type {};
+        template <typename T, typename Instance>
+        struct has_device_features<T, Instance, std::void_t<decltype(T::chain_features(std::declval<pnext_chain_t&>(),
+            std::declval<Instance const&>(), std::declval<VkPhysicalDevice>()))>> : std::true_type {};
+
+        /// an extension tag with a static chain_features adds the feature structures it needs to the device create info
+        /// it checks them against the physical device first and throws where one is missing
+        template <typename Ext, typename Instance>
+        inline void chain_device_features(pnext_chain_t& chain, Instance const& instance, VkPhysicalDevice physical_device)
+        {
+            if constexpr (has_device_features<Ext, Instance>::value)
+                Ext::chain_features(chain, instance, physical_device);
+        }
+
+        template <typename T, typename = void>
+        struct has_device_feature_query : std::false_type {};
+        template <typename T>
+        struct has_device_feature_query<T, std::void_t<decltype(std::declval<T const&>().query_physical_device_features(
+            std::declval<VkPhysicalDevice>(), std::declval<void*>()))>> : std::true_type {};
+
+        /// the features the physical device supports for one extension feature structure
+        template <typename Instance, typename Features>
+        inline Features query_device_features(Instance const& instance, VkPhysicalDevice physical_device, Features features)
+        {
+            static_assert(has_device_feature_query<Instance>::value,
+                "Create the instance with khr::get_physical_device_properties2_ext to query extension features!");
+            features.pNext = nullptr;
+            instance.query_physical_device_features(physical_device, &features);
+            return features;
+        }
+    }
+}
@@ -43,6 +43,21 @@ namespace vk
             return instance_t{ *this, param };
         }
 
+        /// write the extensions supported by vulkan into caller-provided storage without allocating
+        /// complete is false when the storage was too small for all of them
+        auto get_available_extension(span<extension_property_t> extension_properties) const
+        {
+            // an empty span passes nullptr, which only queries the count
+            auto extension_count = static_cast<uint32_t>(extension_properties.size());
+            auto result = vkEnumerateInstanceExtensionProperties(nullptr, &extension_count, extension_properties.data());
+            if (VK_SUCCESS != result && VK_INCOMPLETE != result)
+                throw std::runtime_error{ "Failed to call vkEnumerateInstanceExtensionProperties!" };
+
+            auto const filled = std::min<size_t>(extension_count, extension_properties.size());
+            return fill_result<extension_property_t>{ extension_properties.first(filled),
+                VK_SUCCESS == result && extension_count <= extension_properties.size() };
+        }
+
     protected:
         global_t()
             : library_(platform_type::dynamic_library(), boost::dll::load_mode::search_system_folders)
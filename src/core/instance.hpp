@@ -124,22 +124,33 @@ namespace vk
             return properties;
         }
 
+        auto get_physical_device_memory_properties(VkPhysicalDevice device) const
+        {
+            VkPhysicalDeviceMemoryProperties properties;
+            vkGetPhysicalDeviceMemoryProperties(device, &properties);
+            return properties;
+        }
+
         auto enumerate_queue_families(VkPhysicalDevice device) const
         {
-            // enumerate all queue families properties
+            // a device has a handful of queue families, fetch them on the stack and allocate the result once
+            std::array<queue_family_properties_t, 16> inline_properties;
+            std::vector<queue_family_properties_t> heap_properties;
+
             uint32_t queue_family_count{ 0 };
             vkGetPhysicalDeviceQueueFamilyProperties(device, &queue_family_count, nullptr);
-            std::vector<VkQueueFamilyProperties> properties{ queue_family_count };
-            vkGetPhysicalDeviceQueueFamilyProperties(device, &queue_family_count, properties.data());
-
-            // transform into std::vector<queue_families>
-            std::vector<queue_family_t> queue_families{ queue_family_count };
-            queue_family_count = 0;
-            std::transform(properties.cbegin(), properties.cend(), queue_families.begin(),
-                [&queue_family_count](auto const& queue_family_properties) -> queue_family_t
+            auto properties = span<queue_family_properties_t>{ inline_properties };
+            if (queue_family_count > inline_properties.size())
             {
-                return{ queue_family_count++, queue_family_properties };
-            });
+                heap_properties.resize(queue_family_count);
+                properties = heap_properties;
+            }
+            properties = enumerate_queue_families(device, properties).values;
+
+            std::vector<queue_family_t> queue_families;
+            queue_families.reserve(properties.size());
+            for (auto const& queue_family_properties : properties)
+                queue_families.push_back({ static_cast<uint32_t>(queue_families.size()), queue_family_properties });
 
             return queue_families;
         }
@@ -148,25 +159,27 @@ namespace vk
             physical_device_t physical_device,
             std::vector<queue_info_t> const& queue_infos,
             std::vector<char const*> const& desired_extensions,
-            physical_device_features_t const& desired_features) const
+            physical_device_features_t const& desired_features,
+            void const* next = nullptr) const
         {
-            std::vector<VkDeviceQueueCreateInfo> queue_create_infos;
-            queue_create_infos.reserve(queue_infos.size());
-            std::transform(queue_infos.cbegin(), queue_infos.cend(), std::back_inserter(queue_create_infos),
-                [](auto const& queue_info) {
-                return VkDeviceQueueCreateInfo{
+            // the create infos only live through vkCreateDevice, borrow them from the frame arena
+            arena_scope_t scope;
+            arena_array<VkDeviceQueueCreateInfo> queue_create_infos{ scope.get_arena(), queue_infos.size() };
+            for (auto const& queue_info : queue_infos)
+            {
+                queue_create_infos.push_back({
                     VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,             // VkStructureType                  sType
                     nullptr,                                                // const void*                      pNext
                     0,                                                      // VkDeviceQueueCreateFlags         flag
                     queue_info.family_index,                                // uint32_t                         queueFamilyIndex
                     static_cast<uint32_t>(queue_info.priorities.size()),    // uint32_t                         queueCount
                     queue_info.priorities.data()                            // const float*                     pQueuePriorities
-                };
-            });
+                });
+            }
 
             VkDeviceCreateInfo device_create_info = {
                 VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,                       // VkStructureType                  sType
-                nullptr,                                                    // const void*                      pNext
+                next,                                                       // const void*                      pNext
                 0,                                                          // VkDeviceCreateFlag               flag
                 static_cast<uint32_t>(queue_create_infos.size()),           // uint32_t                         queueCreateInfoCount
                 queue_create_infos.data(),                                  // const VkDeviceQueueCreateInfo*   pQueueCreateInfos
@@ -224,15 +237,77 @@ namespace vk
         template <typename ... DeviceExts>
         auto create_logical_device(physical_device_t physical_device, std::vector<queue_info_t> const& queue_infos, DeviceExts ... device_exts) const
         {
+            return create_logical_device(physical_device, queue_infos, physical_device_features_t{}, device_exts...);
+        }
+
+        /// features are the core features to enable, such as multiDrawIndirect or drawIndirectFirstInstance
+        /// throws when the physical device does not support one of them
+        template <typename ... DeviceExts>
+        auto create_logical_device(physical_device_t physical_device, std::vector<queue_info_t> const& queue_infos,
+            physical_device_features_t const& desired_features, DeviceExts ... device_exts) const
+        {
+            // every member of VkPhysicalDeviceFeatures is a VkBool32
+            constexpr auto feature_count = sizeof(physical_device_features_t) / sizeof(VkBool32);
+            auto const supported_features = get_physical_device_features(physical_device);
+            auto const* desired = reinterpret_cast<VkBool32 const*>(&desired_features);
+            auto const* supported = reinterpret_cast<VkBool32 const*>(&supported_features);
+            for (size_t i = 0; i < feature_count; ++i)
+            {
+                if (VK_FALSE != desired[i] && VK_FALSE == supported[i])
+                    throw std::runtime_error{ "The physical device does not support a requested feature!" };
+            }
+
             // prepare queue create informations
             auto device_extensions = get_extension_string_array(device_exts...);
             
+            // chain the features the extensions need
+            arena_scope_t scope;
+            pnext_chain_t features{ scope.get_arena() };
+            (detail::chain_device_features<DeviceExts>(features, this->get(), physical_device), ...);
+
             // create logical device handle
-            auto logical_device_handle = create_logical_device_handle(physical_device, queue_infos, device_extensions, physical_device_features_t{});
+            auto logical_device_handle = create_logical_device_handle(physical_device, queue_infos, device_extensions, desired_features, features.get());
 
             // create logical device
             using logical_device_t = device<DeviceExts...>;
-            return logical_device_t{ *this, logical_device_handle };
+            return logical_device_t{ *this, physical_device, logical_device_handle, desired_features };
+        }
+
+        /// the overloads below write into caller-provided storage and return the part they filled
+        /// nothing is allocated, complete is false when the storage was too small for the result
+        auto enumerate_physical_devices(span<VkPhysicalDevice> physical_devices) const
+        {
+            // an empty span passes nullptr, which only queries the count
+            auto device_count = static_cast<uint32_t>(physical_devices.size());
+            auto result = vkEnumeratePhysicalDevices(instance_, &device_count, physical_devices.data());
+            if (VK_SUCCESS != result && VK_INCOMPLETE != result)
+                throw std::runtime_error{ "Failed to call vkEnumeratePhysicalDevices!" };
+
+            auto const filled = std::min<size_t>(device_count, physical_devices.size());
+            return fill_result<VkPhysicalDevice>{ physical_devices.first(filled), VK_SUCCESS == result && device_count <= physical_devices.size() };
+        }
+
+        auto enumerate_device_extensions(VkPhysicalDevice device, span<extension_property_t> extensions) const
+        {
+            auto extension_count = static_cast<uint32_t>(extensions.size());
+            auto result = vkEnumerateDeviceExtensionProperties(device, nullptr, &extension_count, extensions.data());
+            if (VK_SUCCESS != result && VK_INCOMPLETE != result)
+                throw std::runtime_error{ "Failed to call vkEnumerateDeviceExtensionProperties!" };
+
+            auto const filled = std::min<size_t>(extension_count, extensions.size());
+            return fill_result<extension_property_t>{ extensions.first(filled), VK_SUCCESS == result && extension_count <= extensions.size() };
+        }
+
+        auto enumerate_queue_families(VkPhysicalDevice device, span<queue_family_properties_t> properties) const
+        {
+            // the query returns no VkResult, compare against the available count to detect truncation
+            uint32_t available_count{ 0 };
+            vkGetPhysicalDeviceQueueFamilyProperties(device, &available_count, nullptr);
+
+            auto queue_family_count = std::min(available_count, static_cast<uint32_t>(properties.size()));
+            if (0 != queue_family_count)
+                vkGetPhysicalDeviceQueueFamilyProperties(device, &queue_family_count, properties.data());
+            return fill_result<queue_family_properties_t>{ properties.first(queue_family_count), available_count <= properties.size() };
         }
 
     private:
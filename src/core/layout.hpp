@@ -0,0 +1,218 @@
+#pragma once
+
+namespace vk
+{
+    namespace detail
+    {
+        // structural description of a descriptor set layout, immutable samplers are stored by value
+        // in binding order, with the count each binding owns so that the grouping is part of the key
+        struct descriptor_set_layout_key_t
+        {
+            VkDescriptorSetLayoutCreateFlags            flags = 0;
+            std::vector<VkDescriptorSetLayoutBinding>   bindings;
+            std::vector<VkSampler>                      immutable_samplers;
+            std::vector<uint32_t>                       immutable_sampler_counts;     // per binding
+
+            descriptor_set_layout_key_t(std::vector<VkDescriptorSetLayoutBinding> const& layout_bindings,
+                VkDescriptorSetLayoutCreateFlags layout_flags)
+                : flags(layout_flags)
+                , bindings(layout_bindings)
+            {
+                // binding order is irrelevant to the layout
+                std::sort(bindings.begin(), bindings.end(), [](auto const& lhs, auto const& rhs)
+                {
+                    return lhs.binding < rhs.binding;
+                });
+
+                immutable_sampler_counts.reserve(bindings.size());
+                for (auto& binding : bindings)
+                {
+                    uint32_t sampler_count = 0;
+                    if (nullptr != binding.pImmutableSamplers)
+                    {
+                        sampler_count = binding.descriptorCount;
+                        immutable_samplers.insert(immutable_samplers.end(),
+                            binding.pImmutableSamplers, binding.pImmutableSamplers + sampler_count);
+                    }
+                    immutable_sampler_counts.push_back(sampler_count);
+                    binding.pImmutableSamplers = nullptr;
+                }
+            }
+
+            // restore the immutable sampler pointers for vkCreateDescriptorSetLayout
+            std::vector<VkDescriptorSetLayoutBinding> resolve_bindings(
+                std::vector<VkDescriptorSetLayoutBinding> const& layout_bindings) const
+            {
+                auto result = bindings;
+                for (auto& binding : result)
+                {
+                    auto itr = std::find_if(layout_bindings.cbegin(), layout_bindings.cend(), [&binding](auto const& other)
+                    {
+                        return other.binding == binding.binding;
+                    });
+                    binding.pImmutableSamplers = itr->pImmutableSamplers;
+                }
+                return result;
+            }
+
+            bool operator== (descriptor_set_layout_key_t const& other) const noexcept
+            {
+                return flags == other.flags &&
+                    immutable_samplers == other.immutable_samplers &&
+                    immutable_sampler_counts == other.immutable_sampler_counts &&
+                    std::equal(bindings.cbegin(), bindings.cend(), other.bindings.cbegin(), other.bindings.cend(),
+                        [](auto const& lhs, auto const& rhs)
+                {
+                    return lhs.binding == rhs.binding &&
+                        lhs.descriptorType == rhs.descriptorType &&
+                        lhs.descriptorCount == rhs.descriptorCount &&
+                        lhs.stageFlags == rhs.stageFlags;
+                });
+            }
+        };
+
+        struct descriptor_set_layout_key_hash
+        {
+            size_t operator()(descriptor_set_layout_key_t const& key) const noexcept
+            {
+                auto seed = hash_values(key.flags);
+                hash_range(seed, key.bindings, [](auto const& binding)
+                {
+                    return hash_values(binding.binding, binding.descriptorType, binding.descriptorCount, binding.stageFlags);
+                });
+                hash_range(seed, key.immutable_samplers, [](auto sampler) { return hash_values(sampler); });
+                hash_range(seed, key.immutable_sampler_counts, [](auto count) { return hash_values(count); });
+                return seed;
+            }
+        };
+
+        struct pipeline_layout_key_t
+        {
+            std::vector<VkDescriptorSetLayout>          set_layouts;
+            std::vector<VkPushConstantRange>            push_constant_ranges;
+
+            pipeline_layout_key_t(std::vector<VkDescriptorSetLayout> const& layouts,
+                std::vector<VkPushConstantRange> const& ranges)
+                : set_layouts(layouts)
+                , push_constant_ranges(ranges)
+            {
+                std::sort(push_constant_ranges.begin(), push_constant_ranges.end(), [](auto const& lhs, auto const& rhs)
+                {
+                    return std::tie(lhs.offset, lhs.size, lhs.stageFlags) < std::tie(rhs.offset, rhs.size, rhs.stageFlags);
+                });
+            }
+
+            bool operator== (pipeline_layout_key_t const& other) const noexcept
+            {
+                return set_layouts == other.set_layouts &&
+                    std::equal(push_constant_ranges.cbegin(), push_constant_ranges.cend(),
+                        other.push_constant_ranges.cbegin(), other.push_constant_ranges.cend(),
+                        [](auto const& lhs, auto const& rhs)
+                {
+                    return lhs.stageFlags == rhs.stageFlags && lhs.offset == rhs.offset && lhs.size == rhs.size;
+                });
+            }
+        };
+
+        struct pipeline_layout_key_hash
+        {
+            size_t operator()(pipeline_layout_key_t const& key) const noexcept
+            {
+                size_t seed = 0;
+                hash_range(seed, key.set_layouts, [](auto layout) { return hash_values(layout); });
+                hash_range(seed, key.push_constant_ranges, [](auto const& range)
+                {
+                    return hash_values(range.stageFlags, range.offset, range.size);
+                });
+                return seed;
+            }
+        };
+
+        inline bool is_image_descriptor(VkDescriptorType type) noexcept
+        {
+            return type == VK_DESCRIPTOR_TYPE_SAMPLER ||
+                type == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER ||
+                type == VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE ||
+                type == VK_DESCRIPTOR_TYPE_STORAGE_IMAGE ||
+                type == VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+        }
+
+        inline bool is_texel_buffer_descriptor(VkDescriptorType type) noexcept
+        {
+            return type == VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER ||
+                type == VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER;
+        }
+    }
+
+    /// hash-consed descriptor set layouts and pipeline layouts
+    /// structurally identical layouts resolve to one handle, so pipelines built from them
+    /// are layout-compatible and bound descriptor sets survive pipeline switches
+    class layout_cache_t
+    {
+    public:
+        layout_cache_t() = default;
+        layout_cache_t(layout_cache_t const&) = delete;
+        layout_cache_t& operator=(layout_cache_t const&) = delete;
+
+        template <typename F>
+        VkDescriptorSetLayout get_descriptor_set_layout(
+            std::vector<VkDescriptorSetLayoutBinding> const& bindings,
+            VkDescriptorSetLayoutCreateFlags flags, F&& create)
+        {
+            detail::descriptor_set_layout_key_t key{ bindings, flags };
+
+            std::lock_guard<std::mutex> lock{ mutex_ };
+            auto itr = set_layouts_.find(key);
+            if (itr != set_layouts_.end())
+                return itr->second;
+
+            auto layout = create(key.resolve_bindings(bindings), flags);
+            set_layouts_.emplace(std::move(key), layout);
+            return layout;
+        }
+
+        template <typename F>
+        VkPipelineLayout get_pipeline_layout(
+            std::vector<VkDescriptorSetLayout> const& set_layouts,
+            std::vector<VkPushConstantRange> const& push_constant_ranges, F&& create)
+        {
+            detail::pipeline_layout_key_t key{ set_layouts, push_constant_ranges };
+
+            std::lock_guard<std::mutex> lock{ mutex_ };
+            auto itr = pipeline_layouts_.find(key);
+            if (itr != pipeline_layouts_.end())
+                return itr->second;
+
+            auto layout = create(key.set_layouts, key.push_constant_ranges);
+            pipeline_layouts_.emplace(std::move(key), layout);
+            return layout;
+        }
+
+        size_t size() const
+        {
+            std::lock_guard<std::mutex> lock{ mutex_ };
+            return set_layouts_.size() + pipeline_layouts_.size();
+        }
+
+        // pipeline layouts are destroyed before the set layouts they reference
+        template <typename FP, typename FD>
+        void clear(FP&& destroy_pipeline_layout, FD&& destroy_set_layout)
+        {
+            std::lock_guard<std::mutex> lock{ mutex_ };
+            for (auto const& pipeline_layout : pipeline_layouts_)
+                destroy_pipeline_layout(pipeline_layout.second);
+            for (auto const& set_layout : set_layouts_)
+                destroy_set_layout(set_layout.second);
+
+            pipeline_layouts_.clear();
+            set_layouts_.clear();
+        }
+
+    private:
+        mutable std::mutex mutex_;
+        std::unordered_map<detail::descriptor_set_layout_key_t, VkDescriptorSetLayout,
+            detail::descriptor_set_layout_key_hash>     set_layouts_;
+        std::unordered_map<detail::pipeline_layout_key_t, VkPipelineLayout,
+            detail::pipeline_layout_key_hash>           pipeline_layouts_;
+    };
+}
@@ -0,0 +1,215 @@
+#pragma once
+
+namespace vk
+{
+    inline constexpr uint32_t max_color_attachments = 8;
+
+    struct attachment_key_t
+    {
+        VkFormat                format = VK_FORMAT_UNDEFINED;
+        VkSampleCountFlagBits   samples = VK_SAMPLE_COUNT_1_BIT;
+        VkAttachmentLoadOp      load_op = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        VkAttachmentStoreOp     store_op = VK_ATTACHMENT_STORE_OP_STORE;
+        VkAttachmentLoadOp      stencil_load_op = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        VkAttachmentStoreOp     stencil_store_op = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        VkImageLayout           initial_layout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VkImageLayout           final_layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+        bool operator== (attachment_key_t const& other) const noexcept
+        {
+            return format == other.format && samples == other.samples &&
+                load_op == other.load_op && store_op == other.store_op &&
+                stencil_load_op == other.stencil_load_op && stencil_store_op == other.stencil_store_op &&
+                initial_layout == other.initial_layout && final_layout == other.final_layout;
+        }
+
+        size_t hash() const noexcept
+        {
+            return hash_values(format, samples, load_op, store_op, stencil_load_op, stencil_store_op, initial_layout, final_layout);
+        }
+    };
+
+    /// single subpass render pass described by its attachments
+    struct render_pass_key_t
+    {
+        std::array<attachment_key_t, max_color_attachments>     colors = {};
+        uint32_t                                                color_count = 0;
+        attachment_key_t                                        depth = {};
+        bool                                                    has_depth = false;
+
+        render_pass_key_t& add_color(attachment_key_t const& attachment)
+        {
+            assert(color_count < max_color_attachments);
+            colors[color_count++] = attachment;
+            return *this;
+        }
+
+        render_pass_key_t& set_depth(attachment_key_t const& attachment)
+        {
+            depth = attachment;
+            has_depth = true;
+            return *this;
+        }
+
+        uint32_t attachment_count() const noexcept
+        {
+            return color_count + (has_depth ? 1 : 0);
+        }
+
+        bool operator== (render_pass_key_t const& other) const noexcept
+        {
+            return color_count == other.color_count && has_depth == other.has_depth &&
+                std::equal(colors.cbegin(), colors.cbegin() + color_count, other.colors.cbegin()) &&
+                (!has_depth || depth == other.depth);
+        }
+    };
+
+    struct framebuffer_key_t
+    {
+        VkRenderPass                                            render_pass = nullptr;
+        std::array<VkImageView, max_color_attachments + 1>      views = {};
+        uint32_t                                                view_count = 0;
+        extent_2d_t                                             extent = { 0, 0 };
+        uint32_t                                                layers = 1;
+
+        bool operator== (framebuffer_key_t const& other) const noexcept
+        {
+            return render_pass == other.render_pass && view_count == other.view_count &&
+                extent.width == other.extent.width && extent.height == other.extent.height && layers == other.layers &&
+                std::equal(views.cbegin(), views.cbegin() + view_count, other.views.cbegin());
+        }
+    };
+
+    namespace detail
+    {
+        struct render_pass_key_hash
+        {
+            size_t operator()(render_pass_key_t const& key) const noexcept
+            {
+                auto seed = hash_values(key.color_count, key.has_depth);
+                for (uint32_t i = 0; i < key.color_count; ++i)
+                    hash_combine(seed, key.colors[i].hash());
+                if (key.has_depth)
+                    hash_combine(seed, key.depth.hash());
+                return seed;
+            }
+        };
+
+        struct framebuffer_key_hash
+        {
+            size_t operator()(framebuffer_key_t const& key) const noexcept
+            {
+                auto seed = hash_values(key.render_pass, key.view_count, key.extent.width, key.extent.height, key.layers);
+                for (uint32_t i = 0; i < key.view_count; ++i)
+                    hash_value(seed, key.views[i]);
+                return seed;
+            }
+        };
+    }
+
+    /// render passes and framebuffers created on demand from their keys
+    /// framebuffers are evicted as soon as one of their image views is destroyed
+    class render_pass_cache_t
+    {
+    public:
+        render_pass_cache_t() = default;
+        render_pass_cache_t(render_pass_cache_t const&) = delete;
+        render_pass_cache_t& operator=(render_pass_cache_t const&) = delete;
+
+        template <typename F>
+        VkRenderPass get_render_pass(render_pass_key_t const& key, F&& create)
+        {
+            std::lock_guard<std::mutex> lock{ mutex_ };
+            auto itr = render_passes_.find(key);
+            if (itr != render_passes_.end())
+                return itr->second;
+
+            auto render_pass = create(key);
+            render_passes_.emplace(key, render_pass);
+            return render_pass;
+        }
+
+        template <typename F>
+        VkFramebuffer get_framebuffer(framebuffer_key_t const& key, F&& create)
+        {
+            std::lock_guard<std::mutex> lock{ mutex_ };
+            auto itr = framebuffers_.find(key);
+            if (itr != framebuffers_.end())
+                return itr->second;
+
+            auto framebuffer = create(key);
+            framebuffers_.emplace(key, framebuffer);
+            for (uint32_t i = 0; i < key.view_count; ++i)
+                view_framebuffers_[key.views[i]].push_back(key);
+            return framebuffer;
+        }
+
+        /// drop every framebuffer which references the view
+        template <typename F>
+        void evict_image_view(VkImageView view, F&& destroy_framebuffer)
+        {
+            std::lock_guard<std::mutex> lock{ mutex_ };
+            auto itr = view_framebuffers_.find(view);
+            if (itr == view_framebuffers_.end())
+                return;
+
+            auto keys = std::move(itr->second);
+            view_framebuffers_.erase(itr);
+            for (auto const& key : keys)
+            {
+                auto framebuffer = framebuffers_.find(key);
+                if (framebuffer == framebuffers_.end())
+                    continue;
+
+                destroy_framebuffer(framebuffer->second);
+                framebuffers_.erase(framebuffer);
+
+                // the other attachments, e.g. a long lived depth view, stop referencing the dead key
+                for (uint32_t i = 0; i < key.view_count; ++i)
+                {
+                    if (key.views[i] != view)
+                        forget_framebuffer(key.views[i], key);
+                }
+            }
+        }
+
+        size_t framebuffer_count() const
+        {
+            std::lock_guard<std::mutex> lock{ mutex_ };
+            return framebuffers_.size();
+        }
+
+        template <typename FF, typename FR>
+        void clear(FF&& destroy_framebuffer, FR&& destroy_render_pass)
+        {
+            std::lock_guard<std::mutex> lock{ mutex_ };
+            for (auto const& framebuffer : framebuffers_)
+                destroy_framebuffer(framebuffer.second);
+            for (auto const& render_pass : render_passes_)
+                destroy_render_pass(render_pass.second);
+
+            framebuffers_.clear();
+            view_framebuffers_.clear();
+            render_passes_.clear();
+        }
+
+    private:
+        void forget_framebuffer(VkImageView view, framebuffer_key_t const& key)
+        {
+            auto itr = view_framebuffers_.find(view);
+            if (itr == view_framebuffers_.end())
+                return;
+
+            auto& keys = itr->second;
+            keys.erase(std::remove(keys.begin(), keys.end(), key), keys.end());
+            if (keys.empty())
+                view_framebuffers_.erase(itr);
+        }
+
+    private:
+        mutable std::mutex mutex_;
+        std::unordered_map<render_pass_key_t, VkRenderPass, detail::render_pass_key_hash>       render_passes_;
+        std::unordered_map<framebuffer_key_t, VkFramebuffer, detail::framebuffer_key_hash>      framebuffers_;
+        std::unordered_map<VkImageView, std::vector<framebuffer_key_t>>                         view_framebuffers_;
+    };
+}
@@ -0,0 +1,239 @@
+#pragma once
+
+namespace vk
+{
+    namespace detail
+    {
+        inline bool is_same_sampler(VkSamplerCreateInfo const& lhs, VkSamplerCreateInfo const& rhs) noexcept
+        {
+            return lhs.flags == rhs.flags &&
+                lhs.magFilter == rhs.magFilter &&
+                lhs.minFilter == rhs.minFilter &&
+                lhs.mipmapMode == rhs.mipmapMode &&
+                lhs.addressModeU == rhs.addressModeU &&
+                lhs.addressModeV == rhs.addressModeV &&
+                lhs.addressModeW == rhs.addressModeW &&
+                lhs.mipLodBias == rhs.mipLodBias &&
+                lhs.anisotropyEnable == rhs.anisotropyEnable &&
+                lhs.maxAnisotropy == rhs.maxAnisotropy &&
+                lhs.compareEnable == rhs.compareEnable &&
+                lhs.compareOp == rhs.compareOp &&
+                lhs.minLod == rhs.minLod &&
+                lhs.maxLod == rhs.maxLod &&
+                lhs.borderColor == rhs.borderColor &&
+                lhs.unnormalizedCoordinates == rhs.unnormalizedCoordinates;
+        }
+
+        inline size_t hash_sampler_create_info(VkSamplerCreateInfo const& info) noexcept
+        {
+            return hash_values(info.flags, info.magFilter, info.minFilter, info.mipmapMode,
+                info.addressModeU, info.addressModeV, info.addressModeW, info.mipLodBias,
+                info.anisotropyEnable, info.maxAnisotropy, info.compareEnable, info.compareOp,
+                info.minLod, info.maxLod, info.borderColor, info.unnormalizedCoordinates);
+        }
+
+        struct sampler_entry_t
+        {
+            inline static constexpr uint32_t dead = static_cast<uint32_t>(-1);
+
+            VkSamplerCreateInfo         create_info;
+            size_t                      hash;
+            std::atomic<VkSampler>      sampler{ VK_NULL_HANDLE };
+            std::atomic<uint32_t>       refs{ dead };
+
+            // take a reference unless the entry has been trimmed
+            bool acquire() noexcept
+            {
+                auto count = refs.load(std::memory_order_relaxed);
+                while (count != dead)
+                {
+                    if (refs.compare_exchange_weak(count, count + 1, std::memory_order_acquire, std::memory_order_relaxed))
+                        return true;
+                }
+                return false;
+            }
+
+            void release() noexcept
+            {
+                refs.fetch_sub(1, std::memory_order_release);
+            }
+        };
+    }
+
+    /// a reference to a sampler shared through the sampler cache
+    class shared_sampler_t
+    {
+        friend class sampler_cache_t;
+
+        explicit shared_sampler_t(detail::sampler_entry_t* entry) noexcept
+            : entry_(entry)
+        {}
+
+    public:
+        shared_sampler_t() = default;
+
+        ~shared_sampler_t()
+        {
+            if (nullptr != entry_)
+                entry_->release();
+        }
+
+        shared_sampler_t(shared_sampler_t const& other) noexcept
+            : entry_(other.entry_)
+        {
+            if (nullptr != entry_)
+                entry_->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        shared_sampler_t(shared_sampler_t&& other) noexcept
+            : entry_(std::exchange(other.entry_, nullptr))
+        {}
+
+        shared_sampler_t& operator= (shared_sampler_t other) noexcept
+        {
+            std::swap(entry_, other.entry_);
+            return *this;
+        }
+
+        operator VkSampler() const noexcept
+        {
+            return get();
+        }
+
+        VkSampler get() const noexcept
+        {
+            return nullptr != entry_ ? entry_->sampler.load(std::memory_order_relaxed) : VK_NULL_HANDLE;
+        }
+
+    private:
+        detail::sampler_entry_t*    entry_ = nullptr;
+    };
+
+    /// device level sampler cache keyed on the whole VkSamplerCreateInfo
+    /// lookups of existing samplers are lock-free, only creation and trimming take the mutex.
+    /// unreferenced samplers stay alive until trim() so that hot lookups never recreate them.
+    class sampler_cache_t
+    {
+    public:
+        inline static constexpr uint32_t default_capacity = 4096;
+
+        explicit sampler_cache_t(uint32_t capacity = default_capacity)
+            : mask_(next_power_of_two(capacity * 2) - 1)
+            , slots_(new std::atomic<detail::sampler_entry_t*>[mask_ + 1])
+        {
+            for (uint32_t i = 0; i <= mask_; ++i)
+                slots_[i].store(nullptr, std::memory_order_relaxed);
+        }
+
+        sampler_cache_t(sampler_cache_t const&) = delete;
+        sampler_cache_t& operator=(sampler_cache_t const&) = delete;
+
+        template <typename F>
+        shared_sampler_t get(VkSamplerCreateInfo const& create_info, F&& create)
+        {
+            // samplers with extension structures are not cached
+            assert(nullptr == create_info.pNext);
+            auto hash = detail::hash_sampler_create_info(create_info);
+            for (auto index = hash & mask_; ; index = (index + 1) & mask_)
+            {
+                auto entry = slots_[index].load(std::memory_order_acquire);
+                if (nullptr == entry)
+                    break;
+
+                if (entry->hash == hash && detail::is_same_sampler(entry->create_info, create_info) && entry->acquire())
+                    return shared_sampler_t{ entry };
+            }
+
+            return create_slow(create_info, hash, std::forward<F>(create));
+        }
+
+        /// destroy the samplers which are not referenced any more
+        template <typename F>
+        size_t trim(F&& destroy)
+        {
+            std::lock_guard<std::mutex> lock{ mutex_ };
+            size_t count = 0;
+            for (auto const& entry : entries_)
+            {
+                uint32_t expected = 0;
+                if (entry->refs.compare_exchange_strong(expected, detail::sampler_entry_t::dead, std::memory_order_acquire))
+                {
+                    destroy(entry->sampler.exchange(VK_NULL_HANDLE, std::memory_order_relaxed));
+                    ++count;
+                }
+            }
+            return count;
+        }
+
+        template <typename F>
+        void clear(F&& destroy)
+        {
+            std::lock_guard<std::mutex> lock{ mutex_ };
+            for (auto const& entry : entries_)
+            {
+                if (entry->refs.load(std::memory_order_relaxed) != detail::sampler_entry_t::dead)
+                    destroy(entry->sampler.load(std::memory_order_relaxed));
+            }
+        }
+
+        size_t size() const
+        {
+            std::lock_guard<std::mutex> lock{ mutex_ };
+            return entries_.size();
+        }
+
+    private:
+        template <typename F>
+        shared_sampler_t create_slow(VkSamplerCreateInfo const& create_info, size_t hash, F&& create)
+        {
+            std::lock_guard<std::mutex> lock{ mutex_ };
+
+            // another thread may have inserted or trimmed the sampler in the meantime
+            auto index = hash & mask_;
+            for (; ; index = (index + 1) & mask_)
+            {
+                auto entry = slots_[index].load(std::memory_order_relaxed);
+                if (nullptr == entry)
+                    break;
+
+                if (entry->hash != hash || !detail::is_same_sampler(entry->create_info, create_info))
+                    continue;
+
+                if (entry->acquire())
+                    return shared_sampler_t{ entry };
+
+                // revive a trimmed entry, the new handle is published by the reference count
+                entry->sampler.store(create(create_info), std::memory_order_relaxed);
+                entry->refs.store(1, std::memory_order_release);
+                return shared_sampler_t{ entry };
+            }
+
+            if (entries_.size() * 2 > mask_)
+                throw std::runtime_error{ "Sampler cache is full!" };
+
+            auto entry = std::make_unique<detail::sampler_entry_t>();
+            entry->create_info = create_info;
+            entry->hash = hash;
+            entry->sampler.store(create(create_info), std::memory_order_relaxed);
+            entry->refs.store(1, std::memory_order_relaxed);
+
+            slots_[index].store(entry.get(), std::memory_order_release);
+            entries_.push_back(std::move(entry));
+            return shared_sampler_t{ entries_.back().get() };
+        }
+
+        static uint32_t next_power_of_two(uint32_t value) noexcept
+        {
+            uint32_t result = 1;
+            while (result < value)
+                result <<= 1;
+            return result;
+        }
+
+    private:
+        uint32_t                                                mask_;
+        std::unique_ptr<std::atomic<detail::sampler_entry_t*>[]> slots_;
+        std::vector<std::unique_ptr<detail::sampler_entry_t>>   entries_;
+        mutable std::mutex                                      mutex_;
+    };
+}
@@ -0,0 +1,255 @@
+#pragma once
+
+namespace vk
+{
+    struct state_tracker_statistics_t
+    {
+        uint64_t                requests = 0;
+        uint64_t                barrier_calls = 0;
+        uint64_t                image_barriers = 0;
+        uint64_t                buffer_barriers = 0;
+    };
+
+    /// per command buffer tracking of buffer and image subresource access
+    /// transitions are accumulated by require_*() and issued by flush() as one vkCmdPipelineBarrier
+    /// with merged stage masks, right before the next draw, dispatch or copy.
+    template <typename Device>
+    class state_tracker
+    {
+        struct tracked_state_t
+        {
+            access_state_t              state;
+            uint64_t                    pending_batch = 0;      // batch which already transitions this state
+        };
+
+        struct image_state_t
+        {
+            VkImageAspectFlags              aspect;
+            uint32_t                        mip_levels;
+            uint32_t                        layers;
+            std::vector<tracked_state_t>    subresources;       // layer major
+        };
+
+    public:
+        explicit state_tracker(Device const& device)
+            : device_(&device)
+        {}
+
+        state_tracker(state_tracker const&) = delete;
+        state_tracker& operator=(state_tracker const&) = delete;
+
+        /// start recording into another command buffer, the tracked states carry over
+        /// with a table the barriers are recorded through it, e.g. the one of a command_recorder
+        void begin(VkCommandBuffer command_buffer, command_table_t const* commands = nullptr)
+        {
+            assert(!has_pending());
+            command_buffer_ = command_buffer;
+            commands_ = commands;
+        }
+
+        void set_command_table(command_table_t const* commands) noexcept
+        {
+            commands_ = commands;
+        }
+
+        void track_image(VkImage image, VkFormat format, uint32_t mip_levels = 1, uint32_t layers = 1,
+            access_t current_access = access_t::none)
+        {
+            tracked_state_t initial;
+            initial.state = make_access_state(current_access);
+            images_[image] = image_state_t{ get_image_aspect(format), mip_levels, layers,
+                std::vector<tracked_state_t>(mip_levels * layers, initial) };
+        }
+
+        void track_buffer(VkBuffer buffer, access_t current_access = access_t::none)
+        {
+            tracked_state_t initial;
+            initial.state = make_access_state(current_access);
+            buffers_[buffer] = initial;
+        }
+
+        void untrack_image(VkImage image)
+        {
+            images_.erase(image);
+        }
+
+        void untrack_buffer(VkBuffer buffer)
+        {
+            buffers_.erase(buffer);
+        }
+
+        /// the whole image, or the given mips and layers, is about to be accessed
+        void require_image(VkImage image, access_t access,
+            uint32_t base_mip = 0, uint32_t mip_count = VK_REMAINING_MIP_LEVELS,
+            uint32_t base_layer = 0, uint32_t layer_count = VK_REMAINING_ARRAY_LAYERS)
+        {
+            auto itr = images_.find(image);
+            if (itr == images_.end())
+                throw std::runtime_error{ "Image is not tracked!" };
+
+            auto& tracked = itr->second;
+            if (VK_REMAINING_MIP_LEVELS == mip_count)
+                mip_count = tracked.mip_levels - base_mip;
+            if (VK_REMAINING_ARRAY_LAYERS == layer_count)
+                layer_count = tracked.layers - base_layer;
+            assert(base_mip + mip_count <= tracked.mip_levels && base_layer + layer_count <= tracked.layers);
+
+            ++statistics_.requests;
+            auto const& required = get_access_info(access);
+
+            // two transitions of one subresource cannot share a barrier
+            for (uint32_t layer = base_layer; layer < base_layer + layer_count; ++layer)
+            {
+                for (uint32_t mip = base_mip; mip < base_mip + mip_count; ++mip)
+                {
+                    if (tracked.subresources[layer * tracked.mip_levels + mip].pending_batch == batch_)
+                    {
+                        flush();
+                        break;
+                    }
+                }
+            }
+
+            // the common case of a uniform range collapses into a single image barrier
+            auto const first_barrier = image_barriers_.size();
+            bool uniform = true;
+            access_dependency_t first_dependency;
+            for (uint32_t layer = base_layer; layer < base_layer + layer_count; ++layer)
+            {
+                for (uint32_t mip = base_mip; mip < base_mip + mip_count; ++mip)
+                {
+                    auto& subresource = tracked.subresources[layer * tracked.mip_levels + mip];
+                    auto dependency = update_access_state(subresource.state, required, true);
+                    if (!dependency.needed)
+                    {
+                        uniform = false;
+                        continue;
+                    }
+
+                    if (first_barrier == image_barriers_.size())
+                        first_dependency = dependency;
+                    else
+                        uniform = uniform && first_dependency.old_layout == dependency.old_layout &&
+                            first_dependency.src_access == dependency.src_access;
+
+                    subresource.pending_batch = batch_;
+                    src_stages_ |= dependency.src_stages;
+                    dst_stages_ |= required.stages;
+                    image_barriers_.push_back(make_image_barrier(image, tracked.aspect, dependency, required, mip, 1, layer, 1));
+                }
+            }
+
+            if (uniform && image_barriers_.size() - first_barrier > 1)
+            {
+                image_barriers_.resize(first_barrier);
+                image_barriers_.push_back(make_image_barrier(image, tracked.aspect, first_dependency, required,
+                    base_mip, mip_count, base_layer, layer_count));
+            }
+        }
+
+        /// the whole buffer is about to be accessed, untracked buffers start without pending work
+        void require_buffer(VkBuffer buffer, access_t access)
+        {
+            auto& tracked = buffers_[buffer];
+            if (tracked.pending_batch == batch_)
+                flush();
+
+            ++statistics_.requests;
+            auto const& required = get_access_info(access);
+            auto dependency = update_access_state(tracked.state, required, false);
+            if (!dependency.needed)
+                return;
+
+            tracked.pending_batch = batch_;
+            src_stages_ |= dependency.src_stages;
+            dst_stages_ |= required.stages;
+            buffer_barriers_.push_back({
+                VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,        // VkStructureType          sType
+                nullptr,                                        // const void*              pNext
+                dependency.src_access,                          // VkAccessFlags            srcAccessMask
+                required.access,                                // VkAccessFlags            dstAccessMask
+                VK_QUEUE_FAMILY_IGNORED,                        // uint32_t                 srcQueueFamilyIndex
+                VK_QUEUE_FAMILY_IGNORED,                        // uint32_t                 dstQueueFamilyIndex
+                buffer,                                         // VkBuffer                 buffer
+                0,                                              // VkDeviceSize             offset
+                VK_WHOLE_SIZE                                   // VkDeviceSize             size
+            });
+        }
+
+        bool has_pending() const noexcept
+        {
+            return !image_barriers_.empty() || !buffer_barriers_.empty();
+        }
+
+        /// issue every pending transition with one vkCmdPipelineBarrier
+        void flush()
+        {
+            if (!has_pending())
+                return;
+
+            assert(nullptr != command_buffer_);
+            if (nullptr != commands_)
+            {
+                commands_->vkCmdPipelineBarrier(command_buffer_, src_stages_, dst_stages_, 0,
+                    0, nullptr,
+                    static_cast<uint32_t>(buffer_barriers_.size()), buffer_barriers_.data(),
+                    static_cast<uint32_t>(image_barriers_.size()), image_barriers_.data());
+            }
+            else
+            {
+                device_->pipeline_barrier(command_buffer_, src_stages_, dst_stages_,
+                    0, nullptr,
+                    static_cast<uint32_t>(buffer_barriers_.size()), buffer_barriers_.data(),
+                    static_cast<uint32_t>(image_barriers_.size()), image_barriers_.data());
+            }
+
+            ++statistics_.barrier_calls;
+            statistics_.image_barriers += image_barriers_.size();
+            statistics_.buffer_barriers += buffer_barriers_.size();
+
+            image_barriers_.clear();
+            buffer_barriers_.clear();
+            src_stages_ = 0;
+            dst_stages_ = 0;
+            ++batch_;
+        }
+
+        state_tracker_statistics_t const& get_statistics() const noexcept
+        {
+            return statistics_;
+        }
+
+    private:
+        static VkImageMemoryBarrier make_image_barrier(VkImage image, VkImageAspectFlags aspect,
+            access_dependency_t const& dependency, access_info_t const& required,
+            uint32_t base_mip, uint32_t mip_count, uint32_t base_layer, uint32_t layer_count) noexcept
+        {
+            return
+            {
+                VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,         // VkStructureType          sType
+                nullptr,                                        // const void*              pNext
+                dependency.src_access,                          // VkAccessFlags            srcAccessMask
+                required.access,                                // VkAccessFlags            dstAccessMask
+                dependency.old_layout,                          // VkImageLayout            oldLayout
+                required.layout,                                // VkImageLayout            newLayout
+                VK_QUEUE_FAMILY_IGNORED,                        // uint32_t                 srcQueueFamilyIndex
+                VK_QUEUE_FAMILY_IGNORED,                        // uint32_t                 dstQueueFamilyIndex
+                image,                                          // VkImage                  image
+                { aspect, base_mip, mip_count, base_layer, layer_count }   // VkImageSubresourceRange  subresourceRange
+            };
+        }
+
+    private:
+        Device const*                                   device_;
+        VkCommandBuffer                                 command_buffer_ = nullptr;
+        command_table_t const*                          commands_ = nullptr;
+        std::unordered_map<VkImage, image_state_t>      images_;
+        std::unordered_map<VkBuffer, tracked_state_t>   buffers_;
+        std::vector<VkImageMemoryBarrier>               image_barriers_;
+        std::vector<VkBufferMemoryBarrier>              buffer_barriers_;
+        VkPipelineStageFlags                            src_stages_ = 0;
+        VkPipelineStageFlags                            dst_stages_ = 0;
+        uint64_t                                        batch_ = 1;
+        state_tracker_statistics_t                      statistics_;
+    };
+}
@@ -0,0 +1,320 @@
+#pragma once
+
+namespace vk
+{
+    /// EXT descriptor indexing extension is a device extension, enable it together with khr::maintenance3_ext
+    /// and create the instance with khr::get_physical_device_properties2_ext
+    namespace ext
+    {
+        constexpr struct descriptor_indexing_ext_t
+        {
+            static char const* name() noexcept
+            {
+                return VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME;
+            }
+
+            /// the features the bindless table relies on, device creation throws where they are missing
+            template <typename Instance>
+            static void chain_features(pnext_chain_t& chain, Instance const& instance, VkPhysicalDevice physical_device)
+            {
+                VkPhysicalDeviceDescriptorIndexingFeaturesEXT features = {};
+                features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+                auto const supported = detail::query_device_features(instance, physical_device, features);
+                if (!supported.shaderSampledImageArrayNonUniformIndexing || !supported.shaderStorageBufferArrayNonUniformIndexing ||
+                    !supported.descriptorBindingSampledImageUpdateAfterBind || !supported.descriptorBindingStorageBufferUpdateAfterBind ||
+                    !supported.descriptorBindingUpdateUnusedWhilePending || !supported.descriptorBindingPartiallyBound ||
+                    !supported.runtimeDescriptorArray)
+                    throw std::runtime_error{ "The physical device lacks the descriptor indexing features of the bindless table!" };
+
+                features.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+                features.shaderStorageBufferArrayNonUniformIndexing = VK_TRUE;
+                features.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+                features.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+                features.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+                features.descriptorBindingPartiallyBound = VK_TRUE;
+                features.runtimeDescriptorArray = VK_TRUE;
+                chain.add(features);
+            }
+        } descriptor_indexing_ext;
+
+        /// the bindings of the bindless set, shaders index them with the slots handed out by the table
+        enum bindless_binding_t : uint32_t
+        {
+            bindless_sampled_images = 0,
+            bindless_storage_buffers = 1,
+            bindless_samplers = 2,
+        };
+
+        struct bindless_config_t
+        {
+            uint32_t                    max_sampled_images = 16384;
+            uint32_t                    max_storage_buffers = 16384;
+            uint32_t                    max_samplers = 256;
+            uint32_t                    frames_in_flight = 2;       // a removed slot is reused after this many frames
+            VkShaderStageFlags          stages = VK_SHADER_STAGE_ALL;
+        };
+
+        /// one update-after-bind descriptor set holding every sampled image, storage buffer and sampler
+        /// slots come from a free list per binding. a removed slot may still be read by a frame in flight,
+        /// so it only returns to the free list frames_in_flight frames later, call begin_frame after
+        /// waiting for the fence of the frame about to be recorded.
+        template <typename Device>
+        class bindless_table
+        {
+            struct slot_pool_t
+            {
+                uint32_t                                    capacity = 0;
+                uint32_t                                    next = 0;
+                std::vector<uint32_t>                       free;
+                std::deque<std::pair<uint64_t, uint32_t>>   retired;    // the frame it is free again, the slot
+
+                uint32_t allocate()
+                {
+                    if (!free.empty())
+                    {
+                        auto slot = free.back();
+                        free.pop_back();
+                        return slot;
+                    }
+
+                    if (next == capacity)
+                        throw std::runtime_error{ "The bindless table is full!" };
+
+                    return next++;
+                }
+
+                void recycle(uint64_t frame)
+                {
+                    while (!retired.empty() && retired.front().first <= frame)
+                    {
+                        free.push_back(retired.front().second);
+                        retired.pop_front();
+                    }
+                }
+            };
+
+        public:
+            bindless_table(Device const& device, bindless_config_t const& config)
+                : device_(&device)
+                , config_(config)
+            {
+                images_.capacity = config.max_sampled_images;
+                buffers_.capacity = config.max_storage_buffers;
+                samplers_.capacity = config.max_samplers;
+
+                VkDescriptorPoolSize const pool_sizes[] =
+                {
+                    { VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, config.max_sampled_images },
+                    { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, config.max_storage_buffers },
+                    { VK_DESCRIPTOR_TYPE_SAMPLER, config.max_samplers },
+                };
+
+                layout_ = device.create_bindless_set_layout(config);
+                pool_ = device.create_descriptor_pool_handle(1, pool_sizes, VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT);
+                if (VK_SUCCESS != device.allocate_descriptor_sets(pool_, 1, &layout_, &set_))
+                    throw std::runtime_error{ "Failed to call vkAllocateDescriptorSets!" };
+            }
+
+            ~bindless_table()
+            {
+                device_->destroy_descriptor_pool(pool_);
+                device_->destroy_descriptor_set_layout(layout_);
+            }
+
+            bindless_table(bindless_table const&) = delete;
+            bindless_table& operator=(bindless_table const&) = delete;
+
+            uint32_t add_image(VkImageView view, VkImageLayout layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
+            {
+                auto slot = images_.allocate();
+                image_writes_.push_back({ slot, { nullptr, view, layout } });
+                return slot;
+            }
+
+            uint32_t add_storage_buffer(VkBuffer buffer, VkDeviceSize offset = 0, VkDeviceSize range = VK_WHOLE_SIZE)
+            {
+                auto slot = buffers_.allocate();
+                buffer_writes_.push_back({ slot, { buffer, offset, range } });
+                return slot;
+            }
+
+            uint32_t add_sampler(VkSampler sampler)
+            {
+                auto slot = samplers_.allocate();
+                sampler_writes_.push_back({ slot, { sampler, nullptr, VK_IMAGE_LAYOUT_UNDEFINED } });
+                return slot;
+            }
+
+            /// a slot is never rewritten while a frame in flight may read it, the new descriptor goes to a new slot
+            /// and the old one retires like a removed slot. shaders switch over with the returned slot.
+            uint32_t update_image(uint32_t slot, VkImageView view, VkImageLayout layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
+            {
+                auto new_slot = add_image(view, layout);
+                remove_image(slot);
+                return new_slot;
+            }
+
+            uint32_t update_storage_buffer(uint32_t slot, VkBuffer buffer, VkDeviceSize offset = 0, VkDeviceSize range = VK_WHOLE_SIZE)
+            {
+                auto new_slot = add_storage_buffer(buffer, offset, range);
+                remove_storage_buffer(slot);
+                return new_slot;
+            }
+
+            uint32_t update_sampler(uint32_t slot, VkSampler sampler)
+            {
+                auto new_slot = add_sampler(sampler);
+                remove_sampler(slot);
+                return new_slot;
+            }
+
+            void remove_image(uint32_t slot)
+            {
+                retire(images_, slot);
+            }
+
+            void remove_storage_buffer(uint32_t slot)
+            {
+                retire(buffers_, slot);
+            }
+
+            void remove_sampler(uint32_t slot)
+            {
+                retire(samplers_, slot);
+            }
+
+            /// return the slots no frame in flight can read anymore
+            void begin_frame()
+            {
+                ++frame_;
+                images_.recycle(frame_);
+                buffers_.recycle(frame_);
+                samplers_.recycle(frame_);
+            }
+
+            /// write the pending descriptors, before the submit of the command buffers reading them
+            void flush()
+            {
+                auto const count = image_writes_.size() + buffer_writes_.size() + sampler_writes_.size();
+                if (0 == count)
+                    return;
+
+                arena_scope_t scope;
+                arena_array<VkWriteDescriptorSet> writes{ scope.get_arena(), count };
+                for (auto const& write : image_writes_)
+                    writes.push_back(make_write(bindless_sampled_images, write.first, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, &write.second, nullptr));
+                for (auto const& write : buffer_writes_)
+                    writes.push_back(make_write(bindless_storage_buffers, write.first, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, nullptr, &write.second));
+                for (auto const& write : sampler_writes_)
+                    writes.push_back(make_write(bindless_samplers, write.first, VK_DESCRIPTOR_TYPE_SAMPLER, &write.second, nullptr));
+
+                device_->update_descriptor_sets(static_cast<uint32_t>(writes.size()), writes.data());
+                image_writes_.clear();
+                buffer_writes_.clear();
+                sampler_writes_.clear();
+            }
+
+            VkDescriptorSet get_set() const noexcept
+            {
+                return set_;
+            }
+
+            VkDescriptorSetLayout get_layout() const noexcept
+            {
+                return layout_;
+            }
+
+        private:
+            void retire(slot_pool_t& pool, uint32_t slot)
+            {
+                assert(slot < pool.next);
+                pool.retired.push_back({ frame_ + config_.frames_in_flight, slot });
+            }
+
+            VkWriteDescriptorSet make_write(uint32_t binding, uint32_t slot, VkDescriptorType type,
+                VkDescriptorImageInfo const* image_info, VkDescriptorBufferInfo const* buffer_info) const noexcept
+            {
+                return {
+                    VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,     // VkStructureType                  sType
+                    nullptr,                                    // const void*                      pNext
+                    set_,                                       // VkDescriptorSet                  dstSet
+                    binding,                                    // uint32_t                         dstBinding
+                    slot,                                       // uint32_t                         dstArrayElement
+                    1,                                          // uint32_t                         descriptorCount
+                    type,                                       // VkDescriptorType                 descriptorType
+                    image_info,                                 // const VkDescriptorImageInfo*     pImageInfo
+                    buffer_info,                                // const VkDescriptorBufferInfo*    pBufferInfo
+                    nullptr                                     // const VkBufferView*              pTexelBufferView
+                };
+            }
+
+        private:
+            Device const*                                               device_;
+            bindless_config_t                                           config_;
+            VkDescriptorSetLayout                                       layout_ = nullptr;
+            VkDescriptorPool                                            pool_ = nullptr;
+            VkDescriptorSet                                             set_ = nullptr;
+            slot_pool_t                                                 images_;
+            slot_pool_t                                                 buffers_;
+            slot_pool_t                                                 samplers_;
+            std::vector<std::pair<uint32_t, VkDescriptorImageInfo>>     image_writes_;
+            std::vector<std::pair<uint32_t, VkDescriptorBufferInfo>>    buffer_writes_;
+            std::vector<std::pair<uint32_t, VkDescriptorImageInfo>>     sampler_writes_;
+            uint64_t                                                    frame_ = 0;
+        };
+    }
+
+    template <typename TT, typename Base>
+    class device_extension<ext::descriptor_indexing_ext_t, TT, Base> : public Base
+    {
+        using this_type = TT;
+
+    public:
+        template <typename Instance>
+        device_extension(Instance const& instance, physical_device_t physical_device, VkDevice device)
+            : Base(instance, physical_device, device)
+        {
+            assert(this->get_device() == device);
+        }
+
+        /// the bindless layout carries binding flags, it bypasses the device's layout cache and is owned by the caller
+        VkDescriptorSetLayout create_bindless_set_layout(ext::bindless_config_t const& config) const
+        {
+            VkDescriptorSetLayoutBinding const bindings[] =
+            {
+                { ext::bindless_sampled_images, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, config.max_sampled_images, config.stages, nullptr },
+                { ext::bindless_storage_buffers, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, config.max_storage_buffers, config.stages, nullptr },
+                { ext::bindless_samplers, VK_DESCRIPTOR_TYPE_SAMPLER, config.max_samplers, config.stages, nullptr },
+            };
+
+            VkDescriptorBindingFlagsEXT const flags = VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT |
+                VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT_EXT | VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT;
+            VkDescriptorBindingFlagsEXT const binding_flags[] = { flags, flags, flags };
+
+            VkDescriptorSetLayoutBindingFlagsCreateInfoEXT binding_flags_info =
+            {
+                VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT,     // VkStructureType                      sType
+                nullptr,                                                                    // const void*                          pNext
+                3,                                                                          // uint32_t                             bindingCount
+                binding_flags                                                               // const VkDescriptorBindingFlagsEXT*   pBindingFlags
+            };
+
+            VkDescriptorSetLayoutCreateInfo create_info =
+            {
+                VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,                        // VkStructureType                      sType
+                &binding_flags_info,                                                        // const void*                          pNext
+                VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT,             // VkDescriptorSetLayoutCreateFlags     flags
+                3,                                                                          // uint32_t                             bindingCount
+                bindings                                                                    // const VkDescriptorSetLayoutBinding*  pBindings
+            };
+
+            return this->create_descriptor_set_layout_handle(create_info);
+        }
+
+        /// the whole frame binds the table's one set, see ext::bindless_binding_t for the bindings
+        auto create_bindless_table(ext::bindless_config_t const& config = {}) const
+        {
+            return ext::bindless_table<this_type>{ this->get(), config };
+        }
+    };
+}
@@ -21,6 +21,14 @@ namespace vk
             std::vector<present_mode_t>       present_modes;
         };
 
+        /// the surface properties written into caller-provided storage
+        struct surface_properties_view_t
+        {
+            surface_capabilities_t                      capabilities;
+            fill_result<surface_format_t>               formats;
+            fill_result<present_mode_t>                 present_modes;
+        };
+
         constexpr struct surface_ext_t
         {
             static char const* name() noexcept
@@ -69,10 +77,23 @@ namespace vk
             };
         }
 
+        /// the properties a swapchain resize needs, without allocating
+        auto get_properties(physical_device_t const& device, khr::surface_t const& surface,
+            span<khr::surface_format_t> surface_formats, span<khr::present_mode_t> present_modes) const
+            -> khr::surface_properties_view_t
+        {
+            return {
+                get_capabilities(device, surface),
+                get_formats(device, surface, surface_formats),
+                get_present_modes(device, surface, present_modes)
+            };
+        }
+
         auto get_capabilities(physical_device_t device, khr::surface_t const& surface) const
         {
             khr::surface_capabilities_t surface_capabilities = { 0 };
-            vkGetPhysicalDeviceSurfaceCapabilitiesKHR(device, surface, &surface_capabilities);
+            if (VK_SUCCESS != vkGetPhysicalDeviceSurfaceCapabilitiesKHR(device, surface, &surface_capabilities))
+                throw std::runtime_error{ "Failed to call vkGetPhysicalDeviceSurfaceCapabilitiesKHR!" };
             return surface_capabilities;
         }
 
@@ -102,6 +123,30 @@ namespace vk
             return present_modes;
         }
 
+        /// the per-frame variants for resize handling, they fill caller-provided storage and allocate nothing
+        /// complete is false when the storage was too small, an empty span only reports whether there is anything
+        auto get_formats(physical_device_t device, khr::surface_t const& surface, span<khr::surface_format_t> surface_formats) const
+        {
+            auto count = static_cast<uint32_t>(surface_formats.size());
+            auto result = vkGetPhysicalDeviceSurfaceFormatsKHR(device, surface, &count, surface_formats.data());
+            if (VK_SUCCESS != result && VK_INCOMPLETE != result)
+                throw std::runtime_error{ "Failed to call vkGetPhysicalDeviceSurfaceFormatsKHR!" };
+
+            auto const filled = std::min<size_t>(count, surface_formats.size());
+            return fill_result<khr::surface_format_t>{ surface_formats.first(filled), VK_SUCCESS == result && count <= surface_formats.size() };
+        }
+
+        auto get_present_modes(physical_device_t device, khr::surface_t const& surface, span<khr::present_mode_t> present_modes) const
+        {
+            auto count = static_cast<uint32_t>(present_modes.size());
+            auto result = vkGetPhysicalDeviceSurfacePresentModesKHR(device, surface, &count, present_modes.data());
+            if (VK_SUCCESS != result && VK_INCOMPLETE != result)
+                throw std::runtime_error{ "Failed to call vkGetPhysicalDeviceSurfacePresentModesKHR!" };
+
+            auto const filled = std::min<size_t>(count, present_modes.size());
+            return fill_result<khr::present_mode_t>{ present_modes.first(filled), VK_SUCCESS == result && count <= present_modes.size() };
+        }
+
         bool get_support(physical_device_t device, khr::surface_t const& surface, uint32_t queue_index) const
         {
             VkBool32 result;
@@ -184,6 +229,52 @@ namespace vk
     };
 #endif
 
+    /// KHR get physical device properties2 extension is an instance extension
+    /// it queries the feature structures of device extensions, which they check before device creation
+    namespace khr
+    {
+        constexpr struct get_physical_device_properties2_ext_t
+        {
+            static char const* name() noexcept
+            {
+                return VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME;
+            }
+        } get_physical_device_properties2_ext;
+    }
+
+    template <typename TT, typename Base>
+    class instance_extension<khr::get_physical_device_properties2_ext_t, TT, Base> : public Base
+    {
+        using this_type = TT;
+
+    protected:
+        instance_extension(instance_extension const&) = delete;
+        instance_extension& operator=(instance_extension const&) = delete;
+        instance_extension(instance_extension&&) = default;
+        instance_extension& operator=(instance_extension&&) = default;
+
+        instance_extension(global_t const& global, VkInstance instance)
+            : Base(global, instance)
+        {
+            assert(this->get_instance() == instance);
+            VULKAN_LOAD_INSTNACE_FUNCTION(vkGetPhysicalDeviceFeatures2KHR);
+        }
+
+    public:
+        /// fill the extension feature structures chained to next, returns the core features
+        physical_device_features_t query_physical_device_features(VkPhysicalDevice device, void* next) const
+        {
+            VkPhysicalDeviceFeatures2KHR features = {};
+            features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR;
+            features.pNext = next;
+            vkGetPhysicalDeviceFeatures2KHR(device, &features);
+            return features.features;
+        }
+
+    private:
+        VULKAN_DECLARE_FUNCTION(vkGetPhysicalDeviceFeatures2KHR);
+    };
+
     // KHR swapchain extension is a device extension
     namespace khr
     {
@@ -219,10 +310,65 @@ namespace vk
                 {
                 }
 
+                swapchain_t(object<VkSwapchainKHR> swapchain, std::vector<VkImage> images,
+                    std::vector<object<VkImageView>> image_views, swapchain_config_t const& config)
+                    : swapchain_(std::move(swapchain))
+                    , swapchain_images_(std::move(images))
+                    , swapchain_image_views_(std::move(image_views))
+                    , extent_(config.present_image_size)
+                    , format_(config.present_image_format.format)
+                {
+                }
+
+                operator VkSwapchainKHR() const noexcept
+                {
+                    return swapchain_;
+                }
+
+                std::vector<VkImage> const& get_images() const noexcept
+                {
+                    return swapchain_images_;
+                }
+
+                VkImageView get_image_view(uint32_t index) const noexcept
+                {
+                    return swapchain_image_views_[index];
+                }
+
+                extent_2d_t get_extent() const noexcept
+                {
+                    return extent_;
+                }
+
+                format_t get_format() const noexcept
+                {
+                    return format_;
+                }
+
+                /// one framebuffer per swapchain image, looked up in the framebuffer cache of the device every call
+                /// the cache drops them with their views, so nothing is kept here
+                template <typename Device>
+                std::vector<VkFramebuffer> get_framebuffers(Device const& device,
+                    VkRenderPass render_pass, VkImageView depth_view = nullptr) const
+                {
+                    std::vector<VkFramebuffer> framebuffers;
+                    framebuffers.reserve(swapchain_image_views_.size());
+                    for (auto const& image_view : swapchain_image_views_)
+                    {
+                        std::array<VkImageView, 2> views = { image_view, depth_view };
+                        framebuffers.push_back(device.create_framebuffer(render_pass,
+                            views.data(), nullptr != depth_view ? 2 : 1, extent_));
+                    }
+                    return framebuffers;
+                }
+
             private:
-                object<VkSwapchainKHR>      swapchain_;
-                std::vector<VkImage>        swapchain_images_;
-                std::vector<VkFramebuffer>  swapchain_framebuffers_;
+                // the views are destroyed before the swapchain, which evicts the framebuffers
+                object<VkSwapchainKHR>              swapchain_;
+                std::vector<VkImage>                swapchain_images_;
+                std::vector<object<VkImageView>>    swapchain_image_views_;
+                extent_2d_t                         extent_ = { 0, 0 };
+                format_t                            format_ = VK_FORMAT_UNDEFINED;
             };
         }
 
@@ -235,8 +381,8 @@ namespace vk
 
     public:
         template <typename Instance>
-        device_extension(Instance const& instance, VkDevice device)
-            : Base(instance, device)
+        device_extension(Instance const& instance, physical_device_t physical_device, VkDevice device)
+            : Base(instance, physical_device, device)
         {
             assert(this->get_device() == device);
             VULKAN_LOAD_DEVICE_FUNCTION(vkCreateSwapchainKHR);
@@ -246,12 +392,15 @@ namespace vk
             VULKAN_LOAD_DEVICE_FUNCTION(vkDestroySwapchainKHR);
         }
 
-        auto create_swapchain(khr::surface_t const& surface, khr::swapchain_config_t const& config)
+        /// the old swapchain is retired by the new one, its images can still be presented until it is destroyed
+        /// next is an extension chain, typically built with a pnext_chain_t in the frame arena
+        auto create_swapchain(khr::surface_t const& surface, khr::swapchain_config_t const& config,
+            VkSwapchainKHR old_swapchain = nullptr, void const* next = nullptr) const
         {
             VkSwapchainCreateInfoKHR create_info = 
             {
                 VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR,    // VkStructureType                  sType
-                nullptr,                                        // const void*                      pNext
+                next,                                           // const void*                      pNext
                 0,                                              // VkSwapchainCreateFlagsKHR        flags
                 surface,                                        // VkSurfaceKHR                     surface
                 config.present_image_count,                     // uint32_t                         minImageCount
@@ -269,16 +418,95 @@ namespace vk
                 config.composite_alpha,                         // VkCompositeAlphaFlagBitsKHR      compositeAlpha
                 config.present_mode,                            // VkPresentModeKHR                 presentMode
                 static_cast<VkBool32>(config.clipped),          // VkBool32                         clipped
-                nullptr                                         // VkSwapchainKHR                   oldSwapchain
+                old_swapchain                                   // VkSwapchainKHR                   oldSwapchain
             };
 
-            VkSwapchainKHR swapchain;
-            vkCreateSwapchainKHR(this->get_device(), &create_info, nullptr, &swapchain);
+            VkSwapchainKHR swapchain = nullptr;
+            if (VK_SUCCESS != vkCreateSwapchainKHR(this->get_device(), &create_info, nullptr, &swapchain))
+                throw std::runtime_error{ "Failed to call vkCreateSwapchainKHR!" };
+
             return khr::swapchain_t{ swapchain,  [this](VkSwapchainKHR swapchain) { 
                 vkDestroySwapchainKHR(this->get_device(), swapchain, nullptr); 
             } };
         }
 
+        auto get_swapchain_images(VkSwapchainKHR swapchain) const
+        {
+            uint32_t count{ 0 };
+            std::vector<VkImage> images;
+            vkGetSwapchainImagesKHR(this->get_device(), swapchain, &count, nullptr);
+            if (count > 0)
+            {
+                images.resize(count);
+                vkGetSwapchainImagesKHR(this->get_device(), swapchain, &count, images.data());
+            }
+            return images;
+        }
+
+        /// swapchain together with its images and a view for each of them
+        auto create_presentable_swapchain(khr::surface_t const& surface, khr::swapchain_config_t const& config,
+            VkSwapchainKHR old_swapchain = nullptr) const
+        {
+            auto swapchain = create_swapchain(surface, config, old_swapchain);
+            auto images = get_swapchain_images(swapchain);
+
+            std::vector<object<VkImageView>> image_views;
+            image_views.reserve(images.size());
+            for (auto image : images)
+            {
+                VkImageViewCreateInfo create_info =
+                {
+                    VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,   // VkStructureType                  sType
+                    nullptr,                                    // const void*                      pNext
+                    0,                                          // VkImageViewCreateFlags           flags
+                    image,                                      // VkImage                          image
+                    VK_IMAGE_VIEW_TYPE_2D,                      // VkImageViewType                  viewType
+                    config.present_image_format.format,         // VkFormat                         format
+                    {                                           // VkComponentMapping               components
+                        VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY,
+                        VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY
+                    },
+                    { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 }   // VkImageSubresourceRange          subresourceRange
+                };
+                image_views.push_back(this->create_image_view(create_info));
+            }
+
+            return khr::detail::swapchain_t{ std::move(swapchain), std::move(images), std::move(image_views), config };
+        }
+
+        /// VK_SUBOPTIMAL_KHR and VK_ERROR_OUT_OF_DATE_KHR are returned to the caller, which recreates the swapchain
+        VkResult acquire_next_image(VkSwapchainKHR swapchain, VkSemaphore semaphore, VkFence fence,
+            uint32_t& image_index, uint64_t timeout = UINT64_MAX) const
+        {
+            auto result = vkAcquireNextImageKHR(this->get_device(), swapchain, timeout, semaphore, fence, &image_index);
+            if (VK_SUCCESS != result && VK_SUBOPTIMAL_KHR != result && VK_ERROR_OUT_OF_DATE_KHR != result &&
+                VK_TIMEOUT != result && VK_NOT_READY != result)
+                throw std::runtime_error{ "Failed to call vkAcquireNextImageKHR!" };
+
+            return result;
+        }
+
+        VkResult queue_present(VkQueue queue, VkSwapchainKHR swapchain, uint32_t image_index, VkSemaphore wait_semaphore) const
+        {
+            VkPresentInfoKHR present_info =
+            {
+                VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,             // VkStructureType                  sType
+                nullptr,                                        // const void*                      pNext
+                nullptr != wait_semaphore ? 1u : 0u,            // uint32_t                         waitSemaphoreCount
+                &wait_semaphore,                                // const VkSemaphore*               pWaitSemaphores
+                1,                                              // uint32_t                         swapchainCount
+                &swapchain,                                     // const VkSwapchainKHR*            pSwapchains
+                &image_index,                                   // const uint32_t*                  pImageIndices
+                nullptr                                         // VkResult*                        pResults
+            };
+
+            auto result = vkQueuePresentKHR(queue, &present_info);
+            if (VK_SUCCESS != result && VK_SUBOPTIMAL_KHR != result && VK_ERROR_OUT_OF_DATE_KHR != result)
+                throw std::runtime_error{ "Failed to call vkQueuePresentKHR!" };
+
+            return result;
+        }
+
     private:
         VULKAN_DECLARE_FUNCTION(vkCreateSwapchainKHR);
         VULKAN_DECLARE_FUNCTION(vkGetSwapchainImagesKHR);
@@ -286,4 +514,377 @@ namespace vk
         VULKAN_DECLARE_FUNCTION(vkQueuePresentKHR);
         VULKAN_DECLARE_FUNCTION(vkDestroySwapchainKHR);
     };
+
+    // KHR descriptor update template extension is a device extension
+    namespace khr
+    {
+        constexpr struct descriptor_update_template_ext_t
+        {
+            static char const* name() noexcept
+            {
+                return VK_KHR_DESCRIPTOR_UPDATE_TEMPLATE_EXTENSION_NAME;
+            }
+        } descriptor_update_template_ext;
+    }
+
+    template <typename TT, typename Base>
+    class device_extension<khr::descriptor_update_template_ext_t, TT, Base> : public Base
+    {
+        using this_type = TT;
+
+    public:
+        template <typename Instance>
+        device_extension(Instance const& instance, physical_device_t physical_device, VkDevice device)
+            : Base(instance, physical_device, device)
+        {
+            assert(this->get_device() == device);
+            VULKAN_LOAD_DEVICE_FUNCTION(vkCreateDescriptorUpdateTemplateKHR);
+            VULKAN_LOAD_DEVICE_FUNCTION(vkDestroyDescriptorUpdateTemplateKHR);
+            VULKAN_LOAD_DEVICE_FUNCTION(vkUpdateDescriptorSetWithTemplateKHR);
+        }
+
+        /// a push descriptor template also names the pipeline layout and set it is pushed to
+        VkDescriptorUpdateTemplateKHR create_descriptor_update_template_handle(
+            VkDescriptorSetLayout layout,
+            span<VkDescriptorUpdateTemplateEntryKHR const> entries,
+            VkDescriptorUpdateTemplateTypeKHR type = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET_KHR,
+            VkPipelineBindPoint bind_point = VK_PIPELINE_BIND_POINT_GRAPHICS,
+            VkPipelineLayout pipeline_layout = nullptr,
+            uint32_t set = 0) const
+        {
+            VkDescriptorUpdateTemplateCreateInfoKHR create_info =
+            {
+                VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO_KHR,   // VkStructureType                          sType
+                nullptr,                                                        // const void*                              pNext
+                0,                                                              // VkDescriptorUpdateTemplateCreateFlags    flags
+                static_cast<uint32_t>(entries.size()),                          // uint32_t                                 descriptorUpdateEntryCount
+                entries.data(),                                                 // const VkDescriptorUpdateTemplateEntry*   pDescriptorUpdateEntries
+                type,                                                           // VkDescriptorUpdateTemplateType           templateType
+                layout,                                                         // VkDescriptorSetLayout                    descriptorSetLayout
+                bind_point,                                                     // VkPipelineBindPoint                      pipelineBindPoint
+                pipeline_layout,                                                // VkPipelineLayout                         pipelineLayout
+                set                                                             // uint32_t                                 set
+            };
+
+            VkDescriptorUpdateTemplateKHR update_template = nullptr;
+            if (VK_SUCCESS != vkCreateDescriptorUpdateTemplateKHR(this->get_device(), &create_info, nullptr, &update_template))
+                throw std::runtime_error{ "Failed to call vkCreateDescriptorUpdateTemplateKHR!" };
+
+            return update_template;
+        }
+
+        void destroy_descriptor_update_template(VkDescriptorUpdateTemplateKHR update_template) const
+        {
+            if (nullptr != update_template)
+                vkDestroyDescriptorUpdateTemplateKHR(this->get_device(), update_template, nullptr);
+        }
+
+        void update_descriptor_set_with_template(VkDescriptorSet set,
+            VkDescriptorUpdateTemplateKHR update_template, void const* data) const
+        {
+            vkUpdateDescriptorSetWithTemplateKHR(this->get_device(), set, update_template, data);
+        }
+
+    private:
+        VULKAN_DECLARE_FUNCTION(vkCreateDescriptorUpdateTemplateKHR);
+        VULKAN_DECLARE_FUNCTION(vkDestroyDescriptorUpdateTemplateKHR);
+        VULKAN_DECLARE_FUNCTION(vkUpdateDescriptorSetWithTemplateKHR);
+    };
+
+    // KHR maintenance3 extension is a device extension, descriptor indexing depends on it
+    namespace khr
+    {
+        constexpr struct maintenance3_ext_t
+        {
+            static char const* name() noexcept
+            {
+                return VK_KHR_MAINTENANCE3_EXTENSION_NAME;
+            }
+        } maintenance3_ext;
+    }
+
+    template <typename TT, typename Base>
+    class device_extension<khr::maintenance3_ext_t, TT, Base> : public Base
+    {
+    public:
+        template <typename Instance>
+        device_extension(Instance const& instance, physical_device_t physical_device, VkDevice device)
+            : Base(instance, physical_device, device)
+        {}
+    };
+
+    // KHR push descriptor extension is a device extension
+    namespace khr
+    {
+        constexpr struct push_descriptor_ext_t
+        {
+            static char const* name() noexcept
+            {
+                return VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME;
+            }
+        } push_descriptor_ext;
+    }
+
+    template <typename TT, typename Base>
+    class device_extension<khr::push_descriptor_ext_t, TT, Base> : public Base
+    {
+        using this_type = TT;
+
+    public:
+        template <typename Instance>
+        device_extension(Instance const& instance, physical_device_t physical_device, VkDevice device)
+            : Base(instance, physical_device, device)
+        {
+            assert(this->get_device() == device);
+            VULKAN_LOAD_DEVICE_FUNCTION(vkCmdPushDescriptorSetKHR);
+            this->get_extension_command_table().vkCmdPushDescriptorSetKHR = vkCmdPushDescriptorSetKHR;
+
+            // the template variant only exists together with the descriptor update template extension
+            vkCmdPushDescriptorSetWithTemplateKHR = nullptr;
+            if constexpr (detail::has_descriptor_update_template_v<this_type>)
+                VULKAN_LOAD_DEVICE_FUNCTION(vkCmdPushDescriptorSetWithTemplateKHR);
+        }
+
+        /// the writes go straight into the command buffer, their dstSet is ignored
+        /// record through command_recorder::push_descriptor_set to keep its shadowed sets valid
+        void push_descriptor_set(VkCommandBuffer command_buffer, VkPipelineBindPoint bind_point, VkPipelineLayout layout,
+            uint32_t set, uint32_t write_count, VkWriteDescriptorSet const* writes) const
+        {
+            vkCmdPushDescriptorSetKHR(command_buffer, bind_point, layout, set, write_count, writes);
+        }
+
+        /// the template has to be created with VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_PUSH_DESCRIPTORS_KHR
+        void push_descriptor_set_with_template(VkCommandBuffer command_buffer, VkDescriptorUpdateTemplateKHR update_template,
+            VkPipelineLayout layout, uint32_t set, void const* data) const
+        {
+            assert(nullptr != vkCmdPushDescriptorSetWithTemplateKHR);
+            vkCmdPushDescriptorSetWithTemplateKHR(command_buffer, update_template, layout, set, data);
+        }
+
+    private:
+        VULKAN_DECLARE_FUNCTION(vkCmdPushDescriptorSetKHR);
+        VULKAN_DECLARE_FUNCTION(vkCmdPushDescriptorSetWithTemplateKHR);
+    };
+
+#ifdef VK_KHR_dynamic_rendering
+    // KHR dynamic rendering extension is a device extension, it renders to image views without render pass objects
+    namespace khr
+    {
+        constexpr struct dynamic_rendering_ext_t
+        {
+            static char const* name() noexcept
+            {
+                return VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME;
+            }
+
+            template <typename Instance>
+            static void chain_features(pnext_chain_t& chain, Instance const& instance, VkPhysicalDevice physical_device)
+            {
+                VkPhysicalDeviceDynamicRenderingFeaturesKHR features = {};
+                features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR;
+                if (!detail::query_device_features(instance, physical_device, features).dynamicRendering)
+                    throw std::runtime_error{ "The physical device does not support dynamicRendering!" };
+
+                features.dynamicRendering = VK_TRUE;
+                chain.add(features);
+            }
+        } dynamic_rendering_ext;
+
+        struct rendering_attachment_t
+        {
+            VkImageView                     view = nullptr;
+            VkImageLayout                   layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+            VkAttachmentLoadOp              load_op = VK_ATTACHMENT_LOAD_OP_CLEAR;
+            VkAttachmentStoreOp             store_op = VK_ATTACHMENT_STORE_OP_STORE;
+            VkClearValue                    clear_value = {};
+            VkResolveModeFlagBitsKHR        resolve_mode = VK_RESOLVE_MODE_NONE_KHR;
+            VkImageView                     resolve_view = nullptr;
+            VkImageLayout                   resolve_layout = VK_IMAGE_LAYOUT_UNDEFINED;
+        };
+
+        struct rendering_info_t
+        {
+            VkRect2D                                area = {};
+            span<rendering_attachment_t const>      color_attachments;
+            rendering_attachment_t const*           depth_attachment = nullptr;
+            rendering_attachment_t const*           stencil_attachment = nullptr;
+            uint32_t                                layer_count = 1;
+            uint32_t                                view_mask = 0;
+        };
+
+        /// what a pipeline renders to in place of its render pass
+        struct rendering_formats_t
+        {
+            span<VkFormat const>            color_formats;
+            VkFormat                        depth_format = VK_FORMAT_UNDEFINED;
+            VkFormat                        stencil_format = VK_FORMAT_UNDEFINED;
+            uint32_t                        view_mask = 0;
+        };
+
+        using pipeline_t = object<VkPipeline>;
+    }
+
+    template <typename TT, typename Base>
+    class device_extension<khr::dynamic_rendering_ext_t, TT, Base> : public Base
+    {
+        using this_type = TT;
+
+    public:
+        template <typename Instance>
+        device_extension(Instance const& instance, physical_device_t physical_device, VkDevice device)
+            : Base(instance, physical_device, device)
+        {
+            assert(this->get_device() == device);
+            VULKAN_LOAD_DEVICE_FUNCTION(vkCmdBeginRenderingKHR);
+            VULKAN_LOAD_DEVICE_FUNCTION(vkCmdEndRenderingKHR);
+            this->get_extension_command_table().vkCmdBeginRenderingKHR = vkCmdBeginRenderingKHR;
+            this->get_extension_command_table().vkCmdEndRenderingKHR = vkCmdEndRenderingKHR;
+        }
+
+        /// the attachments are used in the layouts given, transition them before
+        void begin_rendering(VkCommandBuffer command_buffer, khr::rendering_info_t const& info) const
+        {
+            with_rendering_info(info, [this, command_buffer](VkRenderingInfoKHR const& rendering_info)
+            {
+                vkCmdBeginRenderingKHR(command_buffer, &rendering_info);
+            });
+        }
+
+        /// records through the recorder's table, which flushes the pending barriers first and
+        /// keeps later draws from flushing inside the scope
+        void begin_rendering(command_recorder<this_type>& recorder, khr::rendering_info_t const& info) const
+        {
+            with_rendering_info(info, [&recorder](VkRenderingInfoKHR const& rendering_info)
+            {
+                recorder.begin_rendering(rendering_info);
+            });
+        }
+
+        void end_rendering(VkCommandBuffer command_buffer) const
+        {
+            vkCmdEndRenderingKHR(command_buffer);
+        }
+
+        void end_rendering(command_recorder<this_type>& recorder) const
+        {
+            recorder.end_rendering();
+        }
+
+        /// renderPass and subpass of the create info are ignored, the pipeline renders to the given formats
+        khr::pipeline_t create_graphics_pipeline(VkGraphicsPipelineCreateInfo create_info,
+            khr::rendering_formats_t const& formats, VkPipelineCache cache = nullptr) const
+        {
+            VkPipelineRenderingCreateInfoKHR rendering_create_info =
+            {
+                VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR,               // VkStructureType                      sType
+                create_info.pNext,                                                  // const void*                          pNext
+                formats.view_mask,                                                  // uint32_t                             viewMask
+                static_cast<uint32_t>(formats.color_formats.size()),                // uint32_t                             colorAttachmentCount
+                formats.color_formats.data(),                                       // const VkFormat*                      pColorAttachmentFormats
+                formats.depth_format,                                               // VkFormat                             depthAttachmentFormat
+                formats.stencil_format                                              // VkFormat                             stencilAttachmentFormat
+            };
+            create_info.renderPass = nullptr;
+            create_info.subpass = 0;
+
+            auto pipeline = this->create_graphics_pipeline_handle(create_info, &rendering_create_info, cache);
+            return khr::pipeline_t{ pipeline, [this](VkPipeline pipeline) {
+                this->get().destroy_pipeline(pipeline);
+            } };
+        }
+
+    private:
+        /// the rendering info only lives through the call of begin
+        template <typename Begin>
+        static void with_rendering_info(khr::rendering_info_t const& info, Begin&& begin)
+        {
+            arena_scope_t scope;
+            arena_array<VkRenderingAttachmentInfoKHR> color_attachments{ scope.get_arena(), info.color_attachments.size() };
+            for (auto const& attachment : info.color_attachments)
+                color_attachments.push_back(make_attachment_info(attachment));
+
+            VkRenderingAttachmentInfoKHR depth_attachment = {};
+            if (nullptr != info.depth_attachment)
+                depth_attachment = make_attachment_info(*info.depth_attachment);
+
+            VkRenderingAttachmentInfoKHR stencil_attachment = {};
+            if (nullptr != info.stencil_attachment)
+                stencil_attachment = make_attachment_info(*info.stencil_attachment);
+
+            VkRenderingInfoKHR rendering_info =
+            {
+                VK_STRUCTURE_TYPE_RENDERING_INFO_KHR,                               // VkStructureType                      sType
+                nullptr,                                                            // const void*                          pNext
+                0,                                                                  // VkRenderingFlagsKHR                  flags
+                info.area,                                                          // VkRect2D                             renderArea
+                info.layer_count,                                                   // uint32_t                             layerCount
+                info.view_mask,                                                     // uint32_t                             viewMask
+                static_cast<uint32_t>(color_attachments.size()),                    // uint32_t                             colorAttachmentCount
+                color_attachments.data(),                                           // const VkRenderingAttachmentInfo*     pColorAttachments
+                nullptr != info.depth_attachment ? &depth_attachment : nullptr,     // const VkRenderingAttachmentInfo*     pDepthAttachment
+                nullptr != info.stencil_attachment ? &stencil_attachment : nullptr  // const VkRenderingAttachmentInfo*     pStencilAttachment
+            };
+            begin(rendering_info);
+        }
+
+        static VkRenderingAttachmentInfoKHR make_attachment_info(khr::rendering_attachment_t const& attachment) noexcept
+        {
+            return {
+                VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR,                    // VkStructureType                      sType
+                nullptr,                                                            // const void*                          pNext
+                attachment.view,                                                    // VkImageView                          imageView
+                attachment.layout,                                                  // VkImageLayout                        imageLayout
+                attachment.resolve_mode,                                            // VkResolveModeFlagBits                resolveMode
+                attachment.resolve_view,                                            // VkImageView                          resolveImageView
+                attachment.resolve_layout,                                          // VkImageLayout                        resolveImageLayout
+                attachment.load_op,                                                 // VkAttachmentLoadOp                   loadOp
+                attachment.store_op,                                                // VkAttachmentStoreOp                  storeOp
+                attachment.clear_value                                              // VkClearValue                         clearValue
+            };
+        }
+
+    private:
+        VULKAN_DECLARE_FUNCTION(vkCmdBeginRenderingKHR);
+        VULKAN_DECLARE_FUNCTION(vkCmdEndRenderingKHR);
+    };
+#endif
+
+    // KHR draw indirect count extension is a device extension, the draw count of an indirect draw is read from a buffer
+    namespace khr
+    {
+        constexpr struct draw_indirect_count_ext_t
+        {
+            static char const* name() noexcept
+            {
+                return VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME;
+            }
+        } draw_indirect_count_ext;
+    }
+
+    template <typename TT, typename Base>
+    class device_extension<khr::draw_indirect_count_ext_t, TT, Base> : public Base
+    {
+        using this_type = TT;
+
+    public:
+        template <typename Instance>
+        device_extension(Instance const& instance, physical_device_t physical_device, VkDevice device)
+            : Base(instance, physical_device, device)
+        {
+            assert(this->get_device() == device);
+            VULKAN_LOAD_DEVICE_FUNCTION(vkCmdDrawIndexedIndirectCountKHR);
+            this->get_extension_command_table().vkCmdDrawIndexedIndirectCountKHR = vkCmdDrawIndexedIndirectCountKHR;
+        }
+
+        /// draws min(count, max_draw_count) commands, the count is a uint32_t at count_offset
+        void draw_indexed_indirect_count(command_recorder<this_type>& recorder, VkBuffer buffer, VkDeviceSize offset,
+            VkBuffer count_buffer, VkDeviceSize count_offset, uint32_t max_draw_count,
+            uint32_t stride = sizeof(VkDrawIndexedIndirectCommand)) const
+        {
+            recorder.draw_indexed_indirect_count(buffer, offset, count_buffer, count_offset, max_draw_count, stride);
+        }
+
+    private:
+        VULKAN_DECLARE_FUNCTION(vkCmdDrawIndexedIndirectCountKHR);
+    };
 }
\ No newline at end of file
@@ -0,0 +1,228 @@
+#pragma once
+
+namespace vk
+{
+    /// draw sort key, most significant first: pass(8) | pipeline(16) | descriptor set(16) | depth(24)
+    inline constexpr uint32_t draw_key_depth_bits = 24;
+    inline constexpr uint32_t draw_key_set_bits = 16;
+    inline constexpr uint32_t draw_key_pipeline_bits = 16;
+    inline constexpr uint32_t draw_key_pass_bits = 8;
+
+    inline constexpr uint64_t make_draw_key(uint32_t pass, uint32_t pipeline, uint32_t set, uint32_t depth) noexcept
+    {
+        return (static_cast<uint64_t>(pass & 0xff) << 56) |
+            (static_cast<uint64_t>(pipeline & 0xffff) << 40) |
+            (static_cast<uint64_t>(set & 0xffff) << 24) |
+            static_cast<uint64_t>(depth & 0xffffff);
+    }
+
+    inline constexpr uint32_t get_draw_key_pass(uint64_t key) noexcept
+    {
+        return static_cast<uint32_t>(key >> 56);
+    }
+
+    inline constexpr uint32_t get_draw_key_pipeline(uint64_t key) noexcept
+    {
+        return static_cast<uint32_t>(key >> 40) & 0xffff;
+    }
+
+    inline constexpr uint32_t get_draw_key_set(uint64_t key) noexcept
+    {
+        return static_cast<uint32_t>(key >> 24) & 0xffff;
+    }
+
+    /// depth in [0, 1] to the key's 24 bits, transparent draws sort back to front
+    inline uint32_t quantize_draw_depth(float depth, bool back_to_front = false) noexcept
+    {
+        constexpr uint32_t max_depth = (1u << draw_key_depth_bits) - 1;
+        auto const quantized = static_cast<uint32_t>(std::clamp(depth, 0.0f, 1.0f) * max_depth);
+        return back_to_front ? max_depth - quantized : quantized;
+    }
+
+    struct draw_payload_t
+    {
+        VkBuffer                vertex_buffer = nullptr;
+        VkDeviceSize            vertex_buffer_offset = 0;
+        VkBuffer                index_buffer = nullptr;         // null for non indexed draws
+        VkDeviceSize            index_buffer_offset = 0;
+        VkIndexType             index_type = VK_INDEX_TYPE_UINT16;
+        uint32_t                count = 0;                      // vertices or indices
+        uint32_t                instance_count = 1;
+        uint32_t                first = 0;                      // first vertex or first index
+        int32_t                 vertex_offset = 0;
+        uint32_t                first_instance = 0;
+        uint32_t                user_data = 0;                  // pushed at offset 0 when the pipeline asks for it
+    };
+
+    /// draws recorded as packed sort keys, sorted with a parallel radix sort and replayed
+    /// through a command_recorder so that pipeline and descriptor switches are minimal
+    template <typename Device>
+    class draw_list
+    {
+        struct pipeline_entry_t
+        {
+            VkPipeline              pipeline;
+            VkPipelineLayout        layout;
+            VkShaderStageFlags      user_data_stages;
+        };
+
+        struct set_entry_t
+        {
+            VkDescriptorSet         set;
+            uint32_t                set_index;
+        };
+
+    public:
+        /// descriptor set id of the draws which bind no set of their own
+        inline static constexpr uint32_t no_descriptor_set = 0xffff;
+
+        /// the pool spreads sort() over its threads, it has to outlive the draw list
+        explicit draw_list(worker_pool_t* pool = nullptr)
+            : pool_(pool)
+        {}
+
+        draw_list(draw_list const&) = delete;
+        draw_list& operator=(draw_list const&) = delete;
+
+        /// pipelines are numbered in registration order, which is also their sort order
+        uint32_t register_pipeline(VkPipeline pipeline, VkPipelineLayout layout, VkShaderStageFlags user_data_stages = 0)
+        {
+            auto itr = pipeline_ids_.find(pipeline);
+            if (itr != pipeline_ids_.end())
+                return itr->second;
+
+            if (pipelines_.size() > 0xffff)
+                throw std::runtime_error{ "Too many pipelines in the draw list!" };
+
+            auto id = static_cast<uint32_t>(pipelines_.size());
+            pipelines_.push_back({ pipeline, layout, user_data_stages });
+            pipeline_ids_.emplace(pipeline, id);
+            return id;
+        }
+
+        uint32_t register_descriptor_set(VkDescriptorSet set, uint32_t set_index = 0)
+        {
+            auto itr = set_ids_.find(set);
+            if (itr != set_ids_.end())
+                return itr->second;
+
+            if (sets_.size() >= no_descriptor_set)
+                throw std::runtime_error{ "Too many descriptor sets in the draw list!" };
+
+            auto id = static_cast<uint32_t>(sets_.size());
+            sets_.push_back({ set, set_index });
+            set_ids_.emplace(set, id);
+            return id;
+        }
+
+        void add(uint64_t key, draw_payload_t const& payload)
+        {
+            assert(get_draw_key_pipeline(key) < pipelines_.size());
+            items_.push_back({ key, static_cast<uint32_t>(payloads_.size()) });
+            payloads_.push_back(payload);
+            sorted_ = false;
+        }
+
+        void add(uint32_t pass, uint32_t pipeline, uint32_t set, uint32_t depth, draw_payload_t const& payload)
+        {
+            add(make_draw_key(pass, pipeline, set, depth), payload);
+        }
+
+        void sort()
+        {
+            if (!sorted_)
+                parallel_radix_sort(items_, scratch_, pool_);
+            sorted_ = true;
+        }
+
+        /// replay the draws of one pass, sorting first if needed
+        void replay(command_recorder<Device>& recorder, uint32_t pass)
+        {
+            sort();
+            auto first = std::lower_bound(items_.cbegin(), items_.cend(), make_draw_key(pass, 0, 0, 0),
+                [](auto const& item, uint64_t key) { return item.key < key; });
+            auto last = std::lower_bound(first, items_.cend(), make_draw_key(pass + 1, 0, 0, 0),
+                [](auto const& item, uint64_t key) { return item.key < key; });
+
+            if (pass >= (1u << draw_key_pass_bits) - 1)
+                last = items_.cend();
+
+            replay(recorder, first, last);
+        }
+
+        /// replay every draw in key order
+        void replay(command_recorder<Device>& recorder)
+        {
+            sort();
+            replay(recorder, items_.cbegin(), items_.cend());
+        }
+
+        /// forget the draws, the registered pipelines and descriptor sets are kept
+        void clear() noexcept
+        {
+            items_.clear();
+            payloads_.clear();
+            sorted_ = true;
+        }
+
+        /// forget everything, e.g. when the registered objects are destroyed
+        void reset() noexcept
+        {
+            clear();
+            pipelines_.clear();
+            pipeline_ids_.clear();
+            sets_.clear();
+            set_ids_.clear();
+        }
+
+        size_t size() const noexcept
+        {
+            return items_.size();
+        }
+
+    private:
+        template <typename Iterator>
+        void replay(command_recorder<Device>& recorder, Iterator first, Iterator last) const
+        {
+            for (; first != last; ++first)
+            {
+                auto const& pipeline = pipelines_[get_draw_key_pipeline(first->key)];
+                auto const& payload = payloads_[first->value];
+
+                // the recorder drops the binds which repeat the previous draw's state
+                recorder.bind_pipeline(VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline.pipeline);
+
+                auto set_id = get_draw_key_set(first->key);
+                if (no_descriptor_set != set_id)
+                    recorder.bind_descriptor_set(VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline.layout, sets_[set_id].set_index, sets_[set_id].set);
+
+                if (0 != pipeline.user_data_stages)
+                    recorder.push_constants(pipeline.layout, pipeline.user_data_stages, payload.user_data);
+
+                if (nullptr != payload.vertex_buffer)
+                    recorder.bind_vertex_buffer(0, payload.vertex_buffer, payload.vertex_buffer_offset);
+
+                if (nullptr != payload.index_buffer)
+                {
+                    recorder.bind_index_buffer(payload.index_buffer, payload.index_buffer_offset, payload.index_type);
+                    recorder.draw_indexed(payload.count, payload.instance_count, payload.first, payload.vertex_offset, payload.first_instance);
+                }
+                else
+                {
+                    recorder.draw(payload.count, payload.instance_count, payload.first, payload.first_instance);
+                }
+            }
+        }
+
+    private:
+        std::vector<sort_item_t>                        items_;
+        std::vector<sort_item_t>                        scratch_;
+        std::vector<draw_payload_t>                     payloads_;
+        std::vector<pipeline_entry_t>                   pipelines_;
+        std::unordered_map<VkPipeline, uint32_t>        pipeline_ids_;
+        std::vector<set_entry_t>                        sets_;
+        std::unordered_map<VkDescriptorSet, uint32_t>   set_ids_;
+        worker_pool_t*                                  pool_;
+        bool                                            sorted_ = true;
+    };
+}
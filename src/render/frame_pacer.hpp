@@ -0,0 +1,216 @@
+#pragma once
+
+namespace vk
+{
+    struct frame_pacing_config_t
+    {
+        std::chrono::microseconds   target_latency{ 33333 };    // input to present budget
+        uint32_t                    refresh_rate = 60;          // Hz of the display
+        bool                        allow_tearing = false;      // IMMEDIATE may be picked
+    };
+
+    struct frame_pacing_plan_t
+    {
+        khr::present_mode_t         present_mode = VK_PRESENT_MODE_FIFO_KHR;
+        uint32_t                    image_count = 2;
+        uint32_t                    frames_ahead = 1;           // frames the CPU may run ahead of the GPU
+    };
+
+    struct frame_latency_statistics_t
+    {
+        uint64_t                    frames = 0;
+        double                      average_latency_ms = 0.0;
+        double                      min_latency_ms = 0.0;
+        double                      max_latency_ms = 0.0;
+        double                      latency_jitter_ms = 0.0;    // standard deviation of the latency
+        double                      average_frame_time_ms = 0.0;
+        double                      frame_time_jitter_ms = 0.0; // standard deviation of the frame time
+    };
+
+    /// present mode, image count and CPU lead that fit in the latency budget
+    /// a budget under three refresh intervals asks for a mode which does not queue behind vblank
+    inline frame_pacing_plan_t plan_frame_pacing(frame_pacing_config_t const& config,
+        std::vector<khr::present_mode_t> const& present_modes, khr::surface_capabilities_t const& capabilities)
+    {
+        auto has_mode = [&present_modes](khr::present_mode_t mode)
+        {
+            return std::find(present_modes.cbegin(), present_modes.cend(), mode) != present_modes.cend();
+        };
+
+        auto const refresh_period = std::chrono::microseconds{ 1000000 / std::max(config.refresh_rate, 1u) };
+        auto const budget_frames = static_cast<uint32_t>(config.target_latency / refresh_period);
+
+        frame_pacing_plan_t plan;
+        plan.frames_ahead = std::clamp(budget_frames, 2u, 4u) - 1;
+
+        if (budget_frames < 3)
+        {
+            if (has_mode(VK_PRESENT_MODE_MAILBOX_KHR))
+                plan.present_mode = VK_PRESENT_MODE_MAILBOX_KHR;
+            else if (config.allow_tearing && has_mode(VK_PRESENT_MODE_IMMEDIATE_KHR))
+                plan.present_mode = VK_PRESENT_MODE_IMMEDIATE_KHR;
+            else if (has_mode(VK_PRESENT_MODE_FIFO_RELAXED_KHR))
+                plan.present_mode = VK_PRESENT_MODE_FIFO_RELAXED_KHR;
+        }
+
+        // mailbox needs a spare image to replace, fifo queues one image per frame ahead
+        switch (plan.present_mode)
+        {
+        case VK_PRESENT_MODE_MAILBOX_KHR:
+            plan.image_count = 3;
+            break;
+        case VK_PRESENT_MODE_IMMEDIATE_KHR:
+            plan.image_count = 2;
+            break;
+        default:
+            plan.image_count = plan.frames_ahead + 1;
+            break;
+        }
+
+        plan.image_count = std::max(plan.image_count, capabilities.minImageCount);
+        if (0 != capabilities.maxImageCount)
+            plan.image_count = std::min(plan.image_count, capabilities.maxImageCount);
+
+        return plan;
+    }
+
+    inline void apply_frame_pacing(frame_pacing_plan_t const& plan, khr::swapchain_config_t& swapchain_config) noexcept
+    {
+        swapchain_config.present_mode = plan.present_mode;
+        swapchain_config.present_image_count = plan.image_count;
+    }
+
+    /// throttles the CPU to N frames ahead of the GPU and measures input to present latency
+    /// the latency ends when the frame's submission fence is seen signaled, which is the moment its
+    /// image is handed to the presentation engine. N must not exceed the presenter's frames in flight,
+    /// so every fence is observed before it is reset for reuse.
+    template <typename Device>
+    class frame_pacer
+    {
+        using clock_t = std::chrono::steady_clock;
+
+        inline static constexpr size_t window_size = 128;
+
+        struct pending_frame_t
+        {
+            VkFence                     fence;
+            clock_t::time_point         input_time;
+        };
+
+    public:
+        frame_pacer(Device const& device, uint32_t frames_ahead)
+            : device_(&device)
+            , frames_ahead_(std::max(frames_ahead, 1u))
+        {}
+
+        /// call right before the input of a frame is sampled
+        void begin_frame()
+        {
+            retire(false);
+            while (pending_.size() >= frames_ahead_)
+            {
+                device_->wait_for_fence(pending_.front().fence);
+                retire(true);
+            }
+
+            auto const now = clock_t::now();
+            if (last_begin_ != clock_t::time_point{})
+                push_sample(frame_times_, frame_time_count_, to_ms(now - last_begin_));
+
+            last_begin_ = now;
+            input_time_ = now;
+        }
+
+        /// the fence signaled when the frame's work is done
+        void end_frame(VkFence fence)
+        {
+            pending_.push_back({ fence, input_time_ });
+        }
+
+        void set_frames_ahead(uint32_t frames_ahead) noexcept
+        {
+            frames_ahead_ = std::max(frames_ahead, 1u);
+        }
+
+        uint32_t get_frames_ahead() const noexcept
+        {
+            return frames_ahead_;
+        }
+
+        /// statistics over the most recent frames
+        frame_latency_statistics_t get_statistics() const
+        {
+            frame_latency_statistics_t statistics;
+            statistics.frames = frames_;
+
+            auto const latency_count = std::min(latency_count_, window_size);
+            if (latency_count > 0)
+            {
+                auto first = latencies_.cbegin();
+                auto last = first + latency_count;
+                statistics.min_latency_ms = *std::min_element(first, last);
+                statistics.max_latency_ms = *std::max_element(first, last);
+                std::tie(statistics.average_latency_ms, statistics.latency_jitter_ms) = mean_deviation(first, last);
+            }
+
+            auto const frame_time_count = std::min(frame_time_count_, window_size);
+            if (frame_time_count > 0)
+            {
+                auto first = frame_times_.cbegin();
+                std::tie(statistics.average_frame_time_ms, statistics.frame_time_jitter_ms) =
+                    mean_deviation(first, first + frame_time_count);
+            }
+
+            return statistics;
+        }
+
+    private:
+        // record the frames whose fences have signaled, in submission order
+        void retire(bool front_signaled)
+        {
+            auto const now = clock_t::now();
+            while (!pending_.empty() && (front_signaled || device_->is_fence_signaled(pending_.front().fence)))
+            {
+                push_sample(latencies_, latency_count_, to_ms(now - pending_.front().input_time));
+                pending_.pop_front();
+                ++frames_;
+                front_signaled = false;
+            }
+        }
+
+        static double to_ms(clock_t::duration duration) noexcept
+        {
+            return std::chrono::duration<double, std::milli>(duration).count();
+        }
+
+        static void push_sample(std::array<double, window_size>& samples, size_t& count, double value) noexcept
+        {
+            samples[count % window_size] = value;
+            ++count;
+        }
+
+        template <typename Iterator>
+        static std::pair<double, double> mean_deviation(Iterator first, Iterator last)
+        {
+            auto const count = static_cast<double>(std::distance(first, last));
+            auto const mean = std::accumulate(first, last, 0.0) / count;
+            auto const variance = std::accumulate(first, last, 0.0, [mean](double sum, double value)
+            {
+                return sum + (value - mean) * (value - mean);
+            }) / count;
+            return { mean, std::sqrt(variance) };
+        }
+
+    private:
+        Device const*                           device_;
+        uint32_t                                frames_ahead_;
+        std::deque<pending_frame_t>             pending_;
+        clock_t::time_point                     input_time_;
+        clock_t::time_point                     last_begin_;
+        std::array<double, window_size>         latencies_ = {};
+        std::array<double, window_size>         frame_times_ = {};
+        size_t                                  latency_count_ = 0;
+        size_t                                  frame_time_count_ = 0;
+        uint64_t                                frames_ = 0;
+    };
+}
@@ -0,0 +1,306 @@
+#pragma once
+
+namespace vk
+{
+    namespace detail
+    {
+        /// first fit sub-allocator over a range of elements, freed ranges coalesce with their neighbours
+        class range_allocator_t
+        {
+        public:
+            inline static constexpr uint32_t invalid_offset = invalid_index;
+
+            explicit range_allocator_t(uint32_t capacity = 0)
+                : capacity_(capacity)
+            {
+                if (0 != capacity)
+                    free_ranges_.emplace(0, capacity);
+            }
+
+            uint32_t allocate(uint32_t count)
+            {
+                if (0 == count)
+                    return 0;
+
+                for (auto itr = free_ranges_.begin(); itr != free_ranges_.end(); ++itr)
+                {
+                    if (itr->second < count)
+                        continue;
+
+                    auto const offset = itr->first;
+                    auto const remaining = itr->second - count;
+                    free_ranges_.erase(itr);
+                    if (0 != remaining)
+                        free_ranges_.emplace(offset + count, remaining);
+                    used_ += count;
+                    return offset;
+                }
+                return invalid_offset;
+            }
+
+            void free(uint32_t offset, uint32_t count)
+            {
+                if (0 == count)
+                    return;
+
+                assert(offset + count <= capacity_ && used_ >= count);
+                used_ -= count;
+                auto next = free_ranges_.lower_bound(offset);
+                if (next != free_ranges_.end() && offset + count == next->first)
+                {
+                    count += next->second;
+                    next = free_ranges_.erase(next);
+                }
+
+                if (next != free_ranges_.begin())
+                {
+                    auto previous = std::prev(next);
+                    if (previous->first + previous->second == offset)
+                    {
+                        previous->second += count;
+                        return;
+                    }
+                }
+                free_ranges_.emplace_hint(next, offset, count);
+            }
+
+            uint32_t get_capacity() const noexcept
+            {
+                return capacity_;
+            }
+
+            uint32_t get_used() const noexcept
+            {
+                return used_;
+            }
+
+        private:
+            std::map<uint32_t, uint32_t>    free_ranges_;       // offset to count
+            uint32_t                        capacity_;
+            uint32_t                        used_ = 0;
+        };
+    }
+
+    struct geometry_pool_config_t
+    {
+        uint32_t                vertex_capacity = 4 * 1024 * 1024;                  // vertices
+        uint32_t                index_capacity = 16 * 1024 * 1024;                  // indices
+        uint32_t                vertex_stride = 32;                                 // bytes, every mesh shares the vertex format
+        VkIndexType             index_type = VK_INDEX_TYPE_UINT32;
+        VkBufferUsageFlags      usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;          // added to the vertex and index usage
+        VkMemoryPropertyFlags   memory_properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    };
+
+    /// where a mesh lives in the pool, in elements, which is what an indexed draw takes
+    struct geometry_range_t
+    {
+        uint32_t                first_vertex = 0;
+        uint32_t                vertex_count = 0;
+        uint32_t                first_index = 0;
+        uint32_t                index_count = 0;
+    };
+
+    /// vertex and index ranges of many meshes sub-allocated out of one vertex and one index buffer
+    /// every mesh draws with the same two bindings, so a frame of meshes collapses into a few
+    /// indirect draws. the pool owns no staging memory, upload with the copy regions it hands out.
+    template <typename Device>
+    class geometry_pool
+    {
+    public:
+        geometry_pool(Device const& device, geometry_pool_config_t const& config = {})
+            : device_(&device)
+            , config_(config)
+            , vertices_(config.vertex_capacity)
+            , indices_(config.index_capacity)
+        {
+            vertex_buffer_ = detail::create_device_buffer(device, static_cast<VkDeviceSize>(config.vertex_capacity) * config.vertex_stride,
+                VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | config.usage, config.memory_properties);
+            try
+            {
+                index_buffer_ = detail::create_device_buffer(device, static_cast<VkDeviceSize>(config.index_capacity) * get_index_size(),
+                    VK_BUFFER_USAGE_INDEX_BUFFER_BIT | config.usage, config.memory_properties);
+            }
+            catch (...)
+            {
+                detail::destroy_device_buffer(device, vertex_buffer_);
+                throw;
+            }
+        }
+
+        ~geometry_pool()
+        {
+            detail::destroy_device_buffer(*device_, index_buffer_);
+            detail::destroy_device_buffer(*device_, vertex_buffer_);
+        }
+
+        geometry_pool(geometry_pool const&) = delete;
+        geometry_pool& operator=(geometry_pool const&) = delete;
+
+        /// throws when either buffer has no contiguous range left
+        geometry_range_t allocate(uint32_t vertex_count, uint32_t index_count)
+        {
+            auto first_vertex = vertices_.allocate(vertex_count);
+            if (detail::range_allocator_t::invalid_offset == first_vertex)
+                throw std::runtime_error{ "The geometry pool is out of vertex space!" };
+
+            auto first_index = indices_.allocate(index_count);
+            if (detail::range_allocator_t::invalid_offset == first_index)
+            {
+                vertices_.free(first_vertex, vertex_count);
+                throw std::runtime_error{ "The geometry pool is out of index space!" };
+            }
+
+            return { first_vertex, vertex_count, first_index, index_count };
+        }
+
+        /// the range must not be referenced by a command buffer still in flight
+        void free(geometry_range_t const& range)
+        {
+            vertices_.free(range.first_vertex, range.vertex_count);
+            indices_.free(range.first_index, range.index_count);
+        }
+
+        /// copy regions from a staging buffer holding the vertices, then the indices, at the given offsets
+        VkBufferCopy get_vertex_copy(geometry_range_t const& range, VkDeviceSize src_offset = 0) const noexcept
+        {
+            return { src_offset, static_cast<VkDeviceSize>(range.first_vertex) * config_.vertex_stride,
+                static_cast<VkDeviceSize>(range.vertex_count) * config_.vertex_stride };
+        }
+
+        VkBufferCopy get_index_copy(geometry_range_t const& range, VkDeviceSize src_offset = 0) const noexcept
+        {
+            return { src_offset, static_cast<VkDeviceSize>(range.first_index) * get_index_size(),
+                static_cast<VkDeviceSize>(range.index_count) * get_index_size() };
+        }
+
+        /// indices stay relative to their mesh, the draw's vertex offset selects the mesh's vertices
+        /// an indirect draw with a first_instance other than 0 needs the drawIndirectFirstInstance feature
+        VkDrawIndexedIndirectCommand make_draw(geometry_range_t const& range, uint32_t instance_count = 1, uint32_t first_instance = 0) const noexcept
+        {
+            return { range.index_count, instance_count, range.first_index, static_cast<int32_t>(range.first_vertex), first_instance };
+        }
+
+        /// binds the pool's vertex buffer at binding 0 and its index buffer
+        void bind(command_recorder<Device>& recorder) const
+        {
+            recorder.bind_vertex_buffer(0, vertex_buffer_.buffer, 0);
+            recorder.bind_index_buffer(index_buffer_.buffer, 0, config_.index_type);
+        }
+
+        VkBuffer get_vertex_buffer() const noexcept
+        {
+            return vertex_buffer_.buffer;
+        }
+
+        VkBuffer get_index_buffer() const noexcept
+        {
+            return index_buffer_.buffer;
+        }
+
+        VkIndexType get_index_type() const noexcept
+        {
+            return config_.index_type;
+        }
+
+        uint32_t get_vertex_stride() const noexcept
+        {
+            return config_.vertex_stride;
+        }
+
+        uint32_t get_index_size() const noexcept
+        {
+            return VK_INDEX_TYPE_UINT16 == config_.index_type ? 2 : 4;
+        }
+
+        uint32_t get_used_vertices() const noexcept
+        {
+            return vertices_.get_used();
+        }
+
+        uint32_t get_used_indices() const noexcept
+        {
+            return indices_.get_used();
+        }
+
+    private:
+        Device const*                   device_;
+        geometry_pool_config_t          config_;
+        detail::range_allocator_t       vertices_;
+        detail::range_allocator_t       indices_;
+        detail::device_buffer_t         vertex_buffer_;
+        detail::device_buffer_t         index_buffer_;
+    };
+
+    /// gathers the draws of geometry pool meshes as VkDrawIndexedIndirectCommand arrays
+    /// the commands are written into an indirect buffer by the caller and issued with a few
+    /// draw_indexed_indirect calls instead of a bind and a draw per mesh. a first_instance other
+    /// than 0 needs the drawIndirectFirstInstance feature.
+    class indirect_draw_builder_t
+    {
+    public:
+        void add(VkDrawIndexedIndirectCommand const& command)
+        {
+            commands_.push_back(command);
+        }
+
+        template <typename Device>
+        void add(geometry_pool<Device> const& pool, geometry_range_t const& range, uint32_t instance_count = 1, uint32_t first_instance = 0)
+        {
+            add(pool.make_draw(range, instance_count, first_instance));
+        }
+
+        /// the destination, typically mapped memory of the indirect buffer, has to hold get_size_bytes()
+        void write(void* destination) const noexcept
+        {
+            if (!commands_.empty())
+                std::memcpy(destination, commands_.data(), get_size_bytes());
+        }
+
+        /// issue the commands written to buffer at offset in as few indirect calls as the device allows
+        /// that is one call with multiDrawIndirect enabled through create_logical_device, one per command otherwise
+        template <typename Device>
+        void record(Device const& device, command_recorder<Device>& recorder, VkBuffer buffer, VkDeviceSize offset = 0) const
+        {
+            record(recorder, buffer, offset, device.get_max_draw_indirect_count());
+        }
+
+        /// max_draw_count is 1 without the multiDrawIndirect feature and at most maxDrawIndirectCount otherwise
+        template <typename Device>
+        void record(command_recorder<Device>& recorder, VkBuffer buffer, VkDeviceSize offset, uint32_t max_draw_count) const
+        {
+            assert(0 != max_draw_count);
+            constexpr auto stride = static_cast<uint32_t>(sizeof(VkDrawIndexedIndirectCommand));
+            auto remaining = static_cast<uint32_t>(commands_.size());
+            while (0 != remaining)
+            {
+                auto const draw_count = std::min(remaining, max_draw_count);
+                recorder.draw_indexed_indirect(buffer, offset, draw_count, stride);
+                offset += static_cast<VkDeviceSize>(draw_count) * stride;
+                remaining -= draw_count;
+            }
+        }
+
+        void clear() noexcept
+        {
+            commands_.clear();
+        }
+
+        VkDrawIndexedIndirectCommand const* data() const noexcept
+        {
+            return commands_.data();
+        }
+
+        size_t size() const noexcept
+        {
+            return commands_.size();
+        }
+
+        VkDeviceSize get_size_bytes() const noexcept
+        {
+            return static_cast<VkDeviceSize>(commands_.size()) * sizeof(VkDrawIndexedIndirectCommand);
+        }
+
+    private:
+        std::vector<VkDrawIndexedIndirectCommand>       commands_;
+    };
+}
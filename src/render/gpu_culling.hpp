@@ -0,0 +1,365 @@
+#pragma once
+
+namespace vk
+{
+    /// the tests of the culling shader, an instance survives when it passes every enabled one
+    inline constexpr uint32_t cull_frustum = 1;
+    inline constexpr uint32_t cull_occlusion = 2;
+
+    /// the culling compute shader, compile it to SPIR-V with e.g. glslc -fshader-stage=compute
+    /// instance i is a world space bounding sphere in bounds[i] and a draw command in draws[i], the
+    /// hierarchical depth buffer keeps the farthest depth of every texel with 0 at the near plane.
+    inline constexpr char const gpu_culling_shader_source[] = R"(#version 450
+layout(local_size_x = 64) in;
+
+struct draw_command_t
+{
+    uint index_count;
+    uint instance_count;
+    uint first_index;
+    int vertex_offset;
+    uint first_instance;
+};
+
+layout(std430, set = 0, binding = 0) readonly buffer bounds_buffer { vec4 bounds[]; };
+layout(std430, set = 0, binding = 1) readonly buffer draw_buffer { draw_command_t draws[]; };
+layout(std430, set = 0, binding = 2) writeonly buffer visible_buffer { draw_command_t visible_draws[]; };
+layout(std430, set = 0, binding = 3) buffer count_buffer { uint visible_count; };
+layout(set = 0, binding = 4) uniform sampler2D hiz;
+
+layout(push_constant) uniform constants_t
+{
+    mat4 view_projection;
+    uint instance_count;
+    uint flags;
+};
+
+const uint cull_frustum = 1;
+const uint cull_occlusion = 2;
+
+bool is_in_frustum(vec4 sphere)
+{
+    // the planes of the clip volume -w <= x, y <= w and 0 <= z <= w
+    mat4 rows = transpose(view_projection);
+    vec4 planes[6] = vec4[6](rows[3] + rows[0], rows[3] - rows[0], rows[3] + rows[1], rows[3] - rows[1], rows[2], rows[3] - rows[2]);
+    for (int i = 0; i < 6; ++i)
+    {
+        if (dot(planes[i].xyz, sphere.xyz) + planes[i].w < -sphere.w * length(planes[i].xyz))
+            return false;
+    }
+    return true;
+}
+
+bool is_occluded(vec4 sphere)
+{
+    vec2 min_uv = vec2(1.0);
+    vec2 max_uv = vec2(0.0);
+    float nearest = 1.0;
+    for (int i = 0; i < 8; ++i)
+    {
+        vec3 corner = sphere.xyz + sphere.w * vec3((i & 1) != 0 ? 1.0 : -1.0, (i & 2) != 0 ? 1.0 : -1.0, (i & 4) != 0 ? 1.0 : -1.0);
+        vec4 clip = view_projection * vec4(corner, 1.0);
+        if (clip.w <= 0.0)
+            return false;
+
+        vec3 ndc = clip.xyz / clip.w;
+        min_uv = min(min_uv, ndc.xy * 0.5 + 0.5);
+        max_uv = max(max_uv, ndc.xy * 0.5 + 0.5);
+        nearest = min(nearest, ndc.z);
+    }
+    min_uv = clamp(min_uv, 0.0, 1.0);
+    max_uv = clamp(max_uv, 0.0, 1.0);
+
+    // the level where the bounds cover at most 2x2 texels
+    vec2 extent = (max_uv - min_uv) * vec2(textureSize(hiz, 0));
+    int level = min(int(ceil(log2(max(max(extent.x, extent.y), 1.0)))), textureQueryLevels(hiz) - 1);
+    ivec2 size = textureSize(hiz, level);
+    ivec2 lo = clamp(ivec2(min_uv * vec2(size)), ivec2(0), size - 1);
+    ivec2 hi = clamp(ivec2(max_uv * vec2(size)), ivec2(0), size - 1);
+    float farthest = max(max(texelFetch(hiz, lo, level).r, texelFetch(hiz, ivec2(hi.x, lo.y), level).r),
+        max(texelFetch(hiz, ivec2(lo.x, hi.y), level).r, texelFetch(hiz, hi, level).r));
+    return nearest > farthest;
+}
+
+void main()
+{
+    uint id = gl_GlobalInvocationID.x;
+    if (id >= instance_count)
+        return;
+
+    vec4 sphere = bounds[id];
+    if ((flags & cull_frustum) != 0 && !is_in_frustum(sphere))
+        return;
+    if ((flags & cull_occlusion) != 0 && is_occluded(sphere))
+        return;
+
+    visible_draws[atomicAdd(visible_count, 1)] = draws[id];
+}
+)";
+
+    /// push constants of the culling shader: view_projection, instance_count, flags
+    using gpu_culling_constants_t = std430_block<glsl::mat4, uint32_t, uint32_t>;
+
+    struct gpu_culling_config_t
+    {
+        uint32_t                max_instances = 256 * 1024;
+        VkMemoryPropertyFlags   memory_properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    };
+
+    namespace detail
+    {
+        template <typename T, typename = void>
+        struct has_draw_indirect_count : std::false_type {};
+        template <typename T>
+        struct has_draw_indirect_count<T, std::void_t<decltype(std::declval<T const&>().draw_indexed_indirect_count(
+            std::declval<command_recorder<T>&>(), std::declval<VkBuffer>(), 0, std::declval<VkBuffer>(), 0, 0u))>> : std::true_type {};
+        template <typename T>
+        inline constexpr bool has_draw_indirect_count_v = has_draw_indirect_count<T>::value;
+    }
+
+    /// GPU driven frustum and occlusion culling
+    /// a compute pass tests the bounds of every instance and appends the draw commands of the
+    /// survivors to an indirect buffer, counting them in a second one. the draws are issued with
+    /// the count read on the GPU when the device has khr::draw_indirect_count_ext, otherwise the
+    /// indirect buffer is cleared first and every slot is drawn, the culled ones with no instances.
+    template <typename Device>
+    class gpu_culling
+    {
+        inline static constexpr uint32_t group_size = 64;
+        inline static constexpr VkDeviceSize command_size = sizeof(VkDrawIndexedIndirectCommand);
+
+    public:
+        /// spirv is gpu_culling_shader_source compiled, or a shader with the same interface
+        gpu_culling(Device const& device, span<uint32_t const> spirv, gpu_culling_config_t const& config = {})
+            : device_(&device)
+            , config_(config)
+        {
+            set_layout_ = device.create_descriptor_set_layout({
+                { 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr },
+                { 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr },
+                { 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr },
+                { 3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr },
+                { 4, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr },
+            });
+            layout_ = device.create_pipeline_layout({ set_layout_ }, { { VK_SHADER_STAGE_COMPUTE_BIT, 0, gpu_culling_constants_t::size } });
+
+            try
+            {
+                auto module = device.create_shader_module_handle(spirv);
+                try
+                {
+                    pipeline_ = device.create_compute_pipeline_handle(module, layout_);
+                }
+                catch (...)
+                {
+                    device.destroy_shader_module(module);
+                    throw;
+                }
+                device.destroy_shader_module(module);
+
+                draw_buffer_ = detail::create_device_buffer(device, command_size * config.max_instances,
+                    VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                    config.memory_properties);
+                count_buffer_ = detail::create_device_buffer(device, sizeof(uint32_t),
+                    VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT |
+                    VK_BUFFER_USAGE_TRANSFER_SRC_BIT, config.memory_properties);
+
+                VkDescriptorPoolSize const pool_sizes[] =
+                {
+                    { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 4 },
+                    { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1 },
+                };
+                descriptor_pool_ = device.create_descriptor_pool_handle(1, pool_sizes);
+                if (VK_SUCCESS != device.allocate_descriptor_sets(descriptor_pool_, 1, &set_layout_, &set_))
+                    throw std::runtime_error{ "Failed to call vkAllocateDescriptorSets!" };
+
+                VkSamplerCreateInfo sampler_info = {};
+                sampler_info.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+                sampler_info.magFilter = VK_FILTER_NEAREST;
+                sampler_info.minFilter = VK_FILTER_NEAREST;
+                sampler_info.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+                sampler_info.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+                sampler_info.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+                sampler_info.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+                sampler_info.maxLod = VK_LOD_CLAMP_NONE;
+                sampler_ = device.create_sampler(sampler_info);
+            }
+            catch (...)
+            {
+                destroy();
+                throw;
+            }
+        }
+
+        ~gpu_culling()
+        {
+            destroy();
+        }
+
+        gpu_culling(gpu_culling const&) = delete;
+        gpu_culling& operator=(gpu_culling const&) = delete;
+
+        /// bounds holds a vec4 sphere and draws a VkDrawIndexedIndirectCommand per instance, the hierarchical
+        /// depth buffer is read in hiz_layout. update while no culling pass using them is in flight.
+        /// the commands are copied as they are, a first_instance other than 0 needs drawIndirectFirstInstance.
+        void set_inputs(VkBuffer bounds, VkBuffer draws, VkImageView hiz, VkImageLayout hiz_layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
+        {
+            VkDescriptorBufferInfo const buffer_infos[] =
+            {
+                { bounds, 0, VK_WHOLE_SIZE },
+                { draws, 0, VK_WHOLE_SIZE },
+                { draw_buffer_.buffer, 0, VK_WHOLE_SIZE },
+                { count_buffer_.buffer, 0, VK_WHOLE_SIZE },
+            };
+            VkDescriptorImageInfo const image_info = { sampler_.get(), hiz, hiz_layout };
+
+            std::array<VkWriteDescriptorSet, 5> writes = {};
+            for (uint32_t i = 0; i < writes.size(); ++i)
+            {
+                writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                writes[i].dstSet = set_;
+                writes[i].dstBinding = i;
+                writes[i].descriptorCount = 1;
+                if (i < 4)
+                {
+                    writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                    writes[i].pBufferInfo = &buffer_infos[i];
+                }
+                else
+                {
+                    writes[i].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+                    writes[i].pImageInfo = &image_info;
+                }
+            }
+            device_->update_descriptor_sets(static_cast<uint32_t>(writes.size()), writes.data());
+            inputs_valid_ = true;
+        }
+
+        /// record the culling pass outside of a render pass, the inputs have to be visible to compute shader reads
+        void cull(command_recorder<Device>& recorder, glsl::mat4 const& view_projection, uint32_t instance_count,
+            uint32_t flags = cull_frustum | cull_occlusion)
+        {
+            assert(inputs_valid_ && instance_count <= config_.max_instances);
+            instance_count_ = instance_count;
+
+            // the previous frame's draws are done with the outputs before they are cleared
+            VkBufferMemoryBarrier clear_barriers[] =
+            {
+                make_barrier(count_buffer_.buffer, VK_ACCESS_INDIRECT_COMMAND_READ_BIT, VK_ACCESS_TRANSFER_WRITE_BIT),
+                make_barrier(draw_buffer_.buffer, VK_ACCESS_INDIRECT_COMMAND_READ_BIT, VK_ACCESS_TRANSFER_WRITE_BIT),
+            };
+            barrier(recorder, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, clear_barriers);
+
+            recorder.fill_buffer(count_buffer_.buffer, 0, sizeof(uint32_t), 0);
+            if constexpr (!detail::has_draw_indirect_count_v<Device>)
+            {
+                if (0 != instance_count)
+                    recorder.fill_buffer(draw_buffer_.buffer, 0, command_size * instance_count, 0);
+            }
+
+            VkBufferMemoryBarrier cull_barriers[] =
+            {
+                make_barrier(count_buffer_.buffer, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT),
+                make_barrier(draw_buffer_.buffer, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_WRITE_BIT),
+            };
+            barrier(recorder, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, cull_barriers);
+
+            recorder.bind_pipeline(VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_);
+            recorder.bind_descriptor_set(VK_PIPELINE_BIND_POINT_COMPUTE, layout_, 0, set_);
+            recorder.template push_block<gpu_culling_constants_t>(layout_, VK_SHADER_STAGE_COMPUTE_BIT, 0,
+                view_projection, instance_count, flags);
+            recorder.dispatch((instance_count + group_size - 1) / group_size);
+
+            VkBufferMemoryBarrier draw_barriers[] =
+            {
+                make_barrier(count_buffer_.buffer, VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT),
+                make_barrier(draw_buffer_.buffer, VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT),
+            };
+            barrier(recorder, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, draw_barriers);
+        }
+
+        /// draw the survivors of the last cull(), with the geometry and pipeline bound by the caller
+        /// max_draw_count bounds the indirect calls of the fallback path, 0 takes get_max_draw_indirect_count()
+        /// of the device: one call with multiDrawIndirect enabled, one per instance otherwise
+        void draw(command_recorder<Device>& recorder, uint32_t max_draw_count = 0) const
+        {
+            if constexpr (detail::has_draw_indirect_count_v<Device>)
+            {
+                recorder.draw_indexed_indirect_count(draw_buffer_.buffer, 0, count_buffer_.buffer, 0, instance_count_);
+            }
+            else
+            {
+                if (0 == max_draw_count)
+                    max_draw_count = device_->get_max_draw_indirect_count();
+                VkDeviceSize offset = 0;
+                for (auto remaining = instance_count_; 0 != remaining;)
+                {
+                    auto const draw_count = std::min(remaining, max_draw_count);
+                    recorder.draw_indexed_indirect(draw_buffer_.buffer, offset, draw_count);
+                    offset += command_size * draw_count;
+                    remaining -= draw_count;
+                }
+            }
+        }
+
+        /// the compacted draw commands and their count, e.g. to copy the count out for statistics
+        VkBuffer get_draw_buffer() const noexcept
+        {
+            return draw_buffer_.buffer;
+        }
+
+        VkBuffer get_count_buffer() const noexcept
+        {
+            return count_buffer_.buffer;
+        }
+
+    private:
+        static VkBufferMemoryBarrier make_barrier(VkBuffer buffer, VkAccessFlags src_access, VkAccessFlags dst_access) noexcept
+        {
+            return
+            {
+                VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,        // VkStructureType          sType
+                nullptr,                                        // const void*              pNext
+                src_access,                                     // VkAccessFlags            srcAccessMask
+                dst_access,                                     // VkAccessFlags            dstAccessMask
+                VK_QUEUE_FAMILY_IGNORED,                        // uint32_t                 srcQueueFamilyIndex
+                VK_QUEUE_FAMILY_IGNORED,                        // uint32_t                 dstQueueFamilyIndex
+                buffer,                                         // VkBuffer                 buffer
+                0,                                              // VkDeviceSize             offset
+                VK_WHOLE_SIZE                                   // VkDeviceSize             size
+            };
+        }
+
+        /// the buffers are owned here, so their barriers bypass the state tracker
+        template <size_t N>
+        static void barrier(command_recorder<Device>& recorder, VkPipelineStageFlags src_stages, VkPipelineStageFlags dst_stages,
+            VkBufferMemoryBarrier const (&barriers)[N])
+        {
+            recorder.pipeline_barrier(src_stages, dst_stages, 0, nullptr, static_cast<uint32_t>(N), barriers, 0, nullptr);
+        }
+
+        void destroy()
+        {
+            // the layouts belong to the device's layout cache
+            device_->destroy_descriptor_pool(std::exchange(descriptor_pool_, nullptr));
+            device_->destroy_pipeline(std::exchange(pipeline_, nullptr));
+            detail::destroy_device_buffer(*device_, draw_buffer_);
+            detail::destroy_device_buffer(*device_, count_buffer_);
+            sampler_ = {};
+        }
+
+    private:
+        Device const*                   device_;
+        gpu_culling_config_t            config_;
+        VkDescriptorSetLayout           set_layout_ = nullptr;
+        VkPipelineLayout                layout_ = nullptr;
+        VkPipeline                      pipeline_ = nullptr;
+        VkDescriptorPool                descriptor_pool_ = nullptr;
+        VkDescriptorSet                 set_ = nullptr;
+        shared_sampler_t                sampler_;
+        detail::device_buffer_t         draw_buffer_;
+        detail::device_buffer_t         count_buffer_;
+        uint32_t                        instance_count_ = 0;
+        bool                            inputs_valid_ = false;
+    };
+}
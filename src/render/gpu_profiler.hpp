@@ -0,0 +1,250 @@
+#pragma once
+
+namespace vk
+{
+    /// one named scope in the profile tree, parents come before their children
+    struct gpu_profile_node_t
+    {
+        std::string             name;
+        uint32_t                parent = invalid_index;
+        uint32_t                depth = 0;
+        double                  last_ms = 0.0;              // summed over the scope's uses in the latest resolved frame
+        double                  average_ms = 0.0;           // over the rolling window
+        uint64_t                samples = 0;
+    };
+
+    /// scoped GPU timestamps over a ring of per-frame query pools
+    /// every scope writes a timestamp at its begin and end. a frame's queries are read back without
+    /// waiting while its slot is older than the current frame, a frame which is still not resolved
+    /// when its slot comes around again is dropped instead of stalling.
+    template <typename Device>
+    class gpu_profiler
+    {
+        inline static constexpr size_t window_size = 64;
+
+        struct scope_record_t
+        {
+            uint32_t                    node;
+            uint32_t                    query;
+        };
+
+        struct frame_slot_t
+        {
+            VkQueryPool                 pool = nullptr;
+            std::vector<scope_record_t> records;
+            uint32_t                    query_count = 0;
+            bool                        pending = false;
+        };
+
+        struct node_state_t
+        {
+            std::array<double, window_size> window = {};
+            std::vector<uint32_t>       children;
+            double                      sum = 0.0;
+            double                      frame_ms = 0.0;
+            bool                        seen = false;
+        };
+
+    public:
+        /// writes the begin timestamp on construction and the end timestamp on destruction
+        class scope_t
+        {
+        public:
+            scope_t(gpu_profiler& profiler, VkCommandBuffer command_buffer, std::string_view name)
+                : profiler_(&profiler)
+                , command_buffer_(command_buffer)
+            {
+                profiler_->begin_scope(command_buffer_, name);
+            }
+
+            ~scope_t()
+            {
+                profiler_->end_scope(command_buffer_);
+            }
+
+            scope_t(scope_t const&) = delete;
+            scope_t& operator=(scope_t const&) = delete;
+
+        private:
+            gpu_profiler*               profiler_;
+            VkCommandBuffer             command_buffer_;
+        };
+
+        /// frame_latency is the number of frames the results trail the recording, normally the frames in flight
+        gpu_profiler(Device const& device, uint32_t frame_latency, uint32_t max_scopes = 256, uint32_t timestamp_valid_bits = 64)
+            : device_(&device)
+            , max_queries_(max_scopes * 2)
+            , timestamp_mask_(timestamp_valid_bits >= 64 ? ~0ull : (1ull << timestamp_valid_bits) - 1)
+            , timestamp_period_(device.get_physical_device_properties().limits.timestampPeriod)
+            , slots_(frame_latency + 1)
+        {
+            if (0 == timestamp_valid_bits)
+                throw std::runtime_error{ "The queue does not support timestamps!" };
+
+            for (auto& slot : slots_)
+            {
+                slot.pool = device.create_query_pool_handle(VK_QUERY_TYPE_TIMESTAMP, max_queries_);
+                slot.records.reserve(max_scopes);
+            }
+            results_.resize(max_queries_);
+        }
+
+        ~gpu_profiler()
+        {
+            for (auto const& slot : slots_)
+                device_->destroy_query_pool(slot.pool);
+        }
+
+        gpu_profiler(gpu_profiler const&) = delete;
+        gpu_profiler& operator=(gpu_profiler const&) = delete;
+
+        /// resolve the finished frames and reset the current slot, outside of a render pass
+        void begin_frame(VkCommandBuffer command_buffer)
+        {
+            // the current slot holds the oldest frame
+            for (uint32_t i = 0; i < slots_.size(); ++i)
+                resolve(slots_[(frame_index_ + i) % slots_.size()]);
+
+            auto& slot = slots_[frame_index_];
+            if (slot.pending)
+            {
+                slot.pending = false;
+                ++dropped_frames_;
+            }
+
+            slot.records.clear();
+            slot.query_count = 0;
+            device_->get_command_table().vkCmdResetQueryPool(command_buffer, slot.pool, 0, max_queries_);
+            stack_.clear();
+        }
+
+        void end_frame()
+        {
+            assert(stack_.empty());
+            slots_[frame_index_].pending = !slots_[frame_index_].records.empty();
+            frame_index_ = (frame_index_ + 1) % static_cast<uint32_t>(slots_.size());
+        }
+
+        scope_t scope(VkCommandBuffer command_buffer, std::string_view name)
+        {
+            return { *this, command_buffer, name };
+        }
+
+        void begin_scope(VkCommandBuffer command_buffer, std::string_view name)
+        {
+            auto& slot = slots_[frame_index_];
+            auto node = get_node(stack_.empty() ? invalid_index : stack_.back().node, name);
+
+            // out of queries, the scope still nests but is not timed
+            auto query = invalid_index;
+            if (slot.query_count + 2 <= max_queries_)
+            {
+                query = slot.query_count;
+                slot.query_count += 2;
+                device_->get_command_table().vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, slot.pool, query);
+            }
+            stack_.push_back({ node, query });
+        }
+
+        void end_scope(VkCommandBuffer command_buffer)
+        {
+            assert(!stack_.empty());
+            auto record = stack_.back();
+            stack_.pop_back();
+
+            if (invalid_index == record.query)
+                return;
+
+            auto& slot = slots_[frame_index_];
+            device_->get_command_table().vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, slot.pool, record.query + 1);
+            slot.records.push_back(record);
+        }
+
+        std::vector<gpu_profile_node_t> const& get_nodes() const noexcept
+        {
+            return nodes_;
+        }
+
+        /// frames whose queries were not available before their slot was reused
+        uint64_t get_dropped_frames() const noexcept
+        {
+            return dropped_frames_;
+        }
+
+        uint64_t get_resolved_frames() const noexcept
+        {
+            return resolved_frames_;
+        }
+
+    private:
+        // a scope has few children, a linear scan beats hashing the name on every scope
+        uint32_t get_node(uint32_t parent, std::string_view name)
+        {
+            auto& siblings = invalid_index == parent ? roots_ : node_states_[parent].children;
+            for (auto id : siblings)
+            {
+                if (nodes_[id].name == name)
+                    return id;
+            }
+
+            auto id = static_cast<uint32_t>(nodes_.size());
+            gpu_profile_node_t node;
+            node.name = std::string{ name };
+            node.parent = parent;
+            node.depth = invalid_index == parent ? 0 : nodes_[parent].depth + 1;
+            nodes_.push_back(std::move(node));
+            siblings.push_back(id);
+            node_states_.emplace_back();
+            return id;
+        }
+
+        void resolve(frame_slot_t& slot)
+        {
+            if (!slot.pending || !device_->get_query_pool_results(slot.pool, 0, slot.query_count, results_.data()))
+                return;
+
+            slot.pending = false;
+            for (auto const& record : slot.records)
+            {
+                auto const ticks = (results_[record.query + 1] - results_[record.query]) & timestamp_mask_;
+                auto& state = node_states_[record.node];
+                state.frame_ms += static_cast<double>(ticks) * timestamp_period_ * 1e-6;
+                state.seen = true;
+            }
+
+            for (size_t i = 0; i < nodes_.size(); ++i)
+            {
+                auto& state = node_states_[i];
+                if (!state.seen)
+                    continue;
+
+                auto& node = nodes_[i];
+                auto& oldest = state.window[node.samples % window_size];
+                state.sum += state.frame_ms - oldest;
+                oldest = state.frame_ms;
+                ++node.samples;
+
+                node.last_ms = state.frame_ms;
+                node.average_ms = state.sum / static_cast<double>(std::min<uint64_t>(node.samples, window_size));
+                state.frame_ms = 0.0;
+                state.seen = false;
+            }
+            ++resolved_frames_;
+        }
+
+    private:
+        Device const*                                       device_;
+        uint32_t                                            max_queries_;
+        uint64_t                                            timestamp_mask_;
+        double                                              timestamp_period_;
+        std::vector<frame_slot_t>                           slots_;
+        std::vector<uint64_t>                               results_;
+        std::vector<scope_record_t>                         stack_;
+        std::vector<gpu_profile_node_t>                     nodes_;
+        std::vector<node_state_t>                           node_states_;
+        std::vector<uint32_t>                               roots_;
+        uint32_t                                            frame_index_ = 0;
+        uint64_t                                            dropped_frames_ = 0;
+        uint64_t                                            resolved_frames_ = 0;
+    };
+}
@@ -0,0 +1,439 @@
+#pragma once
+
+namespace vk
+{
+    struct offscreen_config_t
+    {
+        extent_2d_t             extent = { 1280, 720 };
+        VkFormat                format = VK_FORMAT_B8G8R8A8_UNORM;
+        uint32_t                image_count = 3;
+        uint32_t                frames_in_flight = 2;
+        VkImageUsageFlags       usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+        access_t                present_access = access_t::color_attachment_write;  // how a frame leaves its image
+    };
+
+    struct captured_frame_t
+    {
+        uint64_t                frame_number;
+        extent_2d_t             extent;
+        VkFormat                format;
+        uint8_t const*          data;
+        size_t                  row_pitch;
+        size_t                  size;
+    };
+
+    namespace detail
+    {
+        inline uint32_t get_color_format_size(VkFormat format) noexcept
+        {
+            switch (format)
+            {
+            case VK_FORMAT_R8G8B8A8_UNORM:
+            case VK_FORMAT_R8G8B8A8_SRGB:
+            case VK_FORMAT_B8G8R8A8_UNORM:
+            case VK_FORMAT_B8G8R8A8_SRGB:
+            case VK_FORMAT_A2B10G10R10_UNORM_PACK32:
+            case VK_FORMAT_R32_SFLOAT:
+                return 4;
+            case VK_FORMAT_R16G16B16A16_SFLOAT:
+                return 8;
+            case VK_FORMAT_R32G32B32A32_SFLOAT:
+                return 16;
+            default:
+                return 0;
+            }
+        }
+    }
+
+    /// display-less stand-in for the swapchain presenter
+    /// frames render into a ring of device local images through the same begin_frame()/end_frame()
+    /// calls. captured frames are copied into host visible memory and handed to the capture callback
+    /// once their fence has signaled, without stalling the frame loop.
+    template <typename Device>
+    class offscreen_presenter
+    {
+        struct target_t
+        {
+            VkImage                     image = nullptr;
+            VkDeviceMemory              memory = nullptr;
+            object<VkImageView>         view;
+        };
+
+        struct frame_slot_t
+        {
+            VkCommandPool               command_pool = nullptr;
+            VkCommandBuffer             command_buffer = nullptr;
+            VkFence                     fence = nullptr;
+            VkBuffer                    readback_buffer = nullptr;
+            VkDeviceMemory              readback_memory = nullptr;
+            void*                       readback_data = nullptr;
+            uint32_t                    image_index = 0;
+            uint64_t                    frame_number = 0;
+            bool                        capture_pending = false;
+        };
+
+    public:
+        offscreen_presenter(Device const& device, uint32_t queue_family_index, offscreen_config_t const& config = {})
+            : device_(&device)
+            , config_(config)
+            , queue_(device.get_device_queue(queue_family_index))
+            , slots_(config.frames_in_flight)
+        {
+            assert(config.frames_in_flight > 0 && config.image_count > 0);
+            for (auto& slot : slots_)
+            {
+                slot.command_pool = device.create_command_pool_handle(queue_family_index, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
+                slot.command_buffer = device.allocate_command_buffer(slot.command_pool);
+                slot.fence = device.create_fence_handle(true);
+            }
+
+            create_targets();
+        }
+
+        ~offscreen_presenter()
+        {
+            device_->wait_idle();
+            destroy_targets();
+            for (auto const& slot : slots_)
+            {
+                device_->destroy_fence(slot.fence);
+                device_->destroy_command_pool(slot.command_pool);
+            }
+        }
+
+        offscreen_presenter(offscreen_presenter const&) = delete;
+        offscreen_presenter& operator=(offscreen_presenter const&) = delete;
+
+        bool begin_frame(present_frame_t& frame)
+        {
+            auto& slot = slots_[frame_index_];
+            device_->wait_for_fence(slot.fence);
+            deliver_capture(slot);
+
+            if (resize_pending_)
+                recreate();
+
+            slot.image_index = static_cast<uint32_t>(frame_number_ % targets_.size());
+            slot.frame_number = frame_number_;
+            device_->reset_command_pool(slot.command_pool);
+            device_->begin_command_buffer(slot.command_buffer);
+
+            auto const& target = targets_[slot.image_index];
+            frame.frame_index = frame_index_;
+            frame.image_index = slot.image_index;
+            frame.command_buffer = slot.command_buffer;
+            frame.image = target.image;
+            frame.image_view = target.view;
+            frame.extent = config_.extent;
+            return true;
+        }
+
+        /// the stage parameter mirrors the swapchain presenter, there is no acquire to wait for
+        void end_frame(VkPipelineStageFlags = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT)
+        {
+            auto& slot = slots_[frame_index_];
+            slot.capture_pending = capture_all_ || capture_next_;
+            capture_next_ = false;
+            if (slot.capture_pending)
+                record_readback(slot);
+
+            device_->end_command_buffer(slot.command_buffer);
+
+            VkSubmitInfo submit_info =
+            {
+                VK_STRUCTURE_TYPE_SUBMIT_INFO,                  // VkStructureType              sType
+                nullptr,                                        // const void*                  pNext
+                0,                                              // uint32_t                     waitSemaphoreCount
+                nullptr,                                        // const VkSemaphore*           pWaitSemaphores
+                nullptr,                                        // const VkPipelineStageFlags*  pWaitDstStageMask
+                1,                                              // uint32_t                     commandBufferCount
+                &slot.command_buffer,                           // const VkCommandBuffer*       pCommandBuffers
+                0,                                              // uint32_t                     signalSemaphoreCount
+                nullptr                                         // const VkSemaphore*           pSignalSemaphores
+            };
+
+            device_->reset_fence(slot.fence);
+            device_->queue_submit(queue_, 1, &submit_info, slot.fence);
+
+            ++frame_number_;
+            frame_index_ = (frame_index_ + 1) % static_cast<uint32_t>(slots_.size());
+        }
+
+        void capture_next_frame() noexcept
+        {
+            capture_next_ = true;
+        }
+
+        void set_capture_every_frame(bool enable) noexcept
+        {
+            capture_all_ = enable;
+        }
+
+        /// called from begin_frame() or flush() with memory valid for the duration of the call
+        void set_capture_callback(std::function<void(captured_frame_t const&)> callback)
+        {
+            capture_callback_ = std::move(callback);
+        }
+
+        /// wait for every submitted frame and deliver the outstanding captures
+        void flush()
+        {
+            for (auto& slot : slots_)
+            {
+                device_->wait_for_fence(slot.fence);
+                deliver_capture(slot);
+            }
+        }
+
+        void resize(extent_2d_t extent) noexcept
+        {
+            config_.extent = extent;
+            resize_pending_ = true;
+        }
+
+        VkFence get_last_submit_fence() const noexcept
+        {
+            auto const count = static_cast<uint32_t>(slots_.size());
+            return slots_[(frame_index_ + count - 1) % count].fence;
+        }
+
+        uint32_t get_frames_in_flight() const noexcept
+        {
+            return static_cast<uint32_t>(slots_.size());
+        }
+
+        offscreen_config_t const& get_config() const noexcept
+        {
+            return config_;
+        }
+
+        uint64_t get_generation() const noexcept
+        {
+            return generation_;
+        }
+
+        VkQueue get_queue() const noexcept
+        {
+            return queue_;
+        }
+
+    private:
+        size_t get_readback_size() const noexcept
+        {
+            return static_cast<size_t>(config_.extent.width) * config_.extent.height * detail::get_color_format_size(config_.format);
+        }
+
+        void create_targets()
+        {
+            targets_.resize(config_.image_count);
+            for (auto& target : targets_)
+            {
+                VkImageCreateInfo create_info =
+                {
+                    VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,                // VkStructureType          sType
+                    nullptr,                                            // const void*              pNext
+                    0,                                                  // VkImageCreateFlags       flags
+                    VK_IMAGE_TYPE_2D,                                   // VkImageType              imageType
+                    config_.format,                                     // VkFormat                 format
+                    { config_.extent.width, config_.extent.height, 1 }, // VkExtent3D               extent
+                    1,                                                  // uint32_t                 mipLevels
+                    1,                                                  // uint32_t                 arrayLayers
+                    VK_SAMPLE_COUNT_1_BIT,                              // VkSampleCountFlagBits    samples
+                    VK_IMAGE_TILING_OPTIMAL,                            // VkImageTiling            tiling
+                    config_.usage | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,    // VkImageUsageFlags        usage
+                    VK_SHARING_MODE_EXCLUSIVE,                          // VkSharingMode            sharingMode
+                    0,                                                  // uint32_t                 queueFamilyIndexCount
+                    nullptr,                                            // const uint32_t*          pQueueFamilyIndices
+                    VK_IMAGE_LAYOUT_UNDEFINED                           // VkImageLayout            initialLayout
+                };
+                target.image = device_->create_image_handle(create_info);
+
+                auto requirements = device_->get_image_memory_requirements(target.image);
+                auto type_index = device_->find_memory_type(requirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+                if (invalid_index == type_index)
+                    type_index = device_->find_memory_type(requirements.memoryTypeBits, 0);
+                target.memory = device_->allocate_memory_handle(requirements.size, type_index);
+                device_->bind_image_memory(target.image, target.memory);
+
+                VkImageViewCreateInfo view_create_info =
+                {
+                    VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,           // VkStructureType          sType
+                    nullptr,                                            // const void*              pNext
+                    0,                                                  // VkImageViewCreateFlags   flags
+                    target.image,                                       // VkImage                  image
+                    VK_IMAGE_VIEW_TYPE_2D,                              // VkImageViewType          viewType
+                    config_.format,                                     // VkFormat                 format
+                    {                                                   // VkComponentMapping       components
+                        VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY,
+                        VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY
+                    },
+                    { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 }           // VkImageSubresourceRange  subresourceRange
+                };
+                target.view = device_->create_image_view(view_create_info);
+            }
+
+            auto const readback_size = get_readback_size();
+            if (0 == readback_size)
+                return;
+
+            for (auto& slot : slots_)
+            {
+                VkBufferCreateInfo create_info =
+                {
+                    VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,               // VkStructureType          sType
+                    nullptr,                                            // const void*              pNext
+                    0,                                                  // VkBufferCreateFlags      flags
+                    readback_size,                                      // VkDeviceSize             size
+                    VK_BUFFER_USAGE_TRANSFER_DST_BIT,                   // VkBufferUsageFlags       usage
+                    VK_SHARING_MODE_EXCLUSIVE,                          // VkSharingMode            sharingMode
+                    0,                                                  // uint32_t                 queueFamilyIndexCount
+                    nullptr                                             // const uint32_t*          pQueueFamilyIndices
+                };
+                slot.readback_buffer = device_->create_buffer_handle(create_info);
+
+                // cached memory makes the cpu reads fast, coherent memory spares the invalidate
+                auto requirements = device_->get_buffer_memory_requirements(slot.readback_buffer);
+                auto type_index = device_->find_memory_type(requirements.memoryTypeBits,
+                    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT);
+                if (invalid_index == type_index)
+                    type_index = device_->find_memory_type(requirements.memoryTypeBits,
+                        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+                if (invalid_index == type_index)
+                    throw std::runtime_error{ "No host visible memory for the offscreen readback!" };
+
+                slot.readback_memory = device_->allocate_memory_handle(requirements.size, type_index);
+                device_->bind_buffer_memory(slot.readback_buffer, slot.readback_memory);
+                slot.readback_data = device_->map_memory(slot.readback_memory);
+            }
+        }
+
+        void destroy_targets()
+        {
+            for (auto& slot : slots_)
+            {
+                if (nullptr != slot.readback_memory)
+                    device_->unmap_memory(slot.readback_memory);
+                device_->destroy_buffer(std::exchange(slot.readback_buffer, nullptr));
+                device_->free_memory(std::exchange(slot.readback_memory, nullptr));
+                slot.readback_data = nullptr;
+                slot.capture_pending = false;
+            }
+
+            for (auto& target : targets_)
+            {
+                device_->destroy_image_view(target.view.reset(nullptr));
+                device_->destroy_image(target.image);
+                device_->free_memory(target.memory);
+            }
+            targets_.clear();
+        }
+
+        void recreate()
+        {
+            flush();
+            device_->wait_idle();
+            destroy_targets();
+            create_targets();
+            resize_pending_ = false;
+            ++generation_;
+        }
+
+        // present layout -> transfer source -> present layout, then make the copy visible to the host
+        void record_readback(frame_slot_t& slot)
+        {
+            if (nullptr == slot.readback_buffer)
+            {
+                slot.capture_pending = false;
+                return;
+            }
+
+            auto const& present = get_access_info(config_.present_access);
+            auto const& transfer = get_access_info(access_t::transfer_read);
+            auto image = targets_[slot.image_index].image;
+
+            VkImageMemoryBarrier to_transfer =
+            {
+                VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,         // VkStructureType          sType
+                nullptr,                                        // const void*              pNext
+                present.access & write_access_mask,             // VkAccessFlags            srcAccessMask
+                transfer.access,                                // VkAccessFlags            dstAccessMask
+                present.layout,                                 // VkImageLayout            oldLayout
+                transfer.layout,                                // VkImageLayout            newLayout
+                VK_QUEUE_FAMILY_IGNORED,                        // uint32_t                 srcQueueFamilyIndex
+                VK_QUEUE_FAMILY_IGNORED,                        // uint32_t                 dstQueueFamilyIndex
+                image,                                          // VkImage                  image
+                { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 }       // VkImageSubresourceRange  subresourceRange
+            };
+            device_->pipeline_barrier(slot.command_buffer, present.stages, transfer.stages,
+                0, nullptr, 0, nullptr, 1, &to_transfer);
+
+            VkBufferImageCopy region =
+            {
+                0,                                              // VkDeviceSize             bufferOffset
+                0,                                              // uint32_t                 bufferRowLength
+                0,                                              // uint32_t                 bufferImageHeight
+                { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 },         // VkImageSubresourceLayers imageSubresource
+                { 0, 0, 0 },                                    // VkOffset3D               imageOffset
+                { config_.extent.width, config_.extent.height, 1 }  // VkExtent3D           imageExtent
+            };
+            device_->get_command_table().vkCmdCopyImageToBuffer(slot.command_buffer, image, transfer.layout,
+                slot.readback_buffer, 1, &region);
+
+            VkImageMemoryBarrier to_present = to_transfer;
+            to_present.srcAccessMask = 0;
+            to_present.dstAccessMask = present.access;
+            to_present.oldLayout = transfer.layout;
+            to_present.newLayout = present.layout;
+
+            VkBufferMemoryBarrier to_host =
+            {
+                VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,        // VkStructureType          sType
+                nullptr,                                        // const void*              pNext
+                VK_ACCESS_TRANSFER_WRITE_BIT,                   // VkAccessFlags            srcAccessMask
+                VK_ACCESS_HOST_READ_BIT,                        // VkAccessFlags            dstAccessMask
+                VK_QUEUE_FAMILY_IGNORED,                        // uint32_t                 srcQueueFamilyIndex
+                VK_QUEUE_FAMILY_IGNORED,                        // uint32_t                 dstQueueFamilyIndex
+                slot.readback_buffer,                           // VkBuffer                 buffer
+                0,                                              // VkDeviceSize             offset
+                VK_WHOLE_SIZE                                   // VkDeviceSize             size
+            };
+            device_->pipeline_barrier(slot.command_buffer, transfer.stages, present.stages | VK_PIPELINE_STAGE_HOST_BIT,
+                0, nullptr, 1, &to_host, 1, &to_present);
+        }
+
+        void deliver_capture(frame_slot_t& slot)
+        {
+            if (!slot.capture_pending)
+                return;
+
+            slot.capture_pending = false;
+            if (!capture_callback_)
+                return;
+
+            captured_frame_t frame =
+            {
+                slot.frame_number,
+                config_.extent,
+                config_.format,
+                static_cast<uint8_t const*>(slot.readback_data),
+                static_cast<size_t>(config_.extent.width) * detail::get_color_format_size(config_.format),
+                get_readback_size()
+            };
+            capture_callback_(frame);
+        }
+
+    private:
+        Device const*                                   device_;
+        offscreen_config_t                              config_;
+        VkQueue                                         queue_;
+        std::vector<frame_slot_t>                       slots_;
+        std::vector<target_t>                           targets_;
+        std::function<void(captured_frame_t const&)>    capture_callback_;
+        uint32_t                                        frame_index_ = 0;
+        uint64_t                                        frame_number_ = 0;
+        uint64_t                                        generation_ = 0;
+        bool                                            capture_next_ = false;
+        bool                                            capture_all_ = false;
+        bool                                            resize_pending_ = false;
+    };
+}
@@ -0,0 +1,293 @@
+#pragma once
+
+namespace vk
+{
+    struct presenter_config_t
+    {
+        uint32_t                frames_in_flight = 2;
+        bool                    acquire_ahead = true;   // acquire the next image right after presenting
+    };
+
+    struct present_frame_t
+    {
+        uint32_t                frame_index = 0;
+        uint32_t                image_index = 0;
+        VkCommandBuffer         command_buffer = nullptr;
+        VkImage                 image = nullptr;
+        VkImageView             image_view = nullptr;
+        extent_2d_t             extent = { 0, 0 };
+    };
+
+    /// frames in flight on top of a KHR swapchain
+    /// every frame owns a command pool, a fence and an acquire semaphore, every swapchain image a
+    /// render finished semaphore. the swapchain is recreated in place, retiring the old one through
+    /// oldSwapchain, when it is out of date, suboptimal or resized. the old one is destroyed once the
+    /// fences of the frames submitted before the recreation have signaled, nothing waits for idle.
+    template <typename Instance, typename Device>
+    class presenter
+    {
+        struct frame_slot_t
+        {
+            VkCommandPool               command_pool = nullptr;
+            VkCommandBuffer             command_buffer = nullptr;
+            VkFence                     fence = nullptr;
+            VkSemaphore                 image_acquired = nullptr;
+            uint32_t                    image_index = invalid_index;
+            uint64_t                    submit_serial = 0;      // of the last submission, guarded by the fence
+            bool                        acquired = false;
+        };
+
+        struct retired_swapchain_t
+        {
+            std::unique_ptr<khr::detail::swapchain_t>   swapchain;
+            uint64_t                                    last_submit_serial;
+        };
+
+    public:
+        presenter(Instance const& instance, Device const& device, physical_device_t physical_device,
+            khr::surface_t const& surface, khr::swapchain_config_t const& swapchain_config,
+            uint32_t queue_family_index, presenter_config_t const& config = {})
+            : instance_(&instance)
+            , device_(&device)
+            , physical_device_(physical_device)
+            , surface_(&surface)
+            , swapchain_config_(swapchain_config)
+            , config_(config)
+            , queue_(device.get_device_queue(queue_family_index))
+            , slots_(config.frames_in_flight)
+        {
+            assert(config.frames_in_flight > 0);
+            for (auto& slot : slots_)
+            {
+                slot.command_pool = device.create_command_pool_handle(queue_family_index, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
+                slot.command_buffer = device.allocate_command_buffer(slot.command_pool);
+                slot.fence = device.create_fence_handle(true);
+                slot.image_acquired = device.create_semaphore_handle();
+            }
+
+            if (!recreate())
+                dirty_ = true;
+        }
+
+        ~presenter()
+        {
+            device_->wait_idle();
+            for (auto const& slot : slots_)
+            {
+                device_->destroy_semaphore(slot.image_acquired);
+                device_->destroy_fence(slot.fence);
+                device_->destroy_command_pool(slot.command_pool);
+            }
+
+            for (auto semaphore : render_finished_)
+                device_->destroy_semaphore(semaphore);
+        }
+
+        presenter(presenter const&) = delete;
+        presenter& operator=(presenter const&) = delete;
+
+        /// false when there is nothing to render into, e.g. the window is minimized
+        bool begin_frame(present_frame_t& frame)
+        {
+            auto& slot = slots_[frame_index_];
+            if (!slot.acquired && !acquire(slot))
+                return false;
+
+            device_->reset_command_pool(slot.command_pool);
+            device_->begin_command_buffer(slot.command_buffer);
+
+            frame.frame_index = frame_index_;
+            frame.image_index = slot.image_index;
+            frame.command_buffer = slot.command_buffer;
+            frame.image = swapchain_->get_images()[slot.image_index];
+            frame.image_view = swapchain_->get_image_view(slot.image_index);
+            frame.extent = swapchain_->get_extent();
+            return true;
+        }
+
+        /// submit the frame's command buffer and present its image
+        void end_frame(VkPipelineStageFlags wait_stage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT)
+        {
+            auto& slot = slots_[frame_index_];
+            assert(slot.acquired);
+            device_->end_command_buffer(slot.command_buffer);
+
+            auto render_finished = render_finished_[slot.image_index];
+            VkSubmitInfo submit_info =
+            {
+                VK_STRUCTURE_TYPE_SUBMIT_INFO,                  // VkStructureType              sType
+                nullptr,                                        // const void*                  pNext
+                1,                                              // uint32_t                     waitSemaphoreCount
+                &slot.image_acquired,                           // const VkSemaphore*           pWaitSemaphores
+                &wait_stage,                                    // const VkPipelineStageFlags*  pWaitDstStageMask
+                1,                                              // uint32_t                     commandBufferCount
+                &slot.command_buffer,                           // const VkCommandBuffer*       pCommandBuffers
+                1,                                              // uint32_t                     signalSemaphoreCount
+                &render_finished                                // const VkSemaphore*           pSignalSemaphores
+            };
+
+            device_->reset_fence(slot.fence);
+            device_->queue_submit(queue_, 1, &submit_info, slot.fence);
+            slot.submit_serial = ++submit_serial_;
+            slot.acquired = false;
+
+            if (VK_SUCCESS != device_->queue_present(queue_, *swapchain_, slot.image_index, render_finished))
+                dirty_ = true;
+
+            frame_index_ = (frame_index_ + 1) % static_cast<uint32_t>(slots_.size());
+
+            // no image is held at this point, which makes it the place to recreate
+            if (dirty_)
+                recreate();
+
+            if (config_.acquire_ahead && !dirty_)
+                acquire(slots_[frame_index_]);
+        }
+
+        /// the swapchain follows the new size on the next frame
+        void resize(extent_2d_t extent) noexcept
+        {
+            swapchain_config_.present_image_size = extent;
+            dirty_ = true;
+        }
+
+        khr::detail::swapchain_t& get_swapchain() noexcept
+        {
+            return *swapchain_;
+        }
+
+        khr::swapchain_config_t const& get_swapchain_config() const noexcept
+        {
+            return swapchain_config_;
+        }
+
+        /// bumped every time the swapchain is recreated
+        uint64_t get_generation() const noexcept
+        {
+            return generation_;
+        }
+
+        uint32_t get_frames_in_flight() const noexcept
+        {
+            return static_cast<uint32_t>(slots_.size());
+        }
+
+        /// fence signaled when the most recently submitted frame finishes on the GPU
+        VkFence get_last_submit_fence() const noexcept
+        {
+            auto const count = static_cast<uint32_t>(slots_.size());
+            return slots_[(frame_index_ + count - 1) % count].fence;
+        }
+
+        VkQueue get_queue() const noexcept
+        {
+            return queue_;
+        }
+
+    private:
+        bool acquire(frame_slot_t& slot)
+        {
+            for (uint32_t attempt = 0; attempt < 2; ++attempt)
+            {
+                if (dirty_ && !recreate())
+                    return false;
+
+                // the semaphore and the command pool are free once the slot's last submission is done
+                device_->wait_for_fence(slot.fence);
+                release_retired();
+
+                auto result = device_->acquire_next_image(*swapchain_, slot.image_acquired, nullptr, slot.image_index);
+                if (VK_ERROR_OUT_OF_DATE_KHR == result)
+                {
+                    dirty_ = true;
+                    continue;
+                }
+
+                if (VK_SUCCESS != result && VK_SUBOPTIMAL_KHR != result)
+                    throw std::runtime_error{ "Failed to call vkAcquireNextImageKHR!" };
+
+                if (VK_SUBOPTIMAL_KHR == result)
+                    dirty_ = true;
+
+                slot.acquired = true;
+                return true;
+            }
+            return false;
+        }
+
+        // a slot whose last submission came after the serial already waited for the earlier ones
+        bool is_submit_done(uint64_t serial) const
+        {
+            return std::all_of(slots_.cbegin(), slots_.cend(), [this, serial](auto const& slot)
+            {
+                return slot.submit_serial > serial || device_->is_fence_signaled(slot.fence);
+            });
+        }
+
+        void release_retired()
+        {
+            retired_.erase(std::remove_if(retired_.begin(), retired_.end(), [this](auto const& retired)
+            {
+                return is_submit_done(retired.last_submit_serial);
+            }), retired_.end());
+        }
+
+        bool recreate()
+        {
+            auto capabilities = instance_->get_capabilities(physical_device_, *surface_);
+
+            auto extent = capabilities.currentExtent;
+            if (static_cast<uint32_t>(-1) == extent.width)
+            {
+                extent.width = std::clamp(swapchain_config_.present_image_size.width,
+                    capabilities.minImageExtent.width, capabilities.maxImageExtent.width);
+                extent.height = std::clamp(swapchain_config_.present_image_size.height,
+                    capabilities.minImageExtent.height, capabilities.maxImageExtent.height);
+            }
+
+            if (0 == extent.width || 0 == extent.height)
+                return false;
+
+            swapchain_config_.present_image_size = extent;
+            swapchain_config_.present_image_count = std::max(swapchain_config_.present_image_count, capabilities.minImageCount);
+            if (0 != capabilities.maxImageCount)
+                swapchain_config_.present_image_count = std::min(swapchain_config_.present_image_count, capabilities.maxImageCount);
+            if (VK_SURFACE_TRANSFORM_FLAG_BITS_MAX_ENUM_KHR == swapchain_config_.surface_transform_flags ||
+                0 == (capabilities.supportedTransforms & swapchain_config_.surface_transform_flags))
+                swapchain_config_.surface_transform_flags = capabilities.currentTransform;
+
+            // the frames in flight may still render into the old images, it lives until their fences signal
+            release_retired();
+            auto old_swapchain = std::move(swapchain_);
+            swapchain_ = std::make_unique<khr::detail::swapchain_t>(device_->create_presentable_swapchain(
+                *surface_, swapchain_config_, nullptr != old_swapchain ? static_cast<VkSwapchainKHR>(*old_swapchain) : nullptr));
+            if (nullptr != old_swapchain)
+                retired_.push_back({ std::move(old_swapchain), submit_serial_ });
+
+            auto const image_count = swapchain_->get_images().size();
+            while (render_finished_.size() < image_count)
+                render_finished_.push_back(device_->create_semaphore_handle());
+
+            dirty_ = false;
+            ++generation_;
+            return true;
+        }
+
+    private:
+        Instance const*                                 instance_;
+        Device const*                                   device_;
+        physical_device_t                               physical_device_;
+        khr::surface_t const*                           surface_;
+        khr::swapchain_config_t                         swapchain_config_;
+        presenter_config_t                              config_;
+        VkQueue                                         queue_;
+        std::vector<frame_slot_t>                       slots_;
+        std::vector<VkSemaphore>                        render_finished_;
+        std::unique_ptr<khr::detail::swapchain_t>       swapchain_;
+        std::vector<retired_swapchain_t>                retired_;
+        uint32_t                                        frame_index_ = 0;
+        uint64_t                                        submit_serial_ = 0;
+        uint64_t                                        generation_ = 0;
+        bool                                            dirty_ = false;
+    };
+}
@@ -0,0 +1,737 @@
+#pragma once
+
+namespace vk
+{
+    struct graph_image_desc_t
+    {
+        VkFormat                format = VK_FORMAT_UNDEFINED;
+        extent_2d_t             extent = { 0, 0 };
+        VkSampleCountFlagBits   samples = VK_SAMPLE_COUNT_1_BIT;
+        uint32_t                mip_levels = 1;
+        uint32_t                layers = 1;
+    };
+
+    struct graph_buffer_desc_t
+    {
+        VkDeviceSize            size = 0;
+    };
+
+    struct graph_resource_t
+    {
+        uint32_t                index = invalid_index;
+
+        bool valid() const noexcept
+        {
+            return invalid_index != index;
+        }
+    };
+
+    struct render_graph_statistics_t
+    {
+        uint32_t                live_passes = 0;
+        uint32_t                culled_passes = 0;
+        uint32_t                barrier_calls = 0;
+        uint32_t                image_transitions = 0;
+        VkDeviceSize            transient_bytes = 0;        // memory bound to the transient resources
+        VkDeviceSize            unaliased_bytes = 0;        // memory they would need without aliasing
+    };
+
+    /// frame graph
+    /// passes declare how they access resources, compile() culls the passes which contribute to
+    /// no output, aliases the memory of transient resources with disjoint lifetimes and plans one
+    /// merged pipeline barrier in front of every pass. execute() replays the plan each frame.
+    template <typename Device>
+    class render_graph
+    {
+        enum class resource_kind_t { image, buffer };
+
+        struct resource_node_t
+        {
+            std::string                 name;
+            resource_kind_t             kind = resource_kind_t::image;
+            bool                        imported = false;
+            graph_image_desc_t          image_desc;
+            graph_buffer_desc_t         buffer_desc;
+            VkImageUsageFlags           image_usage = 0;
+            VkBufferUsageFlags          buffer_usage = 0;
+            access_t                    initial_access = access_t::none;
+            access_t                    final_access = access_t::none;
+
+            VkImage                     image = nullptr;
+            VkImageView                 image_view = nullptr;
+            VkBuffer                    buffer = nullptr;
+            object<VkImageView>         owned_view;
+
+            // transient placement
+            uint32_t                    first_pass = invalid_index;
+            uint32_t                    last_pass = invalid_index;
+            std::vector<uint32_t>       aliased;                // earlier occupants of overlapping memory
+            VkMemoryRequirements        requirements = {};
+            VkDeviceSize                offset = 0;
+        };
+
+        struct resource_access_t
+        {
+            uint32_t                    resource;
+            access_t                    access;
+        };
+
+        struct pass_node_t
+        {
+            std::string                                                 name;
+            std::vector<resource_access_t>                              reads;
+            std::vector<resource_access_t>                              writes;
+            bool                                                        side_effect = false;
+            bool                                                        live = false;
+            std::function<void(VkCommandBuffer, render_graph const&)>   execute;
+        };
+
+        struct image_transition_t
+        {
+            uint32_t                    resource;
+            VkAccessFlags               src_access;
+            VkAccessFlags               dst_access;
+            VkImageLayout               old_layout;
+            VkImageLayout               new_layout;
+        };
+
+        // everything the pass waits for, merged into one vkCmdPipelineBarrier
+        struct barrier_plan_t
+        {
+            VkPipelineStageFlags                src_stages = 0;
+            VkPipelineStageFlags                dst_stages = 0;
+            VkAccessFlags                       src_access = 0;
+            VkAccessFlags                       dst_access = 0;
+            std::vector<image_transition_t>     transitions;
+
+            bool empty() const noexcept
+            {
+                return 0 == dst_stages;
+            }
+        };
+
+        struct heap_t
+        {
+            VkDeviceMemory              memory = nullptr;
+            VkDeviceSize                size = 0;
+        };
+
+    public:
+        class pass_builder_t
+        {
+            friend class render_graph;
+
+            pass_builder_t(render_graph& graph, pass_node_t& pass)
+                : graph_(graph), pass_(pass)
+            {}
+
+        public:
+            graph_resource_t read(graph_resource_t resource, access_t access)
+            {
+                assert(!get_access_info(access).write);
+                pass_.reads.push_back({ resource.index, access });
+                graph_.add_usage(resource, access);
+                return resource;
+            }
+
+            graph_resource_t write(graph_resource_t resource, access_t access)
+            {
+                assert(get_access_info(access).write);
+                pass_.writes.push_back({ resource.index, access });
+                graph_.add_usage(resource, access);
+                return resource;
+            }
+
+            /// the pass is never culled, e.g. it writes to host visible memory or uploads data
+            void side_effect() noexcept
+            {
+                pass_.side_effect = true;
+            }
+
+        private:
+            render_graph&       graph_;
+            pass_node_t&        pass_;
+        };
+
+        explicit render_graph(Device const& device)
+            : device_(&device)
+        {}
+
+        ~render_graph()
+        {
+            release_transients();
+        }
+
+        render_graph(render_graph const&) = delete;
+        render_graph& operator=(render_graph const&) = delete;
+
+        graph_resource_t create_image(std::string name, graph_image_desc_t const& desc)
+        {
+            resource_node_t resource;
+            resource.name = std::move(name);
+            resource.kind = resource_kind_t::image;
+            resource.image_desc = desc;
+            return add_resource(std::move(resource));
+        }
+
+        graph_resource_t create_buffer(std::string name, graph_buffer_desc_t const& desc)
+        {
+            resource_node_t resource;
+            resource.name = std::move(name);
+            resource.kind = resource_kind_t::buffer;
+            resource.buffer_desc = desc;
+            return add_resource(std::move(resource));
+        }
+
+        /// external image, e.g. a swapchain image, left in the layout of final_access after the graph
+        graph_resource_t import_image(std::string name, VkImage image, VkImageView view, graph_image_desc_t const& desc,
+            access_t initial_access, access_t final_access)
+        {
+            resource_node_t resource;
+            resource.name = std::move(name);
+            resource.kind = resource_kind_t::image;
+            resource.imported = true;
+            resource.image_desc = desc;
+            resource.image = image;
+            resource.image_view = view;
+            resource.initial_access = initial_access;
+            resource.final_access = final_access;
+            return add_resource(std::move(resource));
+        }
+
+        graph_resource_t import_buffer(std::string name, VkBuffer buffer, VkDeviceSize size,
+            access_t initial_access, access_t final_access)
+        {
+            resource_node_t resource;
+            resource.name = std::move(name);
+            resource.kind = resource_kind_t::buffer;
+            resource.imported = true;
+            resource.buffer_desc.size = size;
+            resource.buffer = buffer;
+            resource.initial_access = initial_access;
+            resource.final_access = final_access;
+            return add_resource(std::move(resource));
+        }
+
+        /// swap the handles of an imported image between two executions, e.g. the acquired swapchain image
+        void set_imported_image(graph_resource_t resource, VkImage image, VkImageView view)
+        {
+            auto& node = resources_[resource.index];
+            assert(node.imported && node.kind == resource_kind_t::image);
+            node.image = image;
+            node.image_view = view;
+        }
+
+        void set_imported_buffer(graph_resource_t resource, VkBuffer buffer)
+        {
+            auto& node = resources_[resource.index];
+            assert(node.imported && node.kind == resource_kind_t::buffer);
+            node.buffer = buffer;
+        }
+
+        template <typename Setup, typename Execute>
+        void add_pass(std::string name, Setup&& setup, Execute&& execute)
+        {
+            assert(!compiled_);
+            passes_.emplace_back();
+            auto& pass = passes_.back();
+            pass.name = std::move(name);
+
+            pass_builder_t builder{ *this, pass };
+            setup(builder);
+            pass.execute = std::forward<Execute>(execute);
+        }
+
+        void compile()
+        {
+            release_transients();
+            cull_passes();
+            compute_lifetimes();
+            allocate_transients();
+            plan_barriers();
+            compiled_ = true;
+        }
+
+        void execute(VkCommandBuffer command_buffer) const
+        {
+            execute_passes(command_buffer, [this, command_buffer](VkPipelineStageFlags src_stages, VkPipelineStageFlags dst_stages,
+                uint32_t memory_barrier_count, VkMemoryBarrier const* memory_barriers,
+                uint32_t image_barrier_count, VkImageMemoryBarrier const* image_barriers)
+            {
+                device_->pipeline_barrier(command_buffer, src_stages, dst_stages, memory_barrier_count, memory_barriers,
+                    0, nullptr, image_barrier_count, image_barriers);
+            });
+        }
+
+        /// the barriers go through the recorder's command table, so a capture of it holds them
+        /// the passes record into the command buffer behind the recorder's back, so its shadowed state is dropped afterwards
+        void execute(command_recorder<Device>& recorder) const
+        {
+            execute_passes(recorder, [&recorder](VkPipelineStageFlags src_stages, VkPipelineStageFlags dst_stages,
+                uint32_t memory_barrier_count, VkMemoryBarrier const* memory_barriers,
+                uint32_t image_barrier_count, VkImageMemoryBarrier const* image_barriers)
+            {
+                recorder.pipeline_barrier(src_stages, dst_stages, memory_barrier_count, memory_barriers,
+                    0, nullptr, image_barrier_count, image_barriers);
+            });
+            recorder.invalidate();
+        }
+
+        VkImage get_image(graph_resource_t resource) const
+        {
+            return resources_[resource.index].image;
+        }
+
+        VkImageView get_image_view(graph_resource_t resource) const
+        {
+            return resources_[resource.index].image_view;
+        }
+
+        VkBuffer get_buffer(graph_resource_t resource) const
+        {
+            return resources_[resource.index].buffer;
+        }
+
+        bool is_live(std::string const& pass_name) const
+        {
+            auto itr = std::find_if(passes_.cbegin(), passes_.cend(), [&pass_name](auto const& pass)
+            {
+                return pass.name == pass_name;
+            });
+            return itr != passes_.cend() && itr->live;
+        }
+
+        render_graph_statistics_t const& get_statistics() const noexcept
+        {
+            return statistics_;
+        }
+
+    private:
+        graph_resource_t add_resource(resource_node_t resource)
+        {
+            assert(!compiled_);
+            resources_.push_back(std::move(resource));
+            return { static_cast<uint32_t>(resources_.size() - 1) };
+        }
+
+        void add_usage(graph_resource_t resource, access_t access)
+        {
+            auto& node = resources_[resource.index];
+            auto const& info = get_access_info(access);
+            node.image_usage |= info.image_usage;
+            node.buffer_usage |= info.buffer_usage;
+        }
+
+        void cull_passes()
+        {
+            // walk backwards from the imported resources and the passes with side effects
+            std::vector<bool> needed(resources_.size(), false);
+            for (uint32_t i = 0; i < resources_.size(); ++i)
+                needed[i] = resources_[i].imported;
+
+            statistics_ = {};
+            for (auto pass = passes_.rbegin(); pass != passes_.rend(); ++pass)
+            {
+                pass->live = pass->side_effect || std::any_of(pass->writes.cbegin(), pass->writes.cend(),
+                    [&needed](auto const& write) { return needed[write.resource]; });
+
+                if (!pass->live)
+                {
+                    ++statistics_.culled_passes;
+                    continue;
+                }
+
+                ++statistics_.live_passes;
+
+                // a full overwrite hides the earlier contents from this consumer
+                for (auto const& write : pass->writes)
+                {
+                    if (!resources_[write.resource].imported)
+                        needed[write.resource] = false;
+                }
+
+                for (auto const& read : pass->reads)
+                    needed[read.resource] = true;
+            }
+        }
+
+        void compute_lifetimes()
+        {
+            for (auto& resource : resources_)
+            {
+                resource.first_pass = invalid_index;
+                resource.last_pass = invalid_index;
+                resource.aliased.clear();
+            }
+
+            for (uint32_t i = 0; i < passes_.size(); ++i)
+            {
+                if (!passes_[i].live)
+                    continue;
+
+                auto touch = [this, i](auto const& resource_access)
+                {
+                    auto& resource = resources_[resource_access.resource];
+                    if (invalid_index == resource.first_pass)
+                        resource.first_pass = i;
+                    resource.last_pass = i;
+                };
+                std::for_each(passes_[i].reads.cbegin(), passes_[i].reads.cend(), touch);
+                std::for_each(passes_[i].writes.cbegin(), passes_[i].writes.cend(), touch);
+            }
+        }
+
+        void create_transient_handle(resource_node_t& resource)
+        {
+            if (resource.kind == resource_kind_t::image)
+            {
+                auto const& desc = resource.image_desc;
+                VkImageCreateInfo create_info =
+                {
+                    VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,                // VkStructureType          sType
+                    nullptr,                                            // const void*              pNext
+                    0,                                                  // VkImageCreateFlags       flags
+                    VK_IMAGE_TYPE_2D,                                   // VkImageType              imageType
+                    desc.format,                                        // VkFormat                 format
+                    { desc.extent.width, desc.extent.height, 1 },       // VkExtent3D               extent
+                    desc.mip_levels,                                    // uint32_t                 mipLevels
+                    desc.layers,                                        // uint32_t                 arrayLayers
+                    desc.samples,                                       // VkSampleCountFlagBits    samples
+                    VK_IMAGE_TILING_OPTIMAL,                            // VkImageTiling            tiling
+                    resource.image_usage,                               // VkImageUsageFlags        usage
+                    VK_SHARING_MODE_EXCLUSIVE,                          // VkSharingMode            sharingMode
+                    0,                                                  // uint32_t                 queueFamilyIndexCount
+                    nullptr,                                            // const uint32_t*          pQueueFamilyIndices
+                    VK_IMAGE_LAYOUT_UNDEFINED                           // VkImageLayout            initialLayout
+                };
+                resource.image = device_->create_image_handle(create_info);
+                resource.requirements = device_->get_image_memory_requirements(resource.image);
+            }
+            else
+            {
+                VkBufferCreateInfo create_info =
+                {
+                    VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,               // VkStructureType          sType
+                    nullptr,                                            // const void*              pNext
+                    0,                                                  // VkBufferCreateFlags      flags
+                    resource.buffer_desc.size,                          // VkDeviceSize             size
+                    resource.buffer_usage,                              // VkBufferUsageFlags       usage
+                    VK_SHARING_MODE_EXCLUSIVE,                          // VkSharingMode            sharingMode
+                    0,                                                  // uint32_t                 queueFamilyIndexCount
+                    nullptr                                             // const uint32_t*          pQueueFamilyIndices
+                };
+                resource.buffer = device_->create_buffer_handle(create_info);
+                resource.requirements = device_->get_buffer_memory_requirements(resource.buffer);
+            }
+        }
+
+        void allocate_transients()
+        {
+            // images and buffers live in separate heaps, which sidesteps bufferImageGranularity
+            std::map<std::pair<uint32_t, resource_kind_t>, std::vector<uint32_t>> groups;
+            for (uint32_t i = 0; i < resources_.size(); ++i)
+            {
+                auto& resource = resources_[i];
+                if (resource.imported || invalid_index == resource.first_pass)
+                    continue;
+
+                create_transient_handle(resource);
+                auto type_index = device_->find_memory_type(resource.requirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+                if (invalid_index == type_index)
+                    throw std::runtime_error{ "No device local memory for transient resource " + resource.name };
+
+                groups[{ type_index, resource.kind }].push_back(i);
+                statistics_.unaliased_bytes += resource.requirements.size;
+            }
+
+            for (auto& group : groups)
+            {
+                auto heap_size = place_group(group.second);
+                heap_t heap;
+                heap.size = heap_size;
+                heap.memory = device_->allocate_memory_handle(heap_size, group.first.first);
+                heaps_.push_back(heap);
+                statistics_.transient_bytes += heap_size;
+
+                for (auto index : group.second)
+                    bind_transient(resources_[index], heap.memory);
+            }
+        }
+
+        // greedy first-fit placement, biggest resources first, overlapping only with disjoint lifetimes
+        VkDeviceSize place_group(std::vector<uint32_t>& group)
+        {
+            std::sort(group.begin(), group.end(), [this](auto lhs, auto rhs)
+            {
+                return resources_[lhs].requirements.size > resources_[rhs].requirements.size;
+            });
+
+            VkDeviceSize heap_size = 0;
+            std::vector<uint32_t> placed;
+            for (auto index : group)
+            {
+                auto& resource = resources_[index];
+                auto overlaps = [&resource](resource_node_t const& other)
+                {
+                    return resource.first_pass <= other.last_pass && other.first_pass <= resource.last_pass;
+                };
+
+                std::vector<std::pair<VkDeviceSize, VkDeviceSize>> occupied;
+                for (auto other : placed)
+                {
+                    if (overlaps(resources_[other]))
+                        occupied.emplace_back(resources_[other].offset, resources_[other].offset + resources_[other].requirements.size);
+                }
+                std::sort(occupied.begin(), occupied.end());
+
+                auto const alignment = std::max<VkDeviceSize>(resource.requirements.alignment, 1);
+                VkDeviceSize offset = 0;
+                for (auto const& range : occupied)
+                {
+                    if (offset + resource.requirements.size <= range.first)
+                        break;
+                    offset = std::max(offset, (range.second + alignment - 1) / alignment * alignment);
+                }
+
+                resource.offset = offset;
+                heap_size = std::max(heap_size, offset + resource.requirements.size);
+                placed.push_back(index);
+            }
+
+            // every earlier occupant of the memory hands it over, they may end in different passes and
+            // the size order places them in any order, so look at the whole group once it is placed
+            for (auto index : group)
+            {
+                auto& resource = resources_[index];
+                auto const end = resource.offset + resource.requirements.size;
+                for (auto other : group)
+                {
+                    auto const& other_resource = resources_[other];
+                    if (other_resource.last_pass >= resource.first_pass)
+                        continue;
+
+                    if (other_resource.offset < end && resource.offset < other_resource.offset + other_resource.requirements.size)
+                        resource.aliased.push_back(other);
+                }
+            }
+
+            return heap_size;
+        }
+
+        void bind_transient(resource_node_t& resource, VkDeviceMemory memory)
+        {
+            if (resource.kind == resource_kind_t::buffer)
+            {
+                device_->bind_buffer_memory(resource.buffer, memory, resource.offset);
+                return;
+            }
+
+            device_->bind_image_memory(resource.image, memory, resource.offset);
+
+            auto const& desc = resource.image_desc;
+            VkImageViewCreateInfo create_info =
+            {
+                VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,                       // VkStructureType          sType
+                nullptr,                                                        // const void*              pNext
+                0,                                                              // VkImageViewCreateFlags   flags
+                resource.image,                                                 // VkImage                  image
+                desc.layers > 1 ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_2D,  // VkImageViewType  viewType
+                desc.format,                                                    // VkFormat                 format
+                {                                                               // VkComponentMapping       components
+                    VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY,
+                    VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY
+                },
+                { get_image_aspect(desc.format), 0, desc.mip_levels, 0, desc.layers }   // VkImageSubresourceRange  subresourceRange
+            };
+            resource.owned_view = device_->create_image_view(create_info);
+            resource.image_view = resource.owned_view;
+        }
+
+        void release_transients()
+        {
+            for (auto& resource : resources_)
+            {
+                if (resource.imported)
+                    continue;
+
+                device_->destroy_image_view(resource.owned_view.reset(nullptr));
+                resource.image_view = nullptr;
+                device_->destroy_image(std::exchange(resource.image, nullptr));
+                device_->destroy_buffer(std::exchange(resource.buffer, nullptr));
+            }
+
+            for (auto const& heap : heaps_)
+                device_->free_memory(heap.memory);
+
+            heaps_.clear();
+            compiled_ = false;
+        }
+
+        void plan_barriers()
+        {
+            barriers_.assign(passes_.size() + 1, barrier_plan_t{});
+            std::vector<access_state_t> states(resources_.size());
+            std::vector<bool> used(resources_.size(), false);
+
+            for (uint32_t i = 0; i < resources_.size(); ++i)
+            {
+                if (!resources_[i].imported)
+                    continue;
+
+                states[i] = make_access_state(resources_[i].initial_access);
+                used[i] = true;
+            }
+
+            for (uint32_t i = 0; i < passes_.size(); ++i)
+            {
+                auto const& pass = passes_[i];
+                if (!pass.live)
+                    continue;
+
+                // a resource read and written by the same pass is one combined access
+                std::vector<std::pair<uint32_t, access_info_t>> accesses;
+                auto combine = [&accesses](resource_access_t const& resource_access)
+                {
+                    auto const& info = get_access_info(resource_access.access);
+                    auto itr = std::find_if(accesses.begin(), accesses.end(), [&resource_access](auto const& access)
+                    {
+                        return access.first == resource_access.resource;
+                    });
+
+                    if (itr == accesses.end())
+                    {
+                        accesses.emplace_back(resource_access.resource, info);
+                        return;
+                    }
+
+                    itr->second.stages |= info.stages;
+                    itr->second.access |= info.access;
+                    if (info.write)
+                    {
+                        itr->second.layout = info.layout;
+                        itr->second.write = true;
+                    }
+                };
+                std::for_each(pass.reads.cbegin(), pass.reads.cend(), combine);
+                std::for_each(pass.writes.cbegin(), pass.writes.cend(), combine);
+
+                for (auto const& access : accesses)
+                    transition(barriers_[i], states, used, access.first, access.second);
+            }
+
+            for (uint32_t i = 0; i < resources_.size(); ++i)
+            {
+                if (resources_[i].imported && resources_[i].final_access != access_t::none)
+                    transition(barriers_.back(), states, used, i, get_access_info(resources_[i].final_access));
+            }
+
+            statistics_.barrier_calls = static_cast<uint32_t>(std::count_if(barriers_.cbegin(), barriers_.cend(),
+                [](auto const& barrier) { return !barrier.empty(); }));
+            for (auto const& barrier : barriers_)
+                statistics_.image_transitions += static_cast<uint32_t>(barrier.transitions.size());
+        }
+
+        void transition(barrier_plan_t& barrier, std::vector<access_state_t>& states, std::vector<bool>& used,
+            uint32_t index, access_info_t const& required)
+        {
+            auto const& resource = resources_[index];
+            auto& state = states[index];
+
+            // the first use of aliased memory waits for the reads and writes of all previous occupants
+            if (!used[index])
+            {
+                for (auto previous_index : resource.aliased)
+                {
+                    auto const& previous = states[previous_index];
+                    state.write_stages |= previous.write_stages;
+                    state.write_access |= previous.write_access;
+                    state.read_stages |= previous.read_stages;
+                }
+            }
+            used[index] = true;
+
+            auto dependency = update_access_state(state, required, resource.kind == resource_kind_t::image);
+            if (!dependency.needed)
+                return;
+
+            barrier.src_stages |= dependency.src_stages;
+            barrier.dst_stages |= 0 != required.stages ? required.stages : VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+
+            if (dependency.layout_change)
+            {
+                barrier.transitions.push_back({ index, dependency.src_access, required.access, dependency.old_layout, required.layout });
+            }
+            else
+            {
+                barrier.src_access |= dependency.src_access;
+                barrier.dst_access |= required.access;
+            }
+        }
+
+        template <typename Emit>
+        void execute_passes(VkCommandBuffer command_buffer, Emit&& emit) const
+        {
+            assert(compiled_);
+            for (uint32_t i = 0; i < passes_.size(); ++i)
+            {
+                if (!passes_[i].live)
+                    continue;
+
+                emit_barrier(barriers_[i], emit);
+                passes_[i].execute(command_buffer, *this);
+            }
+
+            // leave the imported resources the way the outside world expects them
+            emit_barrier(barriers_.back(), emit);
+        }
+
+        template <typename Emit>
+        void emit_barrier(barrier_plan_t const& barrier, Emit& emit) const
+        {
+            if (barrier.empty())
+                return;
+
+            VkMemoryBarrier memory_barrier =
+            {
+                VK_STRUCTURE_TYPE_MEMORY_BARRIER,               // VkStructureType          sType
+                nullptr,                                        // const void*              pNext
+                barrier.src_access,                             // VkAccessFlags            srcAccessMask
+                barrier.dst_access                              // VkAccessFlags            dstAccessMask
+            };
+
+            image_barriers_.clear();
+            for (auto const& transition : barrier.transitions)
+            {
+                auto const& resource = resources_[transition.resource];
+                auto const& desc = resource.image_desc;
+                image_barriers_.push_back({
+                    VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,     // VkStructureType          sType
+                    nullptr,                                    // const void*              pNext
+                    transition.src_access,                      // VkAccessFlags            srcAccessMask
+                    transition.dst_access,                      // VkAccessFlags            dstAccessMask
+                    transition.old_layout,                      // VkImageLayout            oldLayout
+                    transition.new_layout,                      // VkImageLayout            newLayout
+                    VK_QUEUE_FAMILY_IGNORED,                    // uint32_t                 srcQueueFamilyIndex
+                    VK_QUEUE_FAMILY_IGNORED,                    // uint32_t                 dstQueueFamilyIndex
+                    resource.image,                             // VkImage                  image
+                    { get_image_aspect(desc.format), 0, desc.mip_levels, 0, desc.layers }  // VkImageSubresourceRange  subresourceRange
+                });
+            }
+
+            bool const has_memory_barrier = 0 != barrier.src_access || 0 != barrier.dst_access;
+            emit(barrier.src_stages, barrier.dst_stages,
+                has_memory_barrier ? 1 : 0, has_memory_barrier ? &memory_barrier : nullptr,
+                static_cast<uint32_t>(image_barriers_.size()), image_barriers_.data());
+        }
+
+    private:
+        Device const*                               device_;
+        std::vector<resource_node_t>                resources_;
+        std::vector<pass_node_t>                    passes_;
+        std::vector<barrier_plan_t>                 barriers_;
+        std::vector<heap_t>                         heaps_;
+        mutable std::vector<VkImageMemoryBarrier>   image_barriers_;
+        render_graph_statistics_t                   statistics_;
+        bool                                        compiled_ = false;
+    };
+}
@@ -5,7 +5,17 @@
 #include "core/object.hpp"
 #include "core/global.hpp"
 #include "core/physical_device.hpp"
+#include "core/access.hpp"
+#include "core/layout.hpp"
+#include "core/block_layout.hpp"
+#include "core/sampler.hpp"
+#include "core/render_pass.hpp"
+#include "core/command_buffer.hpp"
+#include "core/state_tracker.hpp"
+#include "core/capture.hpp"
 #include "core/device.hpp"
+#include "core/device_buffer.hpp"
+#include "core/descriptor.hpp"
 #include "core/instance.hpp"
 
 // app
@@ -13,4 +23,15 @@
 
 // extension
 #include "extensions/khr.hpp"
+#include "extensions/ext.hpp"
+
+// render
+#include "render/render_graph.hpp"
+#include "render/draw_list.hpp"
+#include "render/geometry_pool.hpp"
+#include "render/gpu_culling.hpp"
+#include "render/presenter.hpp"
+#include "render/offscreen_presenter.hpp"
+#include "render/frame_pacer.hpp"
+#include "render/gpu_profiler.hpp"
 
@@ -2,11 +2,32 @@
 
 // standart library
 #include <memory>
+#include <array>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <algorithm>
 #include <iterator>
 #include <functional>
+#include <atomic>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
+#include <map>
+#include <bitset>
+#include <cstring>
+#include <utility>
+#include <thread>
+#include <condition_variable>
+#include <chrono>
+#include <deque>
+#include <numeric>
+#include <cmath>
+#include <exception>
+#include <type_traits>
+#include <fstream>
+#include <cstddef>
+#include <new>
 
 // boost library
 #include <boost/dll.hpp>
@@ -28,6 +49,13 @@
 // base library
 #include "base/mpl.hpp"
 #include "base/functional.hpp"
+#include "base/hash.hpp"
+#include "base/worker_pool.hpp"
+#include "base/radix_sort.hpp"
+#include "base/span.hpp"
+#include "base/frame_arena.hpp"
+#include "base/spsc_queue.hpp"
+#include "base/trace.hpp"
 
 #define VULKAN_STR1(token) #token
 #define VULKAN_STR2(token) VULKAN_STR1(token)
@@ -37,11 +65,11 @@
 #endif
 
 #ifndef VULKAN_LOAD_INSTNACE_FUNCTION
-#define VULKAN_LOAD_INSTNACE_FUNCTION(name) global.load_func(VULKAN_STR2(name), name, instance)
+#define VULKAN_LOAD_INSTNACE_FUNCTION(name) (global.load_func(VULKAN_STR2(name), name, instance), VULKAN_TRACE_FUNCTION(name))
 #endif
 
 #ifndef VULKAN_LOAD_DEVICE_FUNCTION
-#define VULKAN_LOAD_DEVICE_FUNCTION(name) instance.load_func(VULKAN_STR2(name), name, device)
+#define VULKAN_LOAD_DEVICE_FUNCTION(name) (instance.load_func(VULKAN_STR2(name), name, device), VULKAN_TRACE_FUNCTION(name))
 #endif
 
 #ifndef VULKAN_EXPORT_FUNCTION
@@ -49,7 +77,7 @@
 #endif
 
 #ifndef VULKAN_LOAD_FUNCTION
-#define VULKAN_LOAD_FUNCTION(name) load_func(VULKAN_STR2(name), name)
+#define VULKAN_LOAD_FUNCTION(name) (load_func(VULKAN_STR2(name), name), VULKAN_TRACE_FUNCTION(name))
 #endif
 
 namespace vk
@@ -110,7 +138,18 @@ namespace vk
     using extension_properties_t = std::vector<extension_property_t>;
     using queue_create_info_t = std::vector<queue_info_t>;
 
-#if defined _WIN32
+    /// load a given Vulkan implementation instead of the system loader, e.g. a mock driver
+#if defined VULKANCPP_LIBRARY
+    struct platform_override
+    {
+        static std::string const dynamic_library() noexcept
+        {
+            return VULKANCPP_LIBRARY;
+        }
+    };
+
+    using platform_type = platform_override;
+#elif defined _WIN32
     using platform_type = platform_windows;
 #elif defined __linux
     using platform_type = platform_linux;
@@ -0,0 +1,288 @@
+#include <iostream>
+#include <iomanip>
+#include <limits>
+#include <vulkancpp.hpp>
+#include "test_check.hpp"
+
+// wrapper against raw entry point cost, both sides call into the mock driver built next to this target
+// and do the same work, so that every difference is overhead of the wrapper. a row whose ratio is above
+// the bound, 1.25 or the first argument, fails the run; the numbers stay machine dependent measurements.
+
+using clock_type = std::chrono::steady_clock;
+
+double max_ratio = 1.25;
+uint32_t bound_failures = 0;
+
+// best of a few runs, in nanoseconds per operation
+template <typename F>
+double measure(uint32_t operations, F&& f)
+{
+    auto best = std::numeric_limits<double>::max();
+    for (uint32_t run = 0; run < 7; ++run)
+    {
+        auto begin = clock_type::now();
+        f();
+        auto elapsed = std::chrono::duration<double, std::nano>(clock_type::now() - begin).count();
+        best = std::min(best, elapsed / operations);
+    }
+    return best;
+}
+
+// bounded rows compare equivalent work, the others are for information
+void report(char const* name, double wrapper_ns, double raw_ns, bool bounded = true)
+{
+    auto const ratio = wrapper_ns / raw_ns;
+    bool const failed = bounded && ratio > max_ratio;
+    bound_failures += failed ? 1 : 0;
+
+    std::cout << std::left << std::setw(36) << name << std::right << std::fixed << std::setprecision(1)
+        << std::setw(10) << wrapper_ns << " ns"
+        << std::setw(10) << raw_ns << " ns"
+        << std::setw(8) << std::setprecision(2) << ratio << "x"
+        << (bounded ? (failed ? "  FAIL" : "  ok") : "") << "\n";
+}
+
+// the entry points of the mock driver, loaded without the wrapper
+struct raw_functions_t
+{
+    explicit raw_functions_t(VkInstance instance, VkDevice device)
+        : library(VULKANCPP_LIBRARY)
+    {
+        auto get_instance_proc_addr = &library.get<std::remove_pointer_t<PFN_vkGetInstanceProcAddr>>("vkGetInstanceProcAddr");
+        auto load = [&](auto& function, char const* name) {
+            function = reinterpret_cast<std::remove_reference_t<decltype(function)>>(get_instance_proc_addr(instance, name));
+        };
+
+        load(vkEnumeratePhysicalDevices, "vkEnumeratePhysicalDevices");
+        load(vkGetPhysicalDeviceProperties, "vkGetPhysicalDeviceProperties");
+        load(vkGetPhysicalDeviceFeatures, "vkGetPhysicalDeviceFeatures");
+        load(vkGetPhysicalDeviceQueueFamilyProperties, "vkGetPhysicalDeviceQueueFamilyProperties");
+        load(vkEnumerateDeviceExtensionProperties, "vkEnumerateDeviceExtensionProperties");
+        load(vkGetPhysicalDeviceSurfaceCapabilitiesKHR, "vkGetPhysicalDeviceSurfaceCapabilitiesKHR");
+        load(vkGetPhysicalDeviceSurfaceFormatsKHR, "vkGetPhysicalDeviceSurfaceFormatsKHR");
+        load(vkGetPhysicalDeviceSurfacePresentModesKHR, "vkGetPhysicalDeviceSurfacePresentModesKHR");
+        load(vkCreateBuffer, "vkCreateBuffer");
+        load(vkDestroyBuffer, "vkDestroyBuffer");
+        this->device = device;
+    }
+
+    boost::dll::shared_library                      library;
+    VkDevice                                        device = nullptr;
+    PFN_vkEnumeratePhysicalDevices                  vkEnumeratePhysicalDevices = nullptr;
+    PFN_vkGetPhysicalDeviceProperties               vkGetPhysicalDeviceProperties = nullptr;
+    PFN_vkGetPhysicalDeviceFeatures                 vkGetPhysicalDeviceFeatures = nullptr;
+    PFN_vkGetPhysicalDeviceQueueFamilyProperties    vkGetPhysicalDeviceQueueFamilyProperties = nullptr;
+    PFN_vkEnumerateDeviceExtensionProperties        vkEnumerateDeviceExtensionProperties = nullptr;
+    PFN_vkGetPhysicalDeviceSurfaceCapabilitiesKHR   vkGetPhysicalDeviceSurfaceCapabilitiesKHR = nullptr;
+    PFN_vkGetPhysicalDeviceSurfaceFormatsKHR        vkGetPhysicalDeviceSurfaceFormatsKHR = nullptr;
+    PFN_vkGetPhysicalDeviceSurfacePresentModesKHR   vkGetPhysicalDeviceSurfacePresentModesKHR = nullptr;
+    PFN_vkCreateBuffer                              vkCreateBuffer = nullptr;
+    PFN_vkDestroyBuffer                             vkDestroyBuffer = nullptr;
+};
+
+template <typename Device>
+void benchmark_objects(Device const& device, raw_functions_t const& raw)
+{
+    constexpr uint32_t count = 100000;
+    VkBufferCreateInfo create_info = {
+        VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,       // VkStructureType        sType
+        nullptr,                                    // void const*            pNext
+        0,                                          // VkBufferCreateFlags    flags
+        65536,                                      // VkDeviceSize           size
+        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,          // VkBufferUsageFlags     usage
+        VK_SHARING_MODE_EXCLUSIVE,                  // VkSharingMode          sharingMode
+        0,                                          // uint32_t               queueFamilyIndexCount
+        nullptr                                     // uint32_t const*        pQueueFamilyIndices
+    };
+
+    auto wrapper = measure(count, [&]() {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            vk::object<VkBuffer> buffer{ device.create_buffer_handle(create_info), [&device](VkBuffer buffer) { device.destroy_buffer(buffer); } };
+        }
+    });
+
+    auto baseline = measure(count, [&]() {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            VkBuffer buffer = nullptr;
+            raw.vkCreateBuffer(raw.device, &create_info, nullptr, &buffer);
+            raw.vkDestroyBuffer(raw.device, buffer, nullptr);
+        }
+    });
+    report("object<VkBuffer> create/destroy", wrapper, baseline);
+}
+
+template <typename Instance>
+void benchmark_enumeration(Instance const& instance, raw_functions_t const& raw, VkInstance instance_handle)
+{
+    constexpr uint32_t count = 10000;
+    auto any = [](auto const&) { return true; };
+    auto select_any = vk::physical_device_pipe(any);
+
+    // select_physical_device is the public route to the enumerate_* helpers
+    auto wrapper = measure(count, [&]() {
+        for (uint32_t i = 0; i < count; ++i)
+            instance.select_physical_device(select_any);
+    });
+
+    // the same result select_physical_device builds: properties, features, queue families and extensions
+    auto baseline = measure(count, [&]() {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            uint32_t device_count = 0;
+            raw.vkEnumeratePhysicalDevices(instance_handle, &device_count, nullptr);
+            std::vector<VkPhysicalDevice> devices(device_count);
+            raw.vkEnumeratePhysicalDevices(instance_handle, &device_count, devices.data());
+
+            std::vector<vk::physical_device_default_config_t> configs;
+            configs.reserve(devices.size());
+            for (auto device : devices)
+            {
+                vk::physical_device_default_config_t config{};
+                config.device = device;
+                raw.vkGetPhysicalDeviceProperties(device, &config.device_properties);
+                raw.vkGetPhysicalDeviceFeatures(device, &config.device_features);
+
+                uint32_t family_count = 0;
+                raw.vkGetPhysicalDeviceQueueFamilyProperties(device, &family_count, nullptr);
+                std::vector<VkQueueFamilyProperties> families(family_count);
+                raw.vkGetPhysicalDeviceQueueFamilyProperties(device, &family_count, families.data());
+                config.queue_families.reserve(family_count);
+                for (uint32_t family = 0; family < family_count; ++family)
+                    config.queue_families.push_back({ family, families[family] });
+
+                uint32_t extension_count = 0;
+                raw.vkEnumerateDeviceExtensionProperties(device, nullptr, &extension_count, nullptr);
+                config.extension_properties.resize(extension_count);
+                raw.vkEnumerateDeviceExtensionProperties(device, nullptr, &extension_count, config.extension_properties.data());
+                configs.push_back(std::move(config));
+            }
+        }
+    });
+    report("select_physical_device", wrapper, baseline);
+}
+
+template <typename Instance>
+void benchmark_surface_properties(Instance const& instance, raw_functions_t const& raw, vk::physical_device_t physical_device)
+{
+    constexpr uint32_t count = 100000;
+    auto surface_handle = make_test_handle<VkSurfaceKHR>(0x10);
+    vk::khr::surface_t surface{ surface_handle, [](VkSurfaceKHR) {} };
+
+    auto wrapper = measure(count, [&]() {
+        for (uint32_t i = 0; i < count; ++i)
+            instance.get_properties(physical_device, surface);
+    });
+
+    auto baseline = measure(count, [&]() {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            vk::khr::surface_properties_t properties;
+            raw.vkGetPhysicalDeviceSurfaceCapabilitiesKHR(physical_device, surface_handle, &properties.capabilities);
+
+            uint32_t format_count = 0;
+            raw.vkGetPhysicalDeviceSurfaceFormatsKHR(physical_device, surface_handle, &format_count, nullptr);
+            properties.formats.resize(format_count);
+            raw.vkGetPhysicalDeviceSurfaceFormatsKHR(physical_device, surface_handle, &format_count, properties.formats.data());
+
+            uint32_t mode_count = 0;
+            raw.vkGetPhysicalDeviceSurfacePresentModesKHR(physical_device, surface_handle, &mode_count, nullptr);
+            properties.present_modes.resize(mode_count);
+            raw.vkGetPhysicalDeviceSurfacePresentModesKHR(physical_device, surface_handle, &mode_count, properties.present_modes.data());
+        }
+    });
+    report("khr surface get_properties", wrapper, baseline);
+}
+
+// draws sorted by pipeline and set, every draw re-binds everything and the recorder filters the repeats
+template <typename Device>
+void benchmark_command_stream(Device const& device)
+{
+    constexpr uint32_t draws = 10000;
+    auto layout = make_test_handle<VkPipelineLayout>(0x100);
+    auto vertex_buffer = make_test_handle<VkBuffer>(0x400);
+    auto index_buffer = make_test_handle<VkBuffer>(0x500);
+    auto pipeline = [](uint32_t i) { return make_test_handle<VkPipeline>(0x200 + i / 1000); };
+    auto set = [](uint32_t i) { return make_test_handle<VkDescriptorSet>(0x300 + i / 100); };
+    VkCommandBuffer command_buffer = nullptr;
+
+    vk::command_recorder<Device> recorder{ device, command_buffer };
+    auto wrapper = measure(draws, [&]() {
+        recorder.reset(command_buffer);
+        for (uint32_t i = 0; i < draws; ++i)
+        {
+            recorder.bind_pipeline(VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline(i));
+            recorder.bind_descriptor_set(VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 0, set(i));
+            recorder.push_constants(layout, VK_SHADER_STAGE_VERTEX_BIT, i);
+            recorder.bind_vertex_buffer(0, vertex_buffer);
+            recorder.bind_index_buffer(index_buffer, 0, VK_INDEX_TYPE_UINT16);
+            recorder.draw_indexed(36);
+        }
+    });
+
+    // the raw side issues every call, as an application without filtering would
+    auto const& table = device.get_command_table();
+    auto unfiltered = measure(draws, [&]() {
+        VkDeviceSize offset = 0;
+        for (uint32_t i = 0; i < draws; ++i)
+        {
+            auto descriptor_set = set(i);
+            table.vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline(i));
+            table.vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 0, 1, &descriptor_set, 0, nullptr);
+            table.vkCmdPushConstants(command_buffer, layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(i), &i);
+            table.vkCmdBindVertexBuffers(command_buffer, 0, 1, &vertex_buffer, &offset);
+            table.vkCmdBindIndexBuffer(command_buffer, index_buffer, 0, VK_INDEX_TYPE_UINT16);
+            table.vkCmdDrawIndexed(command_buffer, 36, 1, 0, 0, 0);
+        }
+    });
+
+    // and the hand-filtered stream is the best the recorder could do, it does less work so it is not bounded
+    auto filtered = measure(draws, [&]() {
+        VkDeviceSize offset = 0;
+        table.vkCmdBindVertexBuffers(command_buffer, 0, 1, &vertex_buffer, &offset);
+        table.vkCmdBindIndexBuffer(command_buffer, index_buffer, 0, VK_INDEX_TYPE_UINT16);
+        for (uint32_t i = 0; i < draws; ++i)
+        {
+            if (0 == i % 1000)
+                table.vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline(i));
+            if (0 == i % 100)
+            {
+                auto descriptor_set = set(i);
+                table.vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 0, 1, &descriptor_set, 0, nullptr);
+            }
+            table.vkCmdPushConstants(command_buffer, layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(i), &i);
+            table.vkCmdDrawIndexed(command_buffer, 36, 1, 0, 0, 0);
+        }
+    });
+
+    report("command_recorder draw (unfiltered)", wrapper, unfiltered);
+    report("command_recorder draw (filtered)", wrapper, filtered, false);
+}
+
+int main(int argc, char** argv)
+{
+    using namespace std::string_literals;
+    if (argc > 1)
+        max_ratio = std::stod(argv[1]);
+
+    auto& global = vk::global_t::get();
+    vk::instance_param_t param = { "benchmark"s, "vulkancpp"s };
+    auto instance = global.create_instance(param, vk::khr::surface_ext);
+
+    auto any = [](auto const&) { return true; };
+    auto physical_device = instance.select_physical_device(vk::physical_device_pipe(any));
+    auto device = instance.create_logical_device(physical_device.device, { { 0, { 1.0f } } });
+    raw_functions_t raw{ instance.get_instance(), device.get_device() };
+
+    std::cout << std::left << std::setw(36) << "" << std::right
+        << std::setw(13) << "wrapper" << std::setw(13) << "raw" << std::setw(9) << "ratio" << "\n";
+    benchmark_objects(device, raw);
+    benchmark_enumeration(instance, raw, instance.get_instance());
+    benchmark_surface_properties(instance, raw, physical_device.device);
+    benchmark_command_stream(device);
+
+    if (0 != bound_failures)
+        std::cout << bound_failures << " rows above the " << max_ratio << "x bound\n";
+    return 0 != bound_failures ? 1 : 0;
+}
@@ -0,0 +1,282 @@
+// a minimal in-process Vulkan implementation for the benchmarks
+// it is loaded in place of the Vulkan loader, see VULKANCPP_LIBRARY. objects are fake handles and
+// commands do nothing, so that a benchmark measures the wrapper and not a driver. entry points the
+// benchmarks never call resolve to a no-op returning VK_SUCCESS.
+
+#include <cstring>
+#include <atomic>
+#include <vulkan/vulkan.h>
+
+#if defined _WIN32
+#define MOCK_EXPORT extern "C" __declspec(dllexport)
+#else
+#define MOCK_EXPORT extern "C" __attribute__((visibility("default")))
+#endif
+
+namespace
+{
+    struct dispatchable_t { void* loader_data = nullptr; };
+
+    dispatchable_t mock_instance;
+    dispatchable_t mock_physical_device;
+    dispatchable_t mock_device;
+    dispatchable_t mock_queue;
+    std::atomic<uint64_t> next_handle{ 1 };
+
+    template <typename Handle>
+    Handle make_handle()
+    {
+        return reinterpret_cast<Handle>(static_cast<uintptr_t>(next_handle.fetch_add(1, std::memory_order_relaxed) << 4));
+    }
+
+    template <typename T>
+    VkResult fill_array(T const* source, uint32_t source_count, uint32_t* count, T* values)
+    {
+        if (nullptr == values)
+        {
+            *count = source_count;
+            return VK_SUCCESS;
+        }
+
+        auto copied = *count < source_count ? *count : source_count;
+        std::memcpy(values, source, sizeof(T) * copied);
+        *count = copied;
+        return copied < source_count ? VK_INCOMPLETE : VK_SUCCESS;
+    }
+
+    VkExtensionProperties const instance_extensions[] =
+    {
+        { VK_KHR_SURFACE_EXTENSION_NAME, 25 },
+    };
+
+    VkExtensionProperties const device_extensions[] =
+    {
+        { VK_KHR_SWAPCHAIN_EXTENSION_NAME, 70 },
+    };
+
+    VkSurfaceFormatKHR const surface_formats[] =
+    {
+        { VK_FORMAT_B8G8R8A8_UNORM, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR },
+        { VK_FORMAT_B8G8R8A8_SRGB, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR },
+        { VK_FORMAT_R8G8B8A8_UNORM, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR },
+        { VK_FORMAT_A2B10G10R10_UNORM_PACK32, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR },
+    };
+
+    VkPresentModeKHR const present_modes[] =
+    {
+        VK_PRESENT_MODE_FIFO_KHR,
+        VK_PRESENT_MODE_MAILBOX_KHR,
+        VK_PRESENT_MODE_IMMEDIATE_KHR,
+    };
+
+    VKAPI_ATTR VkResult VKAPI_CALL mock_noop()
+    {
+        return VK_SUCCESS;
+    }
+
+    VKAPI_ATTR VkResult VKAPI_CALL mock_create_instance(VkInstanceCreateInfo const*, VkAllocationCallbacks const*, VkInstance* instance)
+    {
+        *instance = reinterpret_cast<VkInstance>(&mock_instance);
+        return VK_SUCCESS;
+    }
+
+    VKAPI_ATTR void VKAPI_CALL mock_destroy_instance(VkInstance, VkAllocationCallbacks const*)
+    {}
+
+    VKAPI_ATTR VkResult VKAPI_CALL mock_enumerate_instance_extension_properties(char const*, uint32_t* count, VkExtensionProperties* properties)
+    {
+        return fill_array(instance_extensions, 1, count, properties);
+    }
+
+    VKAPI_ATTR VkResult VKAPI_CALL mock_enumerate_instance_layer_properties(uint32_t* count, VkLayerProperties*)
+    {
+        *count = 0;
+        return VK_SUCCESS;
+    }
+
+    VKAPI_ATTR VkResult VKAPI_CALL mock_enumerate_physical_devices(VkInstance, uint32_t* count, VkPhysicalDevice* devices)
+    {
+        auto device = reinterpret_cast<VkPhysicalDevice>(&mock_physical_device);
+        return fill_array(&device, 1, count, devices);
+    }
+
+    VKAPI_ATTR void VKAPI_CALL mock_get_physical_device_features(VkPhysicalDevice, VkPhysicalDeviceFeatures* features)
+    {
+        *features = {};
+    }
+
+    VKAPI_ATTR void VKAPI_CALL mock_get_physical_device_properties(VkPhysicalDevice, VkPhysicalDeviceProperties* properties)
+    {
+        *properties = {};
+        properties->apiVersion = VK_MAKE_VERSION(1, 0, 0);
+        properties->deviceType = VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU;
+        std::strcpy(properties->deviceName, "vulkancpp mock device");
+        properties->limits.maxPushConstantsSize = 128;
+        properties->limits.timestampPeriod = 1.0f;
+        properties->limits.timestampComputeAndGraphics = VK_TRUE;
+    }
+
+    VKAPI_ATTR void VKAPI_CALL mock_get_physical_device_queue_family_properties(VkPhysicalDevice, uint32_t* count, VkQueueFamilyProperties* properties)
+    {
+        VkQueueFamilyProperties const family = { VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT | VK_QUEUE_TRANSFER_BIT, 1, 64, { 1, 1, 1 } };
+        fill_array(&family, 1, count, properties);
+    }
+
+    VKAPI_ATTR void VKAPI_CALL mock_get_physical_device_memory_properties(VkPhysicalDevice, VkPhysicalDeviceMemoryProperties* properties)
+    {
+        *properties = {};
+        properties->memoryTypeCount = 2;
+        properties->memoryTypes[0] = { VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0 };
+        properties->memoryTypes[1] = { VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, 1 };
+        properties->memoryHeapCount = 2;
+        properties->memoryHeaps[0] = { 1ull << 32, VK_MEMORY_HEAP_DEVICE_LOCAL_BIT };
+        properties->memoryHeaps[1] = { 1ull << 32, 0 };
+    }
+
+    VKAPI_ATTR VkResult VKAPI_CALL mock_enumerate_device_extension_properties(VkPhysicalDevice, char const*, uint32_t* count, VkExtensionProperties* properties)
+    {
+        return fill_array(device_extensions, 1, count, properties);
+    }
+
+    VKAPI_ATTR VkResult VKAPI_CALL mock_create_device(VkPhysicalDevice, VkDeviceCreateInfo const*, VkAllocationCallbacks const*, VkDevice* device)
+    {
+        *device = reinterpret_cast<VkDevice>(&mock_device);
+        return VK_SUCCESS;
+    }
+
+    VKAPI_ATTR void VKAPI_CALL mock_destroy_device(VkDevice, VkAllocationCallbacks const*)
+    {}
+
+    VKAPI_ATTR void VKAPI_CALL mock_get_device_queue(VkDevice, uint32_t, uint32_t, VkQueue* queue)
+    {
+        *queue = reinterpret_cast<VkQueue>(&mock_queue);
+    }
+
+    VKAPI_ATTR VkResult VKAPI_CALL mock_create_buffer(VkDevice, VkBufferCreateInfo const*, VkAllocationCallbacks const*, VkBuffer* buffer)
+    {
+        *buffer = make_handle<VkBuffer>();
+        return VK_SUCCESS;
+    }
+
+    VKAPI_ATTR void VKAPI_CALL mock_destroy_buffer(VkDevice, VkBuffer, VkAllocationCallbacks const*)
+    {}
+
+    VKAPI_ATTR VkResult VKAPI_CALL mock_get_surface_support(VkPhysicalDevice, uint32_t, VkSurfaceKHR, VkBool32* supported)
+    {
+        *supported = VK_TRUE;
+        return VK_SUCCESS;
+    }
+
+    VKAPI_ATTR VkResult VKAPI_CALL mock_get_surface_capabilities(VkPhysicalDevice, VkSurfaceKHR, VkSurfaceCapabilitiesKHR* capabilities)
+    {
+        *capabilities = {};
+        capabilities->minImageCount = 2;
+        capabilities->maxImageCount = 8;
+        capabilities->currentExtent = { 1280, 720 };
+        capabilities->minImageExtent = { 1, 1 };
+        capabilities->maxImageExtent = { 16384, 16384 };
+        capabilities->maxImageArrayLayers = 1;
+        capabilities->supportedTransforms = VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR;
+        capabilities->currentTransform = VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR;
+        capabilities->supportedCompositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
+        capabilities->supportedUsageFlags = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+        return VK_SUCCESS;
+    }
+
+    VKAPI_ATTR VkResult VKAPI_CALL mock_get_surface_formats(VkPhysicalDevice, VkSurfaceKHR, uint32_t* count, VkSurfaceFormatKHR* formats)
+    {
+        return fill_array(surface_formats, 4, count, formats);
+    }
+
+    VKAPI_ATTR VkResult VKAPI_CALL mock_get_surface_present_modes(VkPhysicalDevice, VkSurfaceKHR, uint32_t* count, VkPresentModeKHR* modes)
+    {
+        return fill_array(present_modes, 3, count, modes);
+    }
+
+    VKAPI_ATTR void VKAPI_CALL mock_cmd_bind_pipeline(VkCommandBuffer, VkPipelineBindPoint, VkPipeline) {}
+    VKAPI_ATTR void VKAPI_CALL mock_cmd_bind_descriptor_sets(VkCommandBuffer, VkPipelineBindPoint, VkPipelineLayout, uint32_t, uint32_t, VkDescriptorSet const*, uint32_t, uint32_t const*) {}
+    VKAPI_ATTR void VKAPI_CALL mock_cmd_bind_vertex_buffers(VkCommandBuffer, uint32_t, uint32_t, VkBuffer const*, VkDeviceSize const*) {}
+    VKAPI_ATTR void VKAPI_CALL mock_cmd_bind_index_buffer(VkCommandBuffer, VkBuffer, VkDeviceSize, VkIndexType) {}
+    VKAPI_ATTR void VKAPI_CALL mock_cmd_set_viewport(VkCommandBuffer, uint32_t, uint32_t, VkViewport const*) {}
+    VKAPI_ATTR void VKAPI_CALL mock_cmd_set_scissor(VkCommandBuffer, uint32_t, uint32_t, VkRect2D const*) {}
+    VKAPI_ATTR void VKAPI_CALL mock_cmd_push_constants(VkCommandBuffer, VkPipelineLayout, VkShaderStageFlags, uint32_t, uint32_t, void const*) {}
+    VKAPI_ATTR void VKAPI_CALL mock_cmd_draw(VkCommandBuffer, uint32_t, uint32_t, uint32_t, uint32_t) {}
+    VKAPI_ATTR void VKAPI_CALL mock_cmd_draw_indexed(VkCommandBuffer, uint32_t, uint32_t, uint32_t, int32_t, uint32_t) {}
+    VKAPI_ATTR void VKAPI_CALL mock_cmd_draw_indexed_indirect(VkCommandBuffer, VkBuffer, VkDeviceSize, uint32_t, uint32_t) {}
+    VKAPI_ATTR void VKAPI_CALL mock_cmd_dispatch(VkCommandBuffer, uint32_t, uint32_t, uint32_t) {}
+    VKAPI_ATTR void VKAPI_CALL mock_cmd_pipeline_barrier(VkCommandBuffer, VkPipelineStageFlags, VkPipelineStageFlags, VkDependencyFlags,
+        uint32_t, VkMemoryBarrier const*, uint32_t, VkBufferMemoryBarrier const*, uint32_t, VkImageMemoryBarrier const*) {}
+    VKAPI_ATTR void VKAPI_CALL mock_cmd_end_render_pass(VkCommandBuffer) {}
+
+    struct entry_t
+    {
+        char const*             name;
+        PFN_vkVoidFunction      function;
+    };
+
+#define MOCK_ENTRY(name, function) { #name, reinterpret_cast<PFN_vkVoidFunction>(&function) }
+
+    entry_t const entries[] =
+    {
+        MOCK_ENTRY(vkCreateInstance, mock_create_instance),
+        MOCK_ENTRY(vkDestroyInstance, mock_destroy_instance),
+        MOCK_ENTRY(vkEnumerateInstanceExtensionProperties, mock_enumerate_instance_extension_properties),
+        MOCK_ENTRY(vkEnumerateInstanceLayerProperties, mock_enumerate_instance_layer_properties),
+        MOCK_ENTRY(vkEnumeratePhysicalDevices, mock_enumerate_physical_devices),
+        MOCK_ENTRY(vkGetPhysicalDeviceFeatures, mock_get_physical_device_features),
+        MOCK_ENTRY(vkGetPhysicalDeviceProperties, mock_get_physical_device_properties),
+        MOCK_ENTRY(vkGetPhysicalDeviceQueueFamilyProperties, mock_get_physical_device_queue_family_properties),
+        MOCK_ENTRY(vkGetPhysicalDeviceMemoryProperties, mock_get_physical_device_memory_properties),
+        MOCK_ENTRY(vkEnumerateDeviceExtensionProperties, mock_enumerate_device_extension_properties),
+        MOCK_ENTRY(vkCreateDevice, mock_create_device),
+        MOCK_ENTRY(vkDestroyDevice, mock_destroy_device),
+        MOCK_ENTRY(vkGetDeviceQueue, mock_get_device_queue),
+        MOCK_ENTRY(vkCreateBuffer, mock_create_buffer),
+        MOCK_ENTRY(vkDestroyBuffer, mock_destroy_buffer),
+        MOCK_ENTRY(vkGetPhysicalDeviceSurfaceSupportKHR, mock_get_surface_support),
+        MOCK_ENTRY(vkGetPhysicalDeviceSurfaceCapabilitiesKHR, mock_get_surface_capabilities),
+        MOCK_ENTRY(vkGetPhysicalDeviceSurfaceFormatsKHR, mock_get_surface_formats),
+        MOCK_ENTRY(vkGetPhysicalDeviceSurfacePresentModesKHR, mock_get_surface_present_modes),
+        MOCK_ENTRY(vkCmdBindPipeline, mock_cmd_bind_pipeline),
+        MOCK_ENTRY(vkCmdBindDescriptorSets, mock_cmd_bind_descriptor_sets),
+        MOCK_ENTRY(vkCmdBindVertexBuffers, mock_cmd_bind_vertex_buffers),
+        MOCK_ENTRY(vkCmdBindIndexBuffer, mock_cmd_bind_index_buffer),
+        MOCK_ENTRY(vkCmdSetViewport, mock_cmd_set_viewport),
+        MOCK_ENTRY(vkCmdSetScissor, mock_cmd_set_scissor),
+        MOCK_ENTRY(vkCmdPushConstants, mock_cmd_push_constants),
+        MOCK_ENTRY(vkCmdDraw, mock_cmd_draw),
+        MOCK_ENTRY(vkCmdDrawIndexed, mock_cmd_draw_indexed),
+        MOCK_ENTRY(vkCmdDrawIndexedIndirect, mock_cmd_draw_indexed_indirect),
+        MOCK_ENTRY(vkCmdDispatch, mock_cmd_dispatch),
+        MOCK_ENTRY(vkCmdPipelineBarrier, mock_cmd_pipeline_barrier),
+        MOCK_ENTRY(vkCmdEndRenderPass, mock_cmd_end_render_pass),
+    };
+
+#undef MOCK_ENTRY
+
+    PFN_vkVoidFunction resolve(char const* name)
+    {
+        for (auto const& entry : entries)
+        {
+            if (0 == std::strcmp(entry.name, name))
+                return entry.function;
+        }
+        return reinterpret_cast<PFN_vkVoidFunction>(&mock_noop);
+    }
+
+    VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL mock_get_device_proc_addr(VkDevice, char const* name)
+    {
+        return resolve(name);
+    }
+}
+
+MOCK_EXPORT VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL vkGetInstanceProcAddr(VkInstance, char const* name)
+{
+    if (0 == std::strcmp(name, "vkGetInstanceProcAddr"))
+        return reinterpret_cast<PFN_vkVoidFunction>(&vkGetInstanceProcAddr);
+
+    if (0 == std::strcmp(name, "vkGetDeviceProcAddr"))
+        return reinterpret_cast<PFN_vkVoidFunction>(&mock_get_device_proc_addr);
+
+    return resolve(name);
+}
@@ -0,0 +1,193 @@
+#include <iostream>
+#include <vulkancpp.hpp>
+#include "test_check.hpp"
+
+// a command table which drops every command, replay then measures the wrapper side alone
+vk::command_table_t make_null_command_table()
+{
+    vk::command_table_t table;
+    table.vkCmdBindPipeline = [](VkCommandBuffer, VkPipelineBindPoint, VkPipeline) {};
+    table.vkCmdBindDescriptorSets = [](VkCommandBuffer, VkPipelineBindPoint, VkPipelineLayout, uint32_t, uint32_t, VkDescriptorSet const*, uint32_t, uint32_t const*) {};
+    table.vkCmdBindVertexBuffers = [](VkCommandBuffer, uint32_t, uint32_t, VkBuffer const*, VkDeviceSize const*) {};
+    table.vkCmdBindIndexBuffer = [](VkCommandBuffer, VkBuffer, VkDeviceSize, VkIndexType) {};
+    table.vkCmdSetViewport = [](VkCommandBuffer, uint32_t, uint32_t, VkViewport const*) {};
+    table.vkCmdSetScissor = [](VkCommandBuffer, uint32_t, uint32_t, VkRect2D const*) {};
+    table.vkCmdPushConstants = [](VkCommandBuffer, VkPipelineLayout, VkShaderStageFlags, uint32_t, uint32_t, void const*) {};
+    table.vkCmdDraw = [](VkCommandBuffer, uint32_t, uint32_t, uint32_t, uint32_t) {};
+    table.vkCmdDrawIndexed = [](VkCommandBuffer, uint32_t, uint32_t, uint32_t, int32_t, uint32_t) {};
+    table.vkCmdDrawIndexedIndirect = [](VkCommandBuffer, VkBuffer, VkDeviceSize, uint32_t, uint32_t) {};
+    table.vkCmdDispatch = [](VkCommandBuffer, uint32_t, uint32_t, uint32_t) {};
+    table.vkCmdCopyBuffer = [](VkCommandBuffer, VkBuffer, VkBuffer, uint32_t, VkBufferCopy const*) {};
+    table.vkCmdFillBuffer = [](VkCommandBuffer, VkBuffer, VkDeviceSize, VkDeviceSize, uint32_t) {};
+    table.vkCmdCopyImage = [](VkCommandBuffer, VkImage, VkImageLayout, VkImage, VkImageLayout, uint32_t, VkImageCopy const*) {};
+    table.vkCmdCopyBufferToImage = [](VkCommandBuffer, VkBuffer, VkImage, VkImageLayout, uint32_t, VkBufferImageCopy const*) {};
+    table.vkCmdCopyImageToBuffer = [](VkCommandBuffer, VkImage, VkImageLayout, VkBuffer, uint32_t, VkBufferImageCopy const*) {};
+    table.vkCmdBeginRenderPass = [](VkCommandBuffer, VkRenderPassBeginInfo const*, VkSubpassContents) {};
+    table.vkCmdEndRenderPass = [](VkCommandBuffer) {};
+    table.vkCmdExecuteCommands = [](VkCommandBuffer, uint32_t, VkCommandBuffer const*) {};
+    table.vkCmdResetQueryPool = [](VkCommandBuffer, VkQueryPool, uint32_t, uint32_t) {};
+    table.vkCmdWriteTimestamp = [](VkCommandBuffer, VkPipelineStageFlagBits, VkQueryPool, uint32_t) {};
+    table.vkCmdPipelineBarrier = [](VkCommandBuffer, VkPipelineStageFlags, VkPipelineStageFlags, VkDependencyFlags,
+        uint32_t, VkMemoryBarrier const*, uint32_t, VkBufferMemoryBarrier const*, uint32_t, VkImageMemoryBarrier const*) {};
+    return table;
+}
+
+struct null_device_t
+{
+    vk::command_table_t                 table = make_null_command_table();
+
+    vk::command_table_t const& get_command_table() const noexcept
+    {
+        return table;
+    }
+
+    void pipeline_barrier(VkCommandBuffer, VkPipelineStageFlags, VkPipelineStageFlags,
+        uint32_t, VkMemoryBarrier const*, uint32_t, VkBufferMemoryBarrier const*, uint32_t, VkImageMemoryBarrier const*) const
+    {}
+};
+
+// a frame of sorted draws over a few pipelines and descriptor sets, recorded through a capture
+std::vector<uint8_t> record_synthetic_frame(null_device_t const& device)
+{
+    vk::command_capture_t capture{ device.get_command_table() };
+    vk::command_recorder<null_device_t> recorder{ device, nullptr };
+    recorder.set_command_table(capture.get_command_table());
+
+    capture.begin();
+    recorder.set_viewport({ 0.0f, 0.0f, 1280.0f, 720.0f, 0.0f, 1.0f });
+    recorder.set_scissor({ { 0, 0 }, { 1280, 720 } });
+    for (uint32_t i = 0; i < 10000; ++i)
+    {
+        auto layout = make_test_handle<VkPipelineLayout>(0x100);
+        recorder.bind_pipeline(VK_PIPELINE_BIND_POINT_GRAPHICS, make_test_handle<VkPipeline>(0x200 + i / 1000));
+        recorder.bind_descriptor_set(VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 0, make_test_handle<VkDescriptorSet>(0x300 + i / 100));
+        recorder.push_constants(layout, VK_SHADER_STAGE_VERTEX_BIT, i);
+        recorder.bind_vertex_buffer(0, make_test_handle<VkBuffer>(0x400), i * 1024ull);
+        recorder.bind_index_buffer(make_test_handle<VkBuffer>(0x500), 0, VK_INDEX_TYPE_UINT16);
+        recorder.draw_indexed(36, 1, 0, 0, 0);
+    }
+    capture.end();
+    return capture.get_stream();
+}
+
+// fills a buffer through a captured stream replayed on a real device and reads the result back
+int replay_on_device()
+{
+    using namespace std::string_literals;
+    constexpr VkDeviceSize size = 4096;
+    constexpr uint32_t pattern = 0x5eed5eed;
+
+    null_device_t null_device;
+    vk::command_capture_t capture{ null_device.get_command_table() };
+    vk::command_recorder<null_device_t> recorder{ null_device, nullptr };
+    recorder.set_command_table(capture.get_command_table());
+    auto captured_buffer = make_test_handle<VkBuffer>(0x400);
+
+    capture.begin();
+    recorder.fill_buffer(captured_buffer, 0, size, pattern);
+    capture.end();
+
+    auto& global = vk::global_t::get();
+    vk::instance_param_t param = { "replay"s, "vulkancpp"s };
+    auto instance = global.create_instance(param);
+
+    auto any = [](auto const&) { return true; };
+    auto physical_device = instance.select_physical_device(vk::physical_device_pipe(any));
+    auto family = std::find_if(physical_device.queue_families.cbegin(), physical_device.queue_families.cend(), [](auto const& family)
+    {
+        return 0 != (family.properties.queueFlags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT));
+    });
+    if (family == physical_device.queue_families.cend())
+        throw std::runtime_error{ "No queue family for the replay!" };
+
+    auto device = instance.create_logical_device(physical_device.device, { { family->index, { 1.0f } } });
+
+    VkBufferCreateInfo create_info =
+    {
+        VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,               // VkStructureType          sType
+        nullptr,                                            // const void*              pNext
+        0,                                                  // VkBufferCreateFlags      flags
+        size,                                               // VkDeviceSize             size
+        VK_BUFFER_USAGE_TRANSFER_DST_BIT,                   // VkBufferUsageFlags       usage
+        VK_SHARING_MODE_EXCLUSIVE,                          // VkSharingMode            sharingMode
+        0,                                                  // uint32_t                 queueFamilyIndexCount
+        nullptr                                             // const uint32_t*          pQueueFamilyIndices
+    };
+    auto buffer = device.create_buffer_handle(create_info);
+    auto requirements = device.get_buffer_memory_requirements(buffer);
+    auto memory = device.allocate_memory_handle(requirements.size, device.find_memory_type(requirements.memoryTypeBits,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT));
+    device.bind_buffer_memory(buffer, memory);
+
+    auto pool = device.create_command_pool_handle(family->index);
+    auto command_buffer = device.allocate_command_buffer(pool);
+    auto fence = device.create_fence_handle();
+
+    vk::capture_handle_map_t handles;
+    vk::set_capture_handle(handles, captured_buffer, buffer);
+
+    device.begin_command_buffer(command_buffer);
+    auto commands = vk::replay_capture(capture.get_stream(), device, command_buffer, handles);
+
+    VkMemoryBarrier host_barrier =
+    {
+        VK_STRUCTURE_TYPE_MEMORY_BARRIER,                   // VkStructureType          sType
+        nullptr,                                            // const void*              pNext
+        VK_ACCESS_TRANSFER_WRITE_BIT,                       // VkAccessFlags            srcAccessMask
+        VK_ACCESS_HOST_READ_BIT                             // VkAccessFlags            dstAccessMask
+    };
+    device.pipeline_barrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT,
+        1, &host_barrier, 0, nullptr, 0, nullptr);
+    device.end_command_buffer(command_buffer);
+
+    VkSubmitInfo submit_info =
+    {
+        VK_STRUCTURE_TYPE_SUBMIT_INFO,                      // VkStructureType              sType
+        nullptr,                                            // const void*                  pNext
+        0,                                                  // uint32_t                     waitSemaphoreCount
+        nullptr,                                            // const VkSemaphore*           pWaitSemaphores
+        nullptr,                                            // const VkPipelineStageFlags*  pWaitDstStageMask
+        1,                                                  // uint32_t                     commandBufferCount
+        &command_buffer,                                    // const VkCommandBuffer*       pCommandBuffers
+        0,                                                  // uint32_t                     signalSemaphoreCount
+        nullptr                                             // const VkSemaphore*           pSignalSemaphores
+    };
+    device.queue_submit(device.get_device_queue(family->index), 1, &submit_info, fence);
+    device.wait_for_fence(fence);
+
+    auto values = static_cast<uint32_t const*>(device.map_memory(memory));
+    auto filled = std::all_of(values, values + size / sizeof(uint32_t), [](auto value) { return pattern == value; });
+    device.unmap_memory(memory);
+
+    device.destroy_fence(fence);
+    device.destroy_command_pool(pool);
+    device.destroy_buffer(buffer);
+    device.free_memory(memory);
+
+    std::cout << "device replay: " << commands << " commands, buffer " << (filled ? "filled" : "NOT filled") << "\n";
+    return filled ? 0 : 1;
+}
+
+// replay_capture [stream [iterations]] times the decoding, replay_capture --device replays on a real device
+int main(int argc, char** argv)
+{
+    using namespace std::string_literals;
+    if (argc > 1 && "--device"s == argv[1])
+        return replay_on_device();
+
+    null_device_t device;
+    auto stream = argc > 1 ? vk::load_capture(argv[1]) : record_synthetic_frame(device);
+    auto iterations = argc > 2 ? std::stoul(argv[2]) : 100ul;
+
+    using clock_t = std::chrono::steady_clock;
+    uint64_t commands = 0;
+    auto begin = clock_t::now();
+    for (unsigned long i = 0; i < iterations; ++i)
+        commands = vk::replay_capture_unmapped(stream, device.get_command_table(), nullptr);
+    auto elapsed = std::chrono::duration<double, std::milli>(clock_t::now() - begin).count();
+
+    std::cout << "stream: " << stream.size() << " bytes, " << commands << " commands\n"
+        << "replay: " << elapsed / iterations << " ms per stream, "
+        << elapsed * 1e6 / (static_cast<double>(commands) * iterations) << " ns per command\n";
+    return 0;
+}
@@ -0,0 +1,103 @@
+#include <vulkancpp.hpp>
+#include "test_check.hpp"
+
+using namespace vk::glsl;
+
+// a float packs into the padding after a vec3 under both rules
+using vec3_float_140 = vk::std140_block<vec3, float>;
+using vec3_float_430 = vk::std430_block<vec3, float>;
+static_assert(0 == vec3_float_140::offset<0> && 12 == vec3_float_140::offset<1> && 16 == vec3_float_140::size);
+static_assert(0 == vec3_float_430::offset<0> && 12 == vec3_float_430::offset<1> && 16 == vec3_float_430::size);
+
+// a vec3 after a float still starts on 16 bytes
+using float_vec3_430 = vk::std430_block<float, vec3>;
+static_assert(16 == float_vec3_430::offset<1> && 32 == float_vec3_430::size);
+
+// mat3 columns are vec3 padded to 16 bytes under both rules
+using mat3_140 = vk::std140_block<float, mat3, float>;
+using mat3_430 = vk::std430_block<float, mat3, float>;
+static_assert(16 == mat3_140::offset<1> && 64 == mat3_140::offset<2> && 80 == mat3_140::size);
+static_assert(16 == mat3_430::offset<1> && 64 == mat3_430::offset<2> && 80 == mat3_430::size);
+static_assert(16 == vk::detail::field_layout<vk::layout_rule_t::std430, mat3>::stride);
+
+// mat2 columns are vec2, std140 rounds them up to a vec4
+static_assert(32 == vk::detail::field_layout<vk::layout_rule_t::std140, mat2>::size);
+static_assert(16 == vk::detail::field_layout<vk::layout_rule_t::std430, mat2>::size);
+
+// scalar arrays have a stride of 16 in std140 and 4 in std430
+using scalars_140 = vk::std140_block<float, array<float, 4>, float>;
+using scalars_430 = vk::std430_block<float, array<float, 4>, float>;
+static_assert(16 == vk::detail::field_layout<vk::layout_rule_t::std140, array<float, 4>>::stride);
+static_assert(4 == vk::detail::field_layout<vk::layout_rule_t::std430, array<float, 4>>::stride);
+static_assert(16 == scalars_140::offset<1> && 80 == scalars_140::offset<2> && 96 == scalars_140::size);
+static_assert(4 == scalars_430::offset<1> && 20 == scalars_430::offset<2> && 24 == scalars_430::size);
+
+// vec3 arrays are padded to 16 bytes under both rules
+static_assert(16 == vk::detail::field_layout<vk::layout_rule_t::std140, array<vec3, 2>>::stride);
+static_assert(16 == vk::detail::field_layout<vk::layout_rule_t::std430, array<vec3, 2>>::stride);
+
+// a nested struct is aligned to 16 and padded to 16 in std140, to its largest member in std430
+using light = block<vec3, float, vec2>;
+using nested_140 = vk::std140_block<float, light, float>;
+using nested_430 = vk::std430_block<float, light, float>;
+static_assert(16 == vk::detail::field_layout<vk::layout_rule_t::std140, light>::alignment);
+static_assert(32 == vk::detail::field_layout<vk::layout_rule_t::std140, light>::size);
+static_assert(16 == nested_140::offset<1> && 48 == nested_140::offset<2> && 64 == nested_140::size);
+static_assert(16 == nested_430::offset<1> && 48 == nested_430::offset<2> && 64 == nested_430::size);
+
+// a struct of scalars stays tight in std430 but is rounded to a vec4 in std140
+using pair = block<float, float>;
+using pairs_140 = vk::std140_block<float, pair, float>;
+using pairs_430 = vk::std430_block<float, pair, float>;
+static_assert(16 == pairs_140::offset<1> && 32 == pairs_140::offset<2> && 48 == pairs_140::size);
+static_assert(4 == pairs_430::offset<1> && 12 == pairs_430::offset<2> && 16 == pairs_430::size);
+
+// an array of nested structs takes the struct size as its stride
+static_assert(32 == vk::detail::field_layout<vk::layout_rule_t::std140, array<light, 3>>::stride);
+static_assert(8 == vk::detail::field_layout<vk::layout_rule_t::std430, array<pair, 3>>::stride);
+
+template <typename T>
+T read_at(std::vector<std::byte> const& bytes, uint32_t offset)
+{
+    T value;
+    std::memcpy(&value, bytes.data() + offset, sizeof(T));
+    return value;
+}
+
+// values land at their offsets and the padding is left untouched
+void test_write_nested()
+{
+    std::vector<std::byte> bytes(nested_140::size, std::byte{ 0xcd });
+    nested_140::write(bytes.data(), 1.0f, { vec3{ { 2.0f, 3.0f, 4.0f } }, 5.0f, vec2{ { 6.0f, 7.0f } } }, 8.0f);
+
+    TEST_CHECK(1.0f == read_at<float>(bytes, 0));
+    TEST_CHECK(std::byte{ 0xcd } == bytes[4]);
+    TEST_CHECK(2.0f == read_at<float>(bytes, 16) && 4.0f == read_at<float>(bytes, 24));
+    TEST_CHECK(5.0f == read_at<float>(bytes, 28));
+    TEST_CHECK(6.0f == read_at<float>(bytes, 32) && 7.0f == read_at<float>(bytes, 36));
+    TEST_CHECK(std::byte{ 0xcd } == bytes[40]);
+    TEST_CHECK(8.0f == read_at<float>(bytes, 48));
+}
+
+void test_write_arrays()
+{
+    std::vector<std::byte> bytes(scalars_140::size, std::byte{ 0xcd });
+    scalars_140::write(bytes.data(), 1.0f, { 2.0f, 3.0f, 4.0f, 5.0f }, 6.0f);
+    for (uint32_t i = 0; i < 4; ++i)
+        TEST_CHECK(2.0f + i == read_at<float>(bytes, 16 + 16 * i));
+    TEST_CHECK(std::byte{ 0xcd } == bytes[20]);
+    TEST_CHECK(6.0f == read_at<float>(bytes, 80));
+
+    bytes.assign(mat3_430::size, std::byte{ 0xcd });
+    mat3_430::write_field<1>(bytes.data(), mat3{ { { 1.0f, 2.0f, 3.0f }, { 4.0f, 5.0f, 6.0f }, { 7.0f, 8.0f, 9.0f } } });
+    TEST_CHECK(1.0f == read_at<float>(bytes, 16) && 3.0f == read_at<float>(bytes, 24));
+    TEST_CHECK(4.0f == read_at<float>(bytes, 32) && 9.0f == read_at<float>(bytes, 56));
+    TEST_CHECK(std::byte{ 0xcd } == bytes[28]);
+}
+
+int main()
+{
+    test_write_nested();
+    test_write_arrays();
+    return test_failures();
+}
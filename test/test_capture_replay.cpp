@@ -0,0 +1,475 @@
+#include <vulkancpp.hpp>
+#include <sstream>
+#include "test_check.hpp"
+
+// every call that reaches a recording table, with the contents of the arrays it points to
+std::vector<std::string>* recorded_calls = nullptr;
+
+template <typename T>
+void format_argument(std::ostringstream& out, T const& value)
+{
+    if constexpr (std::is_pointer_v<T>)
+        out << reinterpret_cast<uintptr_t>(value);
+    else if constexpr (std::is_enum_v<T>)
+        out << static_cast<int64_t>(value);
+    else
+        out << value;
+}
+
+template <typename T>
+std::string format_array(T const* values, uint32_t count)
+{
+    std::ostringstream out;
+    out << std::hex << "[";
+    auto bytes = reinterpret_cast<uint8_t const*>(values);
+    for (size_t i = 0; i < sizeof(T) * count; ++i)
+        out << static_cast<uint32_t>(bytes[i]) << (i + 1 < sizeof(T) * count ? "," : "");
+    out << "]";
+    return out.str();
+}
+
+// field by field, the structure has padding after the layout
+std::string format_image_infos(VkDescriptorImageInfo const* infos, uint32_t count)
+{
+    std::ostringstream out;
+    for (uint32_t i = 0; i < count; ++i)
+        out << "(" << format_array(&infos[i].sampler, 1) << format_array(&infos[i].imageView, 1) << infos[i].imageLayout << ")";
+    return out.str();
+}
+
+// the barrier structures have padding after their sType
+std::string format_barriers(uint32_t memory_count, VkMemoryBarrier const* memory_barriers,
+    uint32_t buffer_count, VkBufferMemoryBarrier const* buffer_barriers,
+    uint32_t image_count, VkImageMemoryBarrier const* image_barriers)
+{
+    std::ostringstream out;
+    for (uint32_t i = 0; i < memory_count; ++i)
+        out << "(" << memory_barriers[i].srcAccessMask << "," << memory_barriers[i].dstAccessMask << ")";
+    for (uint32_t i = 0; i < buffer_count; ++i)
+    {
+        auto const& barrier = buffer_barriers[i];
+        out << "(" << barrier.srcAccessMask << "," << barrier.dstAccessMask << "," << barrier.srcQueueFamilyIndex << ","
+            << barrier.dstQueueFamilyIndex << "," << format_array(&barrier.buffer, 1) << barrier.offset << "," << barrier.size << ")";
+    }
+    for (uint32_t i = 0; i < image_count; ++i)
+    {
+        auto const& barrier = image_barriers[i];
+        out << "(" << barrier.srcAccessMask << "," << barrier.dstAccessMask << "," << barrier.oldLayout << "," << barrier.newLayout << ","
+            << barrier.srcQueueFamilyIndex << "," << barrier.dstQueueFamilyIndex << "," << format_array(&barrier.image, 1)
+            << format_array(&barrier.subresourceRange, 1) << ")";
+    }
+    return out.str();
+}
+
+#ifdef VK_KHR_dynamic_rendering
+std::string format_rendering_attachment(VkRenderingAttachmentInfoKHR const* attachment)
+{
+    if (nullptr == attachment)
+        return "-";
+
+    std::ostringstream out;
+    out << "(" << format_array(&attachment->imageView, 1) << attachment->imageLayout << "," << attachment->resolveMode << ","
+        << format_array(&attachment->resolveImageView, 1) << attachment->resolveImageLayout << "," << attachment->loadOp << ","
+        << attachment->storeOp << "," << format_array(&attachment->clearValue, 1) << ")";
+    return out.str();
+}
+#endif
+
+template <typename ... Args>
+void record_call(char const* name, Args const& ... args)
+{
+    std::ostringstream out;
+    out << name;
+    ((out << ' ', format_argument(out, args)), ...);
+    recorded_calls->push_back(out.str());
+}
+
+vk::command_table_t make_recording_table()
+{
+    vk::command_table_t table;
+    table.vkCmdBindPipeline = [](VkCommandBuffer, VkPipelineBindPoint bind_point, VkPipeline pipeline) {
+        record_call("bind_pipeline", bind_point, pipeline);
+    };
+    table.vkCmdBindDescriptorSets = [](VkCommandBuffer, VkPipelineBindPoint bind_point, VkPipelineLayout layout, uint32_t first_set,
+        uint32_t set_count, VkDescriptorSet const* sets, uint32_t offset_count, uint32_t const* offsets) {
+        record_call("bind_descriptor_sets", bind_point, layout, first_set, format_array(sets, set_count), format_array(offsets, offset_count));
+    };
+    table.vkCmdBindVertexBuffers = [](VkCommandBuffer, uint32_t first_binding, uint32_t count, VkBuffer const* buffers, VkDeviceSize const* offsets) {
+        record_call("bind_vertex_buffers", first_binding, format_array(buffers, count), format_array(offsets, count));
+    };
+    table.vkCmdBindIndexBuffer = [](VkCommandBuffer, VkBuffer buffer, VkDeviceSize offset, VkIndexType index_type) {
+        record_call("bind_index_buffer", buffer, offset, index_type);
+    };
+    table.vkCmdSetViewport = [](VkCommandBuffer, uint32_t first, uint32_t count, VkViewport const* viewports) {
+        record_call("set_viewport", first, format_array(viewports, count));
+    };
+    table.vkCmdSetScissor = [](VkCommandBuffer, uint32_t first, uint32_t count, VkRect2D const* scissors) {
+        record_call("set_scissor", first, format_array(scissors, count));
+    };
+    table.vkCmdPushConstants = [](VkCommandBuffer, VkPipelineLayout layout, VkShaderStageFlags stages, uint32_t offset, uint32_t size, void const* data) {
+        record_call("push_constants", layout, stages, offset, format_array(static_cast<uint8_t const*>(data), size));
+    };
+    table.vkCmdDraw = [](VkCommandBuffer, uint32_t vertex_count, uint32_t instance_count, uint32_t first_vertex, uint32_t first_instance) {
+        record_call("draw", vertex_count, instance_count, first_vertex, first_instance);
+    };
+    table.vkCmdDrawIndexed = [](VkCommandBuffer, uint32_t index_count, uint32_t instance_count, uint32_t first_index, int32_t vertex_offset, uint32_t first_instance) {
+        record_call("draw_indexed", index_count, instance_count, first_index, vertex_offset, first_instance);
+    };
+    table.vkCmdDrawIndexedIndirect = [](VkCommandBuffer, VkBuffer buffer, VkDeviceSize offset, uint32_t draw_count, uint32_t stride) {
+        record_call("draw_indexed_indirect", buffer, offset, draw_count, stride);
+    };
+    table.vkCmdDispatch = [](VkCommandBuffer, uint32_t x, uint32_t y, uint32_t z) {
+        record_call("dispatch", x, y, z);
+    };
+    table.vkCmdCopyBuffer = [](VkCommandBuffer, VkBuffer src, VkBuffer dst, uint32_t count, VkBufferCopy const* regions) {
+        record_call("copy_buffer", src, dst, format_array(regions, count));
+    };
+    table.vkCmdFillBuffer = [](VkCommandBuffer, VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size, uint32_t data) {
+        record_call("fill_buffer", buffer, offset, size, data);
+    };
+    table.vkCmdCopyImage = [](VkCommandBuffer, VkImage src, VkImageLayout src_layout, VkImage dst, VkImageLayout dst_layout,
+        uint32_t count, VkImageCopy const* regions) {
+        record_call("copy_image", src, src_layout, dst, dst_layout, format_array(regions, count));
+    };
+    table.vkCmdCopyBufferToImage = [](VkCommandBuffer, VkBuffer src, VkImage dst, VkImageLayout dst_layout, uint32_t count, VkBufferImageCopy const* regions) {
+        record_call("copy_buffer_to_image", src, dst, dst_layout, format_array(regions, count));
+    };
+    table.vkCmdCopyImageToBuffer = [](VkCommandBuffer, VkImage src, VkImageLayout src_layout, VkBuffer dst, uint32_t count, VkBufferImageCopy const* regions) {
+        record_call("copy_image_to_buffer", src, src_layout, dst, format_array(regions, count));
+    };
+    table.vkCmdBeginRenderPass = [](VkCommandBuffer, VkRenderPassBeginInfo const* begin_info, VkSubpassContents contents) {
+        record_call("begin_render_pass", begin_info->renderPass, begin_info->framebuffer, format_array(&begin_info->renderArea, 1),
+            format_array(begin_info->pClearValues, begin_info->clearValueCount), contents);
+    };
+    table.vkCmdEndRenderPass = [](VkCommandBuffer) {
+        record_call("end_render_pass");
+    };
+    table.vkCmdExecuteCommands = [](VkCommandBuffer, uint32_t count, VkCommandBuffer const* command_buffers) {
+        record_call("execute_commands", format_array(command_buffers, count));
+    };
+    table.vkCmdResetQueryPool = [](VkCommandBuffer, VkQueryPool pool, uint32_t first_query, uint32_t query_count) {
+        record_call("reset_query_pool", pool, first_query, query_count);
+    };
+    table.vkCmdWriteTimestamp = [](VkCommandBuffer, VkPipelineStageFlagBits stage, VkQueryPool pool, uint32_t query) {
+        record_call("write_timestamp", stage, pool, query);
+    };
+    table.vkCmdPipelineBarrier = [](VkCommandBuffer, VkPipelineStageFlags src_stages, VkPipelineStageFlags dst_stages,
+        VkDependencyFlags dependency_flags, uint32_t memory_count, VkMemoryBarrier const* memory_barriers,
+        uint32_t buffer_count, VkBufferMemoryBarrier const* buffer_barriers, uint32_t image_count, VkImageMemoryBarrier const* image_barriers) {
+        record_call("pipeline_barrier", src_stages, dst_stages, dependency_flags, memory_count, buffer_count, image_count,
+            format_barriers(memory_count, memory_barriers, buffer_count, buffer_barriers, image_count, image_barriers));
+    };
+    table.vkCmdPushDescriptorSetKHR = [](VkCommandBuffer, VkPipelineBindPoint bind_point, VkPipelineLayout layout, uint32_t set,
+        uint32_t count, VkWriteDescriptorSet const* writes) {
+        record_call("push_descriptor_set", bind_point, layout, set, count);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            auto const& write = writes[i];
+            record_call("  write", write.dstBinding, write.dstArrayElement, write.descriptorType,
+                nullptr == write.pImageInfo ? "-" : format_image_infos(write.pImageInfo, write.descriptorCount),
+                nullptr == write.pBufferInfo ? "-" : format_array(write.pBufferInfo, write.descriptorCount),
+                nullptr == write.pTexelBufferView ? "-" : format_array(write.pTexelBufferView, write.descriptorCount));
+        }
+    };
+    table.vkCmdDrawIndexedIndirectCountKHR = [](VkCommandBuffer, VkBuffer buffer, VkDeviceSize offset, VkBuffer count_buffer,
+        VkDeviceSize count_offset, uint32_t max_draw_count, uint32_t stride) {
+        record_call("draw_indexed_indirect_count", buffer, offset, count_buffer, count_offset, max_draw_count, stride);
+    };
+#ifdef VK_KHR_dynamic_rendering
+    table.vkCmdBeginRenderingKHR = [](VkCommandBuffer, VkRenderingInfoKHR const* info) {
+        std::string attachments;
+        for (uint32_t i = 0; i < info->colorAttachmentCount; ++i)
+            attachments += format_rendering_attachment(info->pColorAttachments + i);
+        record_call("begin_rendering", info->flags, format_array(&info->renderArea, 1), info->layerCount, info->viewMask, attachments,
+            format_rendering_attachment(info->pDepthAttachment), format_rendering_attachment(info->pStencilAttachment));
+    };
+    table.vkCmdEndRenderingKHR = [](VkCommandBuffer) {
+        record_call("end_rendering");
+    };
+#endif
+    return table;
+}
+
+struct recording_device_t
+{
+    vk::command_table_t                 table = make_recording_table();
+
+    vk::command_table_t const& get_command_table() const noexcept
+    {
+        return table;
+    }
+
+    // a barrier which skips the command table, the tests expect none
+    void pipeline_barrier(VkCommandBuffer, VkPipelineStageFlags, VkPipelineStageFlags,
+        uint32_t, VkMemoryBarrier const*, uint32_t, VkBufferMemoryBarrier const*, uint32_t, VkImageMemoryBarrier const*) const
+    {
+        record_call("device_pipeline_barrier");
+    }
+};
+
+// one of every command, recorded through the capture and the recorder the way an application would
+void record_frame(vk::command_table_t const& table)
+{
+    auto layout = make_test_handle<VkPipelineLayout>(0x100);
+    auto buffer = make_test_handle<VkBuffer>(0x400);
+    auto image = make_test_handle<VkImage>(0x600);
+    auto pool = make_test_handle<VkQueryPool>(0x700);
+    VkDescriptorSet const sets[] = { make_test_handle<VkDescriptorSet>(0x300), make_test_handle<VkDescriptorSet>(0x301) };
+    uint32_t const dynamic_offsets[] = { 256 };
+    VkBufferCopy const buffer_copy = { 0, 64, 128 };
+    VkImageCopy const image_copy = {};
+    VkBufferImageCopy const buffer_image_copy = { 16 };
+    VkClearValue clear_values[2] = {};
+    clear_values[1].color.float32[0] = 1.0f;
+    VkRenderPassBeginInfo const begin_info =
+    {
+        VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,                       // VkStructureType      sType
+        nullptr,                                                        // const void*          pNext
+        make_test_handle<VkRenderPass>(0x800),                          // VkRenderPass         renderPass
+        make_test_handle<VkFramebuffer>(0x900),                         // VkFramebuffer        framebuffer
+        { { 0, 0 }, { 640, 480 } },                                     // VkRect2D             renderArea
+        2,                                                              // uint32_t             clearValueCount
+        clear_values                                                    // const VkClearValue*  pClearValues
+    };
+    VkViewport const viewport = { 0.0f, 0.0f, 640.0f, 480.0f, 0.0f, 1.0f };
+    VkRect2D const scissor = { { 0, 0 }, { 640, 480 } };
+    VkDeviceSize const vertex_offset = 32;
+    VkCommandBuffer const secondary = make_test_handle<VkCommandBuffer>(0xa00);
+    uint32_t const constants[] = { 1, 2, 3 };
+    VkDescriptorImageInfo const image_infos[] =
+    {
+        { make_test_handle<VkSampler>(0xb00), make_test_handle<VkImageView>(0xb01), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL },
+        { make_test_handle<VkSampler>(0xb00), make_test_handle<VkImageView>(0xb02), VK_IMAGE_LAYOUT_GENERAL },
+    };
+    VkDescriptorBufferInfo const buffer_info = { buffer, 256, 64 };
+    VkBufferView const texel_buffer_view = make_test_handle<VkBufferView>(0xc00);
+    VkMemoryBarrier memory_barrier = { VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+    memory_barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    memory_barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    VkBufferMemoryBarrier buffer_barrier = { VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER };
+    buffer_barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    buffer_barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    buffer_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    buffer_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    buffer_barrier.buffer = buffer;
+    buffer_barrier.size = VK_WHOLE_SIZE;
+    VkImageMemoryBarrier image_barrier = { VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER };
+    image_barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    image_barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    image_barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+    image_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    image_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    image_barrier.image = image;
+    image_barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+    VkWriteDescriptorSet descriptor_writes[3] = {};
+    descriptor_writes[0] = { VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET, nullptr, nullptr, 0, 1, 2, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, image_infos };
+    descriptor_writes[1] = { VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET, nullptr, nullptr, 1, 0, 1, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, nullptr, &buffer_info };
+    descriptor_writes[2] = { VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET, nullptr, nullptr, 2, 0, 1, VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER, nullptr, nullptr, &texel_buffer_view };
+
+    VkCommandBuffer command_buffer = nullptr;
+    table.vkCmdResetQueryPool(command_buffer, pool, 0, 2);
+    table.vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, pool, 0);
+    table.vkCmdFillBuffer(command_buffer, buffer, 0, 256, 0xdeadbeef);
+    table.vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+        1, &memory_barrier, 1, &buffer_barrier, 1, &image_barrier);
+    table.vkCmdCopyBuffer(command_buffer, buffer, buffer, 1, &buffer_copy);
+    table.vkCmdCopyImage(command_buffer, image, VK_IMAGE_LAYOUT_GENERAL, image, VK_IMAGE_LAYOUT_GENERAL, 1, &image_copy);
+    table.vkCmdCopyBufferToImage(command_buffer, buffer, image, VK_IMAGE_LAYOUT_GENERAL, 1, &buffer_image_copy);
+    table.vkCmdCopyImageToBuffer(command_buffer, image, VK_IMAGE_LAYOUT_GENERAL, buffer, 1, &buffer_image_copy);
+    table.vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, make_test_handle<VkPipeline>(0x201));
+    table.vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, layout, 0, 2, sets, 1, dynamic_offsets);
+    table.vkCmdDispatch(command_buffer, 8, 4, 1);
+    table.vkCmdBeginRenderPass(command_buffer, &begin_info, VK_SUBPASS_CONTENTS_INLINE);
+    table.vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, make_test_handle<VkPipeline>(0x200));
+    table.vkCmdSetViewport(command_buffer, 0, 1, &viewport);
+    table.vkCmdSetScissor(command_buffer, 0, 1, &scissor);
+    table.vkCmdPushConstants(command_buffer, layout, VK_SHADER_STAGE_VERTEX_BIT, 4, sizeof(constants), constants);
+    table.vkCmdBindVertexBuffers(command_buffer, 0, 1, &buffer, &vertex_offset);
+    table.vkCmdBindIndexBuffer(command_buffer, buffer, 64, VK_INDEX_TYPE_UINT32);
+    table.vkCmdPushDescriptorSetKHR(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 1, 3, descriptor_writes);
+    table.vkCmdDraw(command_buffer, 3, 1, 0, 0);
+    table.vkCmdDrawIndexed(command_buffer, 36, 2, 6, -4, 1);
+    table.vkCmdDrawIndexedIndirect(command_buffer, buffer, 128, 4, sizeof(VkDrawIndexedIndirectCommand));
+    table.vkCmdDrawIndexedIndirectCountKHR(command_buffer, buffer, 256, buffer, 16, 64, sizeof(VkDrawIndexedIndirectCommand));
+    table.vkCmdEndRenderPass(command_buffer);
+    table.vkCmdExecuteCommands(command_buffer, 1, &secondary);
+}
+
+// the replayed calls are the captured ones, argument for argument
+void test_round_trip()
+{
+    recording_device_t device;
+    vk::command_capture_t capture{ device.get_command_table() };
+
+    std::vector<std::string> captured;
+    recorded_calls = &captured;
+    capture.begin();
+    record_frame(capture.get_command_table());
+    capture.end();
+    TEST_CHECK(28 == captured.size());
+    TEST_CHECK(25 == capture.get_command_count());
+
+    std::vector<std::string> replayed;
+    recorded_calls = &replayed;
+    auto commands = vk::replay_capture_unmapped(capture.get_stream(), device.get_command_table(), nullptr);
+    TEST_CHECK(commands == capture.get_command_count());
+    TEST_CHECK(captured == replayed);
+
+    // a stream written to disk replays the same
+    vk::save_capture("test_capture_replay.bin", capture.get_stream());
+    std::vector<std::string> loaded;
+    recorded_calls = &loaded;
+    vk::replay_capture_unmapped(vk::load_capture("test_capture_replay.bin"), device.get_command_table(), nullptr);
+    TEST_CHECK(captured == loaded);
+}
+
+// the map swaps the handles, anything it misses is an error rather than a dangling handle
+void test_handle_map()
+{
+    recording_device_t device;
+    vk::command_capture_t capture{ device.get_command_table() };
+    vk::command_recorder<recording_device_t> recorder{ device, nullptr };
+    recorder.set_command_table(capture.get_command_table());
+
+    std::vector<std::string> captured;
+    recorded_calls = &captured;
+    capture.begin();
+    recorder.bind_pipeline(VK_PIPELINE_BIND_POINT_GRAPHICS, make_test_handle<VkPipeline>(0x200));
+    recorder.bind_index_buffer(nullptr, 0, VK_INDEX_TYPE_UINT16);
+    capture.end();
+
+    vk::capture_handle_map_t handles;
+    std::vector<std::string> replayed;
+    recorded_calls = &replayed;
+    bool thrown = false;
+    try
+    {
+        vk::replay_capture(capture.get_stream(), device, nullptr, handles);
+    }
+    catch (std::runtime_error const&)
+    {
+        thrown = true;
+    }
+    TEST_CHECK(thrown);
+
+    replayed.clear();
+    vk::set_capture_handle(handles, make_test_handle<VkPipeline>(0x200), make_test_handle<VkPipeline>(0x2000));
+    TEST_CHECK(2 == vk::replay_capture(capture.get_stream(), device, nullptr, handles));
+    TEST_CHECK(2 == replayed.size());
+
+    std::vector<std::string> expected;
+    recorded_calls = &expected;
+    device.table.vkCmdBindPipeline(nullptr, VK_PIPELINE_BIND_POINT_GRAPHICS, make_test_handle<VkPipeline>(0x2000));
+    device.table.vkCmdBindIndexBuffer(nullptr, nullptr, 0, VK_INDEX_TYPE_UINT16);
+    TEST_CHECK(expected == replayed);
+}
+
+// a push replaces its set and may disturb the ones above, so they are bound again afterwards
+void test_push_descriptor_invalidation()
+{
+    recording_device_t device;
+    vk::command_recorder<recording_device_t> recorder{ device, nullptr };
+    auto layout = make_test_handle<VkPipelineLayout>(0x100);
+    VkDescriptorSet const sets[] = { make_test_handle<VkDescriptorSet>(0x300), make_test_handle<VkDescriptorSet>(0x301),
+        make_test_handle<VkDescriptorSet>(0x302) };
+    VkDescriptorBufferInfo const buffer_info = { make_test_handle<VkBuffer>(0x400), 0, 64 };
+    VkWriteDescriptorSet const write = { VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET, nullptr, nullptr, 0, 0, 1,
+        VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, nullptr, &buffer_info };
+
+    std::vector<std::string> recorded;
+    recorded_calls = &recorded;
+    recorder.bind_descriptor_sets(VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 0, 3, sets);
+    recorder.push_descriptor_set(VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 1, 1, &write);
+    recorded.clear();
+
+    // set 0 is below the push and stays shadowed, set 2 is above and is rebound
+    recorder.bind_descriptor_set(VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 0, sets[0]);
+    TEST_CHECK(recorded.empty());
+    recorder.bind_descriptor_set(VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 2, sets[2]);
+    TEST_CHECK(1 == recorded.size());
+}
+
+#ifdef VK_KHR_dynamic_rendering
+// dynamic rendering goes through the recorder's table, is captured and scopes the recorder like a render pass
+void test_rendering()
+{
+    recording_device_t device;
+    vk::command_capture_t capture{ device.get_command_table() };
+    vk::command_recorder<recording_device_t> recorder{ device, nullptr };
+    recorder.set_command_table(capture.get_command_table());
+
+    VkRenderingAttachmentInfoKHR color_attachments[2] = {};
+    color_attachments[0] = { VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR, nullptr, make_test_handle<VkImageView>(0xd00),
+        VK_IMAGE_LAYOUT_GENERAL, VK_RESOLVE_MODE_NONE_KHR, nullptr, VK_IMAGE_LAYOUT_UNDEFINED,
+        VK_ATTACHMENT_LOAD_OP_CLEAR, VK_ATTACHMENT_STORE_OP_STORE };
+    color_attachments[0].clearValue.color.float32[0] = 0.5f;
+    color_attachments[1] = color_attachments[0];
+    color_attachments[1].imageView = make_test_handle<VkImageView>(0xd01);
+    color_attachments[1].loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+    VkRenderingAttachmentInfoKHR depth_attachment = color_attachments[0];
+    depth_attachment.imageView = make_test_handle<VkImageView>(0xd02);
+    depth_attachment.clearValue.depthStencil = { 1.0f, 0 };
+
+    VkRenderingInfoKHR rendering_info = { VK_STRUCTURE_TYPE_RENDERING_INFO_KHR };
+    rendering_info.renderArea = { { 0, 0 }, { 640, 480 } };
+    rendering_info.layerCount = 1;
+    rendering_info.colorAttachmentCount = 2;
+    rendering_info.pColorAttachments = color_attachments;
+    rendering_info.pDepthAttachment = &depth_attachment;
+
+    std::vector<std::string> captured;
+    recorded_calls = &captured;
+    capture.begin();
+    recorder.begin_rendering(rendering_info);
+    TEST_CHECK(recorder.in_render_pass());
+    recorder.draw(3);
+    recorder.end_rendering();
+    TEST_CHECK(!recorder.in_render_pass());
+    capture.end();
+    TEST_CHECK(3 == captured.size());
+
+    std::vector<std::string> replayed;
+    recorded_calls = &replayed;
+    vk::replay_capture_unmapped(capture.get_stream(), device.get_command_table(), nullptr);
+    TEST_CHECK(captured == replayed);
+}
+#endif
+
+// the transitions of an attached state tracker are captured in front of the command that needs them
+void test_tracker_barriers()
+{
+    recording_device_t device;
+    vk::command_capture_t capture{ device.get_command_table() };
+    vk::state_tracker<recording_device_t> tracker{ device };
+    vk::command_recorder<recording_device_t> recorder{ device, make_test_handle<VkCommandBuffer>(0xd00), &tracker };
+    recorder.set_command_table(capture.get_command_table());
+
+    auto buffer = make_test_handle<VkBuffer>(0x400);
+    tracker.track_buffer(buffer, vk::access_t::transfer_write);
+
+    std::vector<std::string> captured;
+    recorded_calls = &captured;
+    capture.begin();
+    tracker.require_buffer(buffer, vk::access_t::compute_shader_read);
+    recorder.dispatch(1);
+    capture.end();
+    TEST_CHECK(2 == captured.size());
+    TEST_CHECK(0 == captured[0].rfind("pipeline_barrier ", 0) && 0 == captured[1].rfind("dispatch ", 0));
+
+    std::vector<std::string> replayed;
+    recorded_calls = &replayed;
+    vk::replay_capture_unmapped(capture.get_stream(), device.get_command_table(), nullptr);
+    TEST_CHECK(captured == replayed);
+}
+
+int main()
+{
+    test_round_trip();
+    test_handle_map();
+    test_push_descriptor_invalidation();
+    test_tracker_barriers();
+#ifdef VK_KHR_dynamic_rendering
+    test_rendering();
+#endif
+    return test_failures();
+}
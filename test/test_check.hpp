@@ -0,0 +1,30 @@
+#pragma once
+#include <cstdlib>
+#include <iostream>
+
+// a check which survives NDEBUG, the test programs exit with the number of failed checks
+inline int& test_failures()
+{
+    static int failures = 0;
+    return failures;
+}
+
+#define TEST_CHECK(expression) \
+    do \
+    { \
+        if (!(expression)) \
+        { \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #expression "\n"; \
+            ++test_failures(); \
+        } \
+    } while (false)
+
+// fake non-dispatchable handles, the tests never pass them to a driver
+template <typename Handle>
+Handle make_test_handle(uint64_t value)
+{
+    if constexpr (std::is_pointer_v<Handle>)
+        return reinterpret_cast<Handle>(static_cast<uintptr_t>(value));
+    else
+        return static_cast<Handle>(value);
+}
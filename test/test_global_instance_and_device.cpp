@@ -70,26 +70,17 @@ void init_vulkan(vk::window_t& window)
         vk::khr::swapchain_ext                                  // extensions...
     );
 
-    // 8. select present mode
+    // 8. select present mode and image count for the latency budget
+    auto swapchain_capabilities = instance.get_capabilities(physical_device, surface);
     {
         auto present_modes = instance.get_present_modes(physical_device, surface);
-        auto itr = ranges::find_if(present_modes, [](auto const& present_mode)
-        {
-            return present_mode == VK_FORMAT_B8G8R8A8_UNORM &&
-                present_mode == VK_PRESENT_MODE_IMMEDIATE_KHR;
-        });
-
-        if (itr != ranges::end(present_modes))
-        {
-            swapchain_config.present_mode = *itr;
-        }
+        vk::frame_pacing_config_t pacing_config{};
+        auto pacing_plan = vk::plan_frame_pacing(pacing_config, present_modes, swapchain_capabilities);
+        vk::apply_frame_pacing(pacing_plan, swapchain_config);
     }
 
     // 9. select swapchain image size
-    {
-        auto swapchain_capabilities = instance.get_capabilities(physical_device, surface);
-        swapchain_config.present_image_size = swapchain_capabilities.currentExtent;
-    }
+    swapchain_config.present_image_size = swapchain_capabilities.currentExtent;
 
     // 10. create swap chain
     auto swapchain = logical_device.create_swapchain(surface, swapchain_config);
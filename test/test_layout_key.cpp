@@ -0,0 +1,55 @@
+#include <vulkancpp.hpp>
+#include "test_check.hpp"
+
+VkDescriptorSetLayoutBinding make_binding(uint32_t binding, uint32_t count, VkSampler const* samplers = nullptr)
+{
+    return { binding, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, count, VK_SHADER_STAGE_FRAGMENT_BIT, samplers };
+}
+
+// identical layouts hit the cache, binding order does not matter
+void test_equal_layouts()
+{
+    VkSampler const samplers[] = { make_test_handle<VkSampler>(1), make_test_handle<VkSampler>(2) };
+    vk::detail::descriptor_set_layout_key_t lhs{ { make_binding(0, 1, samplers), make_binding(1, 1) }, 0 };
+    vk::detail::descriptor_set_layout_key_t rhs{ { make_binding(1, 1), make_binding(0, 1, samplers) }, 0 };
+    TEST_CHECK(lhs == rhs);
+    TEST_CHECK(vk::detail::descriptor_set_layout_key_hash{}(lhs) == vk::detail::descriptor_set_layout_key_hash{}(rhs));
+}
+
+// the same samplers owned by different bindings are different layouts
+void test_sampler_ownership()
+{
+    VkSampler const sampler = make_test_handle<VkSampler>(1);
+    vk::detail::descriptor_set_layout_key_t first{ { make_binding(0, 1, &sampler), make_binding(1, 1) }, 0 };
+    vk::detail::descriptor_set_layout_key_t second{ { make_binding(0, 1), make_binding(1, 1, &sampler) }, 0 };
+    TEST_CHECK(!(first == second));
+
+    vk::layout_cache_t cache;
+    uint64_t next_handle = 1;
+    auto create = [&next_handle](auto const&, auto) { return make_test_handle<VkDescriptorSetLayout>(next_handle++); };
+    auto first_layout = cache.get_descriptor_set_layout({ make_binding(0, 1, &sampler), make_binding(1, 1) }, 0, create);
+    auto second_layout = cache.get_descriptor_set_layout({ make_binding(0, 1), make_binding(1, 1, &sampler) }, 0, create);
+    auto repeated_layout = cache.get_descriptor_set_layout({ make_binding(1, 1), make_binding(0, 1, &sampler) }, 0, create);
+    TEST_CHECK(first_layout != second_layout);
+    TEST_CHECK(first_layout == repeated_layout);
+    TEST_CHECK(2 == cache.size());
+}
+
+// the samplers handed to the create call point back into the caller's bindings
+void test_resolved_samplers()
+{
+    VkSampler const samplers[] = { make_test_handle<VkSampler>(3), make_test_handle<VkSampler>(4) };
+    std::vector<VkDescriptorSetLayoutBinding> bindings = { make_binding(2, 2, samplers), make_binding(0, 1) };
+    vk::detail::descriptor_set_layout_key_t key{ bindings, 0 };
+    auto resolved = key.resolve_bindings(bindings);
+    TEST_CHECK(0 == resolved[0].binding && nullptr == resolved[0].pImmutableSamplers);
+    TEST_CHECK(2 == resolved[1].binding && samplers == resolved[1].pImmutableSamplers);
+}
+
+int main()
+{
+    test_equal_layouts();
+    test_sampler_ownership();
+    test_resolved_samplers();
+    return test_failures();
+}
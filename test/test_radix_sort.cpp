@@ -0,0 +1,69 @@
+#include <vulkancpp.hpp>
+#include "test_check.hpp"
+#include <random>
+
+// the values number the items in input order, so a stable sort keeps them ascending among equal keys
+std::vector<vk::sort_item_t> make_items(size_t count, uint64_t key_mask, uint32_t seed)
+{
+    std::mt19937_64 random{ seed };
+    std::vector<vk::sort_item_t> items(count);
+    for (size_t i = 0; i < count; ++i)
+        items[i] = { random() & key_mask, static_cast<uint32_t>(i) };
+    return items;
+}
+
+void check_sort(std::vector<vk::sort_item_t> items, vk::worker_pool_t* pool)
+{
+    auto expected = items;
+    std::stable_sort(expected.begin(), expected.end(), [](auto const& lhs, auto const& rhs) { return lhs.key < rhs.key; });
+
+    std::vector<vk::sort_item_t> scratch;
+    vk::parallel_radix_sort(items, scratch, pool);
+    TEST_CHECK(items.size() == expected.size());
+    TEST_CHECK(std::equal(items.cbegin(), items.cend(), expected.cbegin(), [](auto const& lhs, auto const& rhs)
+    {
+        return lhs.key == rhs.key && lhs.value == rhs.value;
+    }));
+}
+
+void test_sort(vk::worker_pool_t* pool)
+{
+    check_sort({}, pool);
+    check_sort(make_items(1, ~0ull, 1), pool);
+    check_sort(make_items(1000, ~0ull, 2), pool);
+    check_sort(make_items(100000, ~0ull, 3), pool);
+    // few distinct keys, lots of ties to keep in order
+    check_sort(make_items(100000, 0xf00000000000000full, 4), pool);
+    // keys which only differ in the low byte, the msd pass has nothing to split above it
+    check_sort(make_items(100000, 0xffull, 5), pool);
+    // draw keys, the pass byte is shared by every draw
+    check_sort(make_items(100000, 0x00ffffffffffffffull | (1ull << 56), 6), pool);
+    check_sort(std::vector<vk::sort_item_t>(10000, vk::sort_item_t{ 42, 0 }), pool);
+}
+
+// the same pool serves many sorts, as it does once per frame
+void test_pool_reuse()
+{
+    vk::worker_pool_t pool{ 4 };
+    TEST_CHECK(4 == pool.get_thread_count());
+    for (uint32_t frame = 0; frame < 50; ++frame)
+        check_sort(make_items(20000, ~0ull, 100 + frame), &pool);
+
+    std::atomic<uint32_t> calls{ 0 };
+    pool.run([&calls]() { ++calls; });
+    TEST_CHECK(4 == calls);
+}
+
+int main()
+{
+    test_sort(nullptr);
+
+    vk::worker_pool_t single{ 1 };
+    test_sort(&single);
+
+    vk::worker_pool_t pool;
+    test_sort(&pool);
+
+    test_pool_reuse();
+    return test_failures();
+}
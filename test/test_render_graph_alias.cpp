@@ -0,0 +1,116 @@
+#include <vulkancpp.hpp>
+#include "test_check.hpp"
+
+// just enough of a device for the graph to place and bind transient buffers, records the barriers
+struct alias_test_device_t
+{
+    struct barrier_t
+    {
+        VkPipelineStageFlags    src_stages;
+        VkPipelineStageFlags    dst_stages;
+    };
+
+    VkBuffer create_buffer_handle(VkBufferCreateInfo const& create_info) const
+    {
+        sizes.push_back(create_info.size);
+        return make_test_handle<VkBuffer>(sizes.size());
+    }
+
+    VkMemoryRequirements get_buffer_memory_requirements(VkBuffer buffer) const
+    {
+        return { sizes[reinterpret_cast<uintptr_t>(buffer) - 1], 256, 1 };
+    }
+
+    VkImage create_image_handle(VkImageCreateInfo const&) const { return nullptr; }
+    VkMemoryRequirements get_image_memory_requirements(VkImage) const { return {}; }
+    vk::object<VkImageView> create_image_view(VkImageViewCreateInfo const&) const { return {}; }
+    uint32_t find_memory_type(uint32_t, VkMemoryPropertyFlags) const { return 0; }
+    VkDeviceMemory allocate_memory_handle(VkDeviceSize, uint32_t) const { return make_test_handle<VkDeviceMemory>(1); }
+    void bind_buffer_memory(VkBuffer, VkDeviceMemory, VkDeviceSize) const {}
+    void bind_image_memory(VkImage, VkDeviceMemory, VkDeviceSize) const {}
+    void destroy_image_view(VkImageView) const {}
+    void destroy_image(VkImage) const {}
+    void destroy_buffer(VkBuffer) const {}
+    void free_memory(VkDeviceMemory) const {}
+
+    void pipeline_barrier(VkCommandBuffer, VkPipelineStageFlags src_stages, VkPipelineStageFlags dst_stages,
+        uint32_t, VkMemoryBarrier const*, uint32_t, VkBufferMemoryBarrier const*, uint32_t, VkImageMemoryBarrier const*) const
+    {
+        barriers.push_back({ src_stages, dst_stages });
+    }
+
+    mutable std::vector<VkDeviceSize>   sizes;
+    mutable std::vector<barrier_t>      barriers;
+};
+
+using graph_t = vk::render_graph<alias_test_device_t>;
+
+// a and b live side by side and end in different passes, c reuses the memory of both afterwards
+void test_all_occupants_hand_over()
+{
+    alias_test_device_t device;
+    graph_t graph{ device };
+    auto a = graph.create_buffer("a", { 256 });
+    auto b = graph.create_buffer("b", { 256 });
+    auto c = graph.create_buffer("c", { 512 });
+
+    auto noop = [](VkCommandBuffer, graph_t const&) {};
+    graph.add_pass("produce", [&](auto& builder)
+    {
+        builder.write(a, vk::access_t::compute_shader_write);
+        builder.write(b, vk::access_t::transfer_write);
+        builder.side_effect();
+    }, noop);
+    graph.add_pass("consume", [&](auto& builder)
+    {
+        builder.read(a, vk::access_t::compute_shader_read);
+        builder.side_effect();
+    }, noop);
+    graph.add_pass("reuse", [&](auto& builder)
+    {
+        builder.write(c, vk::access_t::compute_shader_write);
+        builder.side_effect();
+    }, noop);
+
+    graph.compile();
+    TEST_CHECK(512 == graph.get_statistics().transient_bytes);
+    TEST_CHECK(1024 == graph.get_statistics().unaliased_bytes);
+
+    graph.execute(nullptr);
+    TEST_CHECK(2 == device.barriers.size());
+    if (2 == device.barriers.size())
+    {
+        auto const& reuse = device.barriers.back();
+        TEST_CHECK(0 != (reuse.src_stages & VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT));
+        TEST_CHECK(0 != (reuse.src_stages & VK_PIPELINE_STAGE_TRANSFER_BIT));
+    }
+}
+
+// resources alive at the same time never share memory and never wait on each other
+void test_overlapping_lifetimes()
+{
+    alias_test_device_t device;
+    graph_t graph{ device };
+    auto a = graph.create_buffer("a", { 256 });
+    auto b = graph.create_buffer("b", { 256 });
+
+    graph.add_pass("both", [&](auto& builder)
+    {
+        builder.write(a, vk::access_t::transfer_write);
+        builder.write(b, vk::access_t::transfer_write);
+        builder.side_effect();
+    }, [](VkCommandBuffer, graph_t const&) {});
+
+    graph.compile();
+    TEST_CHECK(512 == graph.get_statistics().transient_bytes);
+
+    graph.execute(nullptr);
+    TEST_CHECK(device.barriers.empty());
+}
+
+int main()
+{
+    test_all_occupants_hand_over();
+    test_overlapping_lifetimes();
+    return test_failures();
+}